@@ -0,0 +1,96 @@
+//
+// Created by gnilk on 19.10.2026.
+//
+
+#ifndef GNILK_ARENA_H
+#define GNILK_ARENA_H
+
+#include <memory>
+#include <span>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+#include <string.h>
+
+namespace gnilk {
+
+    //
+    // Bump allocator for the parsed documents, strings and ranges are copied into large blocks and released all at
+    // once with the arena. Nothing moves once allocated.
+    //
+    class Arena {
+    public:
+        static constexpr size_t kBlockSize = 64 * 1024;
+    public:
+        Arena() = default;
+        virtual ~Arena() = default;
+
+        Arena(const Arena &) = delete;
+        Arena &operator=(const Arena &) = delete;
+
+        // Releases everything, one block is kept for reuse
+        void Clear() {
+            // the current block is always last, large blocks are inserted before it
+            std::unique_ptr<char[]> current;
+            if (blockCapacity > 0) {
+                current = std::move(blocks.back());
+            }
+            blocks.clear();
+            if (current != nullptr) {
+                blocks.push_back(std::move(current));
+            }
+            blockUsed = 0;
+            arenaSize = blockCapacity;
+        }
+
+        std::string_view StoreString(std::string_view str) {
+            if (str.empty()) {
+                return {};
+            }
+            auto ptr = static_cast<char *>(Allocate(str.size(), 1));
+            memcpy(ptr, str.data(), str.size());
+            return {ptr, str.size()};
+        }
+
+        template<typename T>
+        std::span<const T> StoreRange(std::span<const T> items) {
+            static_assert(std::is_trivially_copyable_v<T>);
+            if (items.empty()) {
+                return {};
+            }
+            auto ptr = static_cast<T *>(Allocate(items.size_bytes(), alignof(T)));
+            memcpy(static_cast<void *>(ptr), items.data(), items.size_bytes());
+            return {ptr, items.size()};
+        }
+
+        void *Allocate(size_t nBytes, size_t alignment) {
+            auto aligned = (blockUsed + alignment - 1) & ~(alignment - 1);
+            if ((blocks.empty()) || ((aligned + nBytes) > blockCapacity)) {
+                // large items get a block of their own, don't waste the remains of the current block on them
+                if (nBytes > kBlockSize / 4) {
+                    auto itBlock = blocks.emplace(blocks.empty() ? blocks.end() : blocks.end() - 1, std::make_unique<char[]>(nBytes));
+                    arenaSize += nBytes;
+                    return itBlock->get();
+                }
+                blocks.emplace_back(std::make_unique<char[]>(kBlockSize));
+                blockCapacity = kBlockSize;
+                arenaSize += kBlockSize;
+                aligned = 0;
+            }
+            blockUsed = aligned + nBytes;
+            return blocks.back().get() + aligned;
+        }
+
+        // Bytes held, including unused parts of blocks
+        size_t Size() const {
+            return arenaSize;
+        }
+    protected:
+        std::vector<std::unique_ptr<char[]>> blocks;
+        size_t blockUsed = 0;
+        size_t blockCapacity = 0;
+        size_t arenaSize = 0;
+    };
+}
+
+#endif //GNILK_ARENA_H
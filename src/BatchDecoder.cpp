@@ -0,0 +1,215 @@
+//
+// Created by gnilk on 19.10.2026.
+//
+
+#include <thread>
+#include <mutex>
+#include <algorithm>
+
+#include "BatchDecoder.h"
+#include "JSONDecoder.h"
+#include "XMLDecoder.h"
+#include "IniDecoder.h"
+#include "StringReader.h"
+
+using namespace gnilk;
+
+namespace {
+    // Range of item indexes owned by a worker, the owner takes from the front and thieves take the back half
+    struct WorkRange {
+        std::mutex lock;
+        size_t begin = 0;
+        size_t end = 0;
+    };
+
+    // Everything a worker reuses between documents, the parsers keep their document (and arena) between items
+    struct Worker {
+        WorkRange range;
+        std::string scratch;
+        ShapeCache::Ref shapeCache = ShapeCache::Create();
+        std::shared_ptr<StringReader> scratchReader;
+        std::unique_ptr<JSONParser> jsonParser;
+        std::unique_ptr<xml::XMLParser> xmlParser;
+    };
+
+    class BatchRunner {
+    public:
+        BatchRunner(std::span<const std::string_view> useDocuments, const UnmarshalFactory &useFactory, kDocumentFormat useFormat, BatchResult &useResult) :
+            documents(useDocuments),
+            factory(useFactory),
+            format(useFormat),
+            result(useResult) {
+        }
+
+        void Run(size_t nWorkers) {
+            workers = std::vector<Worker>(nWorkers);
+            auto nPerWorker = documents.size() / nWorkers;
+            for(size_t i=0;i<nWorkers;i++) {
+                workers[i].range.begin = i * nPerWorker;
+                workers[i].range.end = (i == nWorkers - 1) ? documents.size() : (i + 1) * nPerWorker;
+            }
+
+            std::vector<std::thread> threads;
+            for(size_t i=1;i<nWorkers;i++) {
+                threads.emplace_back([this, i]() { WorkerLoop(i); });
+            }
+            WorkerLoop(0);
+            for(auto &thread : threads) {
+                thread.join();
+            }
+        }
+    protected:
+        void WorkerLoop(size_t idxWorker) {
+            auto &worker = workers[idxWorker];
+            size_t idxItem;
+            while(TakeOwn(worker, idxItem) || Steal(idxWorker, idxItem)) {
+                // nothing may escape a worker thread, it would terminate the process
+                try {
+                    result.status[idxItem] = DecodeItem(worker, idxItem);
+                } catch(...) {
+                    result.objects[idxItem] = nullptr;
+                    result.status[idxItem] = kDecodeStatus::kException;
+                }
+            }
+        }
+
+        static bool TakeOwn(Worker &worker, size_t &outIdx) {
+            std::lock_guard<std::mutex> guard(worker.range.lock);
+            if (worker.range.begin == worker.range.end) {
+                return false;
+            }
+            outIdx = worker.range.begin++;
+            return true;
+        }
+
+        // Take the back half of the largest range left, the first item is processed right away the rest becomes ours
+        bool Steal(size_t idxWorker, size_t &outIdx) {
+            while(true) {
+                size_t idxVictim = idxWorker;
+                size_t nLargest = 0;
+                for(size_t i=0;i<workers.size();i++) {
+                    if (i == idxWorker) continue;
+                    std::lock_guard<std::mutex> guard(workers[i].range.lock);
+                    auto nLeft = workers[i].range.end - workers[i].range.begin;
+                    if (nLeft > nLargest) {
+                        nLargest = nLeft;
+                        idxVictim = i;
+                    }
+                }
+                if (nLargest == 0) {
+                    return false;
+                }
+
+                size_t stolenBegin, stolenEnd;
+                {
+                    auto &victim = workers[idxVictim].range;
+                    std::lock_guard<std::mutex> guard(victim.lock);
+                    auto nLeft = victim.end - victim.begin;
+                    // emptied while we were looking, try again
+                    if (nLeft == 0) {
+                        continue;
+                    }
+                    stolenEnd = victim.end;
+                    stolenBegin = victim.end - (nLeft + 1) / 2;
+                    victim.end = stolenBegin;
+                }
+                auto &own = workers[idxWorker].range;
+                std::lock_guard<std::mutex> guard(own.lock);
+                own.begin = stolenBegin + 1;
+                own.end = stolenEnd;
+                outIdx = stolenBegin;
+                return true;
+            }
+        }
+
+        kDecodeStatus DecodeItem(Worker &worker, size_t idxItem) {
+            auto object = factory(idxItem);
+            if (object == nullptr) {
+                return kDecodeStatus::kNoObject;
+            }
+
+            bool ok = false;
+            switch(format) {
+                case kDocumentFormat::kJSON : {
+                        // The JSON parser reads a stream, reuse the capacity of the worker buffer and its reader
+                        worker.scratch.assign(documents[idxItem]);
+                        if (worker.jsonParser == nullptr) {
+                            worker.scratchReader = std::make_shared<StringReader>(worker.scratch);
+                            worker.jsonParser = std::make_unique<JSONParser>(worker.scratchReader);
+                        }
+                        worker.scratchReader->Rewind();
+                        auto doc = worker.jsonParser->Reparse(worker.scratchReader);
+                        if (doc == nullptr) {
+                            return kDecodeStatus::kParseError;
+                        }
+                        JSONDecoder decoder(*doc);
+                        decoder.SetShapeCache(worker.shapeCache);
+                        ok = decoder.Unmarshal(object.get());
+                    }
+                    break;
+                case kDocumentFormat::kXML : {
+                        // parsed in place, no copy
+                        if (worker.xmlParser == nullptr) {
+                            worker.xmlParser = std::make_unique<xml::XMLParser>();
+                        }
+                        auto doc = worker.xmlParser->Reparse(documents[idxItem]);
+                        if (doc == nullptr) {
+                            return kDecodeStatus::kParseError;
+                        }
+                        XMLDecoder decoder(*doc);
+                        decoder.SetShapeCache(worker.shapeCache);
+                        ok = decoder.Unmarshal(object.get());
+                    }
+                    break;
+                case kDocumentFormat::kIni : {
+                        // INI sections are not arena allocated, there is nothing to reuse but the buffer.
+                        // Parsed up front like the others, so bad input is a parse error and not an unmarshal error
+                        worker.scratch.assign(documents[idxItem]);
+                        IniParser parser(worker.scratch);
+                        if (!parser.ProcessData()) {
+                            return kDecodeStatus::kParseError;
+                        }
+                        IniDecoder decoder(parser);
+                        decoder.SetShapeCache(worker.shapeCache);
+                        ok = decoder.Unmarshal(object.get());
+                    }
+                    break;
+            }
+            if (!ok) {
+                return kDecodeStatus::kUnmarshalError;
+            }
+            result.objects[idxItem] = std::move(object);
+            return kDecodeStatus::kOk;
+        }
+
+    protected:
+        std::span<const std::string_view> documents;
+        const UnmarshalFactory &factory;
+        kDocumentFormat format;
+        BatchResult &result;
+        std::vector<Worker> workers;
+    };
+}
+
+BatchResult gnilk::DecodeBatch(std::span<const std::string_view> documents, const UnmarshalFactory &factory, kDocumentFormat format, const BatchOptions &options) {
+    BatchResult result;
+    result.objects.resize(documents.size());
+    result.status.resize(documents.size(), kDecodeStatus::kOk);
+    if (documents.empty()) {
+        return result;
+    }
+
+    size_t nThreads = options.nThreads;
+    if (nThreads == 0) {
+        nThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    auto nWorkers = std::clamp<size_t>(documents.size() / std::max<size_t>(1, options.minItemsPerThread), 1, nThreads);
+
+    BatchRunner runner(documents, factory, format, result);
+    runner.Run(nWorkers);
+
+    result.nFailed = std::count_if(result.status.begin(), result.status.end(), [](kDecodeStatus status) {
+        return status != kDecodeStatus::kOk;
+    });
+    return result;
+}
@@ -0,0 +1,69 @@
+//
+// Created by gnilk on 19.10.2026.
+//
+// Decodes many small, independent documents (like a batch of queue messages) on a pool of threads.
+// Items are split in ranges over the workers, a worker running out of work steals half of the remaining range of
+// another worker - so a few large documents don't leave the other threads idle.
+// Each worker has its own parser and document (JSON/XML), they are reused for every item it decodes - the arena and
+// node storage of the previous item is recycled instead of allocating a new document per item.
+//
+//   auto result = DecodeBatch(documents, [](size_t idx) { return std::make_unique<MyMessage>(); }, kDocumentFormat::kJSON);
+//   for(size_t i=0;i<documents.size();i++) {
+//       if (result.status[i] != kDecodeStatus::kOk) continue;
+//       auto msg = static_cast<MyMessage *>(result.objects[i].get());
+//   }
+//
+// Note: The factory is called from the worker threads. An exception thrown while decoding an item (by the factory, the
+//       IUnmarshal callbacks or the parser) fails that item with kException, the rest of the batch continues.
+//
+
+#ifndef GNILK_BATCHDECODER_H
+#define GNILK_BATCHDECODER_H
+
+#include <vector>
+#include <memory>
+#include <span>
+#include <string_view>
+#include <functional>
+#include <stdint.h>
+#include <stddef.h>
+
+#include "IUnmarshal.h"
+
+namespace gnilk {
+
+    enum class kDocumentFormat : uint8_t {
+        kJSON,
+        kXML,
+        kIni,
+    };
+
+    enum class kDecodeStatus : uint8_t {
+        kOk,
+        kNoObject,          // factory returned nullptr
+        kParseError,
+        kUnmarshalError,
+        kException,         // decoding the item threw
+    };
+
+    // Creates the object item 'idx' is unmarshalled to - must be thread safe
+    using UnmarshalFactory = std::function<std::unique_ptr<IUnmarshal>(size_t idx)>;
+
+    struct BatchResult {
+        // One per document, in the same order as the documents
+        std::vector<std::unique_ptr<IUnmarshal>> objects;
+        std::vector<kDecodeStatus> status;
+        size_t nFailed = 0;
+    };
+
+    struct BatchOptions {
+        // 0 - use all hardware threads, the calling thread is always one of the workers
+        size_t nThreads = 0;
+        // Batches smaller than this are decoded on the calling thread only
+        size_t minItemsPerThread = 4;
+    };
+
+    BatchResult DecodeBatch(std::span<const std::string_view> documents, const UnmarshalFactory &factory, kDocumentFormat format, const BatchOptions &options = {});
+}
+
+#endif //GNILK_BATCHDECODER_H
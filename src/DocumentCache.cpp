@@ -0,0 +1,204 @@
+//
+// Created by gnilk on 19.10.2026.
+//
+
+#include <string.h>
+#include <random>
+
+#include "DocumentCache.h"
+
+using namespace gnilk;
+
+std::shared_ptr<const JSONDoc> DocumentCache::GetJSON(std::string_view data) {
+    auto doc = Get(data, kFormat::kJSON, [](const std::string &str) -> std::shared_ptr<const void> {
+        return std::shared_ptr<const JSONDoc>(JSONParser::Load(str));
+    });
+    return std::static_pointer_cast<const JSONDoc>(doc);
+}
+
+std::shared_ptr<const xml::Document> DocumentCache::GetXML(std::string_view data) {
+    auto doc = Get(data, kFormat::kXML, [](const std::string &str) -> std::shared_ptr<const void> {
+        return std::shared_ptr<const xml::Document>(xml::XMLParser::Load(str));
+    });
+    return std::static_pointer_cast<const xml::Document>(doc);
+}
+
+std::shared_ptr<const IniParser> DocumentCache::GetIni(std::string_view data) {
+    auto doc = Get(data, kFormat::kIni, [](const std::string &str) -> std::shared_ptr<const void> {
+        auto parser = IniParser::Create(str);
+        if (!parser->ProcessData()) {
+            return nullptr;
+        }
+        return std::shared_ptr<const IniParser>(parser);
+    });
+    return std::static_pointer_cast<const IniParser>(doc);
+}
+
+std::shared_ptr<const void> DocumentCache::Get(std::string_view data, kFormat format, const ParseFunc &parse) {
+    Key key = {HashData(data), data.size(), format};
+    // top bits for the shard, the map uses the rest
+    static_assert(kNumShards == 16);
+    auto &shard = shards[key.hash >> 60];
+    {
+        std::lock_guard<std::mutex> guard(shard.lock);
+        auto it = shard.index.find(key);
+        // same hash and length but other bytes is a collision, not a hit
+        if ((it != shard.index.end()) && (it->second->data == data)) {
+            shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+            shard.hits++;
+            return it->second->document;
+        }
+        shard.misses++;
+    }
+
+    // Parse without holding the lock, should someone else beat us to it we use theirs
+    std::string raw(data);
+    auto document = parse(raw);
+    if (document == nullptr) {
+        return nullptr;
+    }
+    auto maxShardBytes = options.maxBytes / kNumShards;
+    if (data.size() > maxShardBytes) {
+        return document;
+    }
+
+    std::lock_guard<std::mutex> guard(shard.lock);
+    auto it = shard.index.find(key);
+    if (it != shard.index.end()) {
+        if (it->second->data == data) {
+            return it->second->document;
+        }
+        // a colliding payload, the latest one takes the slot
+        shard.bytes -= it->second->key.length;
+        shard.lru.erase(it->second);
+        shard.index.erase(it);
+    }
+    shard.lru.push_front({key, std::move(raw), document});
+    shard.index[key] = shard.lru.begin();
+    shard.bytes += data.size();
+    EvictIfNeeded(shard);
+    return document;
+}
+
+// Lock must be held
+void DocumentCache::EvictIfNeeded(Shard &shard) {
+    auto maxShardBytes = options.maxBytes / kNumShards;
+    auto maxShardEntries = std::max<size_t>(1, options.maxEntries / kNumShards);
+    while((shard.bytes > maxShardBytes) || (shard.lru.size() > maxShardEntries)) {
+        auto &oldest = shard.lru.back();
+        shard.bytes -= oldest.key.length;
+        shard.index.erase(oldest.key);
+        shard.lru.pop_back();
+        shard.evictions++;
+    }
+}
+
+DocumentCache::Stats DocumentCache::GetStats() const {
+    Stats stats;
+    for(auto &shard : shards) {
+        std::lock_guard<std::mutex> guard(shard.lock);
+        stats.hits += shard.hits;
+        stats.misses += shard.misses;
+        stats.evictions += shard.evictions;
+        stats.entries += shard.lru.size();
+        stats.bytes += shard.bytes;
+    }
+    return stats;
+}
+
+void DocumentCache::Clear() {
+    for(auto &shard : shards) {
+        std::lock_guard<std::mutex> guard(shard.lock);
+        shard.lru.clear();
+        shard.index.clear();
+        shard.bytes = 0;
+    }
+}
+
+uint64_t DocumentCache::RandomSeed() {
+    std::random_device device;
+    return (static_cast<uint64_t>(device()) << 32) ^ device();
+}
+
+//
+// Content hash, follows the structure of wyhash (final version 4) - multiply and fold 128 bit products
+//
+// a, b = low and high half of a * b
+static inline void Mum(uint64_t &a, uint64_t &b) {
+#if defined(__SIZEOF_INT128__)
+    __uint128_t r = static_cast<__uint128_t>(a) * b;
+    a = static_cast<uint64_t>(r);
+    b = static_cast<uint64_t>(r >> 64);
+#else
+    uint64_t ha = a >> 32, hb = b >> 32, la = static_cast<uint32_t>(a), lb = static_cast<uint32_t>(b);
+    uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb, t = rl + (rm0 << 32);
+    uint64_t lo = t + (rm1 << 32);
+    uint64_t hi = rh + (rm0 >> 32) + (rm1 >> 32) + (t < rl) + (lo < t);
+    a = lo;
+    b = hi;
+#endif
+}
+
+// multiply and fold
+static inline uint64_t Mix(uint64_t a, uint64_t b) {
+    Mum(a, b);
+    return a ^ b;
+}
+
+static inline uint64_t Read64(const uint8_t *p) {
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+static inline uint64_t Read32(const uint8_t *p) {
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+static inline uint64_t Read3(const uint8_t *p, size_t len) {
+    return (static_cast<uint64_t>(p[0]) << 16) | (static_cast<uint64_t>(p[len >> 1]) << 8) | p[len - 1];
+}
+
+uint64_t DocumentCache::Hash(std::string_view data, uint64_t seed) {
+    static constexpr uint64_t kSecret[4] = {0x2d358dccaa6c78a5ull, 0x8bb84b93962eacc9ull, 0x4b33a62ed433d4a3ull, 0x4d5a2da51de1aa47ull};
+    auto p = reinterpret_cast<const uint8_t *>(data.data());
+    auto len = data.size();
+    uint64_t a, b;
+
+    seed ^= Mix(seed ^ kSecret[0], kSecret[1]);
+    if (len <= 16) {
+        if (len >= 4) {
+            a = (Read32(p) << 32) | Read32(p + ((len >> 3) << 2));
+            b = (Read32(p + len - 4) << 32) | Read32(p + len - 4 - ((len >> 3) << 2));
+        } else if (len > 0) {
+            a = Read3(p, len);
+            b = 0;
+        } else {
+            a = b = 0;
+        }
+    } else {
+        auto i = len;
+        if (i > 48) {
+            auto see1 = seed, see2 = seed;
+            do {
+                seed = Mix(Read64(p) ^ kSecret[1], Read64(p + 8) ^ seed);
+                see1 = Mix(Read64(p + 16) ^ kSecret[2], Read64(p + 24) ^ see1);
+                see2 = Mix(Read64(p + 32) ^ kSecret[3], Read64(p + 40) ^ see2);
+                p += 48;
+                i -= 48;
+            } while(i > 48);
+            seed ^= see1 ^ see2;
+        }
+        while(i > 16) {
+            seed = Mix(Read64(p) ^ kSecret[1], Read64(p + 8) ^ seed);
+            i -= 16;
+            p += 16;
+        }
+        a = Read64(p + i - 16);
+        b = Read64(p + i - 8);
+    }
+    a ^= kSecret[1];
+    b ^= seed;
+    Mum(a, b);
+    return Mix(a ^ kSecret[0] ^ len, b ^ kSecret[1]);
+}
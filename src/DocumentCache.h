@@ -0,0 +1,125 @@
+//
+// Created by gnilk on 19.10.2026.
+//
+// Cache of parsed documents keyed by the content (hash) of the raw data. The same payload parsed twice gives the same
+// shared, immutable document - read it with one decoder per thread, like:
+//   auto doc = cache.GetJSON(payload);
+//   JSONDecoder decoder(*doc);
+//
+// The cache is split in shards, each with its own lock, LRU list and part of the byte budget. The budget counts the
+// size of the raw data. Documents failing to parse are not cached.
+//
+// Entries keep a copy of the raw data, a hit is only a hit if the bytes are equal - colliding hashes can't return the
+// document of another payload. The hash is seeded randomly per cache.
+//
+
+#ifndef GNILK_DOCUMENTCACHE_H
+#define GNILK_DOCUMENTCACHE_H
+
+#include <memory>
+#include <mutex>
+#include <list>
+#include <array>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <stdint.h>
+#include <stddef.h>
+
+#include "JSONParser.h"
+#include "XMLParser.h"
+#include "IniParser.h"
+
+namespace gnilk {
+
+    class DocumentCache {
+    public:
+        using Ref = std::shared_ptr<DocumentCache>;
+        static constexpr size_t kNumShards = 16;
+
+        struct Options {
+            size_t maxBytes = 64 * 1024 * 1024;
+            size_t maxEntries = 4096;
+        };
+
+        struct Stats {
+            uint64_t hits = 0;
+            uint64_t misses = 0;
+            uint64_t evictions = 0;
+            size_t entries = 0;
+            size_t bytes = 0;
+        };
+    public:
+        DocumentCache() = default;
+        explicit DocumentCache(const Options &useOptions) : options(useOptions) {}
+        virtual ~DocumentCache() = default;
+
+        static Ref Create() {
+            return std::make_shared<DocumentCache>();
+        }
+        static Ref Create(const Options &options) {
+            return std::make_shared<DocumentCache>(options);
+        }
+
+        // Returns nullptr if the data doesn't parse
+        std::shared_ptr<const JSONDoc> GetJSON(std::string_view data);
+        std::shared_ptr<const xml::Document> GetXML(std::string_view data);
+        std::shared_ptr<const IniParser> GetIni(std::string_view data);
+
+        Stats GetStats() const;
+        void Clear();
+
+        // The content hash used for the keys (wyhash style, 64 bit)
+        static uint64_t Hash(std::string_view data, uint64_t seed = 0);
+        static uint64_t RandomSeed();
+
+    protected:
+        enum class kFormat : uint8_t {
+            kJSON,
+            kXML,
+            kIni,
+        };
+        struct Key {
+            uint64_t hash;
+            size_t length;
+            kFormat format;
+            bool operator==(const Key &other) const = default;
+        };
+        struct KeyHash {
+            size_t operator()(const Key &key) const {
+                return static_cast<size_t>(key.hash ^ static_cast<uint64_t>(key.format));
+            }
+        };
+        struct Entry {
+            Key key;
+            // compared on every hit
+            std::string data;
+            std::shared_ptr<const void> document;
+        };
+        struct Shard {
+            mutable std::mutex lock;
+            // most recently used first
+            std::list<Entry> lru;
+            std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> index;
+            size_t bytes = 0;
+            uint64_t hits = 0;
+            uint64_t misses = 0;
+            uint64_t evictions = 0;
+        };
+
+        using ParseFunc = std::function<std::shared_ptr<const void>(const std::string &data)>;
+        std::shared_ptr<const void> Get(std::string_view data, kFormat format, const ParseFunc &parse);
+        void EvictIfNeeded(Shard &shard);
+        virtual uint64_t HashData(std::string_view data) const {
+            return Hash(data, seed);
+        }
+
+    protected:
+        Options options = {};
+        uint64_t seed = RandomSeed();
+        std::array<Shard, kNumShards> shards;
+    };
+}
+
+#endif //GNILK_DOCUMENTCACHE_H
@@ -0,0 +1,32 @@
+//
+// Created by gnilk on 19.10.2026.
+//
+
+#ifndef GNILK_ENCODERHELPERS_H
+#define GNILK_ENCODERHELPERS_H
+
+#include <charconv>
+#include <string>
+#include <stdint.h>
+
+namespace gnilk {
+    // Appends the text representation of 'value' to 'out' without any temporary strings.
+    // Floating point values are formatted like std::to_string (i.e. '%f') to match the regular Write<T>Field functions.
+    template<typename T>
+    static void append_to(std::string &out, T value) {
+        // large enough for any double in fixed notation
+        char buffer[512];
+        std::to_chars_result res;
+        if constexpr (std::is_floating_point_v<T>) {
+            res = std::to_chars(buffer, buffer + sizeof(buffer), value, std::chars_format::fixed, 6);
+        } else {
+            res = std::to_chars(buffer, buffer + sizeof(buffer), value);
+        }
+        if (res.ec != std::errc{}) {
+            return;
+        }
+        out.append(buffer, res.ptr - buffer);
+    }
+}
+
+#endif //GNILK_ENCODERHELPERS_H
@@ -0,0 +1,373 @@
+//
+// Created by gnilk on 19.10.2026.
+//
+// Compile time field descriptors, describe your data class once and get both encoding and decoding (unmarshalling)
+// without writing SerializeTo/SetField boilerplate.
+//
+// Example:
+//   struct Point {
+//       int x = 0;
+//       int y = 0;
+//       std::string label;
+//   };
+//   GNILK_DESCRIBE(Point, GNILK_FIELD(x), GNILK_FIELD(y), GNILK_FIELD_NAMED("name", label));
+//
+//   // Encoding
+//   JSONEncoder encoder(writer);
+//   EncodeDescribed(encoder, "", point);
+//
+//   // Decoding - works with any decoder supporting IUnmarshal
+//   JSONDecoder decoder(data);
+//   DescribedUnmarshal<Point> unmarshal(point);
+//   decoder.Unmarshal(&unmarshal);
+//
+// Supported member types: bool, integers (except unsigned 64 bit), floating point, std::string, other described types and std::vector of those.
+// Incoming field names are resolved through a compile time perfect hash (one hash + one compare) instead of a chain
+// of string compares. Keys for encoding are created once per type. DescribedUnmarshal implements the typed callbacks
+// so values the decoder already converted are assigned directly.
+//
+
+#ifndef GNILK_FIELDDESCRIPTORS_H
+#define GNILK_FIELDDESCRIPTORS_H
+
+#include <tuple>
+#include <array>
+#include <vector>
+#include <string>
+#include <string_view>
+#include <memory>
+#include <utility>
+#include <type_traits>
+#include <charconv>
+#include <limits>
+
+#include "IEncoder.h"
+#include "IUnmarshal.h"
+#include "DecoderHelpers.h"
+#include "PerfectHash.h"
+
+namespace gnilk {
+
+    template<typename T, typename M>
+    struct FieldDescriptor {
+        using ClassType = T;
+        using MemberType = M;
+
+        std::string_view name;
+        M T::*member;
+    };
+
+    template<typename T, typename M>
+    constexpr FieldDescriptor<T, M> Field(std::string_view name, M T::*member) {
+        return {name, member};
+    }
+
+    // Specialize this (or use GNILK_DESCRIBE) and declare 'static constexpr auto fields = std::make_tuple(Field(...), ...)'
+    template<typename T>
+    struct FieldDescriptors {};
+
+    template<typename T>
+    concept Described = requires { FieldDescriptors<T>::fields; };
+
+    namespace detail {
+        template<typename T>
+        struct is_vector : std::false_type {};
+        template<typename E, typename A>
+        struct is_vector<std::vector<E, A>> : std::true_type {};
+
+        template<typename T>
+        static constexpr bool is_scalar_v = std::is_same_v<T, bool> || std::is_arithmetic_v<T> || std::is_same_v<T, std::string>;
+
+        template<typename T>
+        static constexpr size_t num_fields_v = std::tuple_size_v<std::remove_cvref_t<decltype(FieldDescriptors<T>::fields)>>;
+
+        template<typename T>
+        consteval std::array<std::string_view, num_fields_v<T>> field_names() {
+            return std::apply([](const auto &...field) {
+                return std::array<std::string_view, sizeof...(field)>{ field.name... };
+            }, FieldDescriptors<T>::fields);
+        }
+
+        // Per type data, created once
+        template<typename T>
+        struct DescribedType {
+            static constexpr size_t numFields = num_fields_v<T>;
+            static constexpr PerfectHash<numFields> lookup = PerfectHash<numFields>(field_names<T>());
+
+            // Keys as used by the encoders, created once - not per call..
+            static const std::array<std::string, numFields> &Keys() {
+                static const std::array<std::string, numFields> keys = [] {
+                    std::array<std::string, numFields> res;
+                    for(size_t i=0;i<numFields;i++) {
+                        res[i] = std::string(lookup.KeyAt(i));
+                    }
+                    return res;
+                }();
+                return keys;
+            }
+        };
+
+        template<typename M>
+        static bool assign_from_string(M &dst, std::string_view value) {
+            if constexpr (is_scalar_v<M>) {
+                auto res = convert_to<M>(value);
+                if (!res.has_value()) {
+                    return false;
+                }
+                dst = std::move(*res);
+                return true;
+            } else if constexpr (is_vector<M>::value) {
+                // repeated values (JSON arrays, INI multi-value keys, repeated XML elements) are appended
+                using E = typename M::value_type;
+                if constexpr (is_scalar_v<E>) {
+                    auto res = convert_to<E>(value);
+                    if (!res.has_value()) {
+                        return false;
+                    }
+                    dst.push_back(std::move(*res));
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        // Typed value as text, like the decoders would have passed it to 'SetField'
+        template<typename V>
+        static std::string format_value(V value) {
+            if constexpr (std::is_same_v<V, bool>) {
+                return value ? "true" : "false";
+            } else {
+                char buffer[32];
+                auto res = std::to_chars(buffer, buffer + sizeof(buffer), value);
+                return std::string(buffer, res.ptr);
+            }
+        }
+
+        // Typed values (see IUnmarshalTyped), only assigned if they make sense for the member type.
+        // Strings get the value as text, integers out of range for the member are rejected.
+        template<typename M, typename V>
+        static bool assign_from_value(M &dst, V value) {
+            if constexpr (std::is_same_v<M, bool>) {
+                if constexpr (std::is_same_v<V, bool>) {
+                    dst = value;
+                    return true;
+                }
+            } else if constexpr (std::is_integral_v<M>) {
+                if constexpr (std::is_integral_v<V> && !std::is_same_v<V, bool>) {
+                    if (!std::in_range<M>(value)) {
+                        return false;
+                    }
+                    dst = static_cast<M>(value);
+                    return true;
+                }
+            } else if constexpr (std::is_floating_point_v<M>) {
+                if constexpr (!std::is_same_v<V, bool>) {
+                    dst = static_cast<M>(value);
+                    return true;
+                }
+            } else if constexpr (std::is_same_v<M, std::string>) {
+                return assign_from_string(dst, format_value(value));
+            } else if constexpr (is_vector<M>::value) {
+                using E = typename M::value_type;
+                if constexpr (std::is_arithmetic_v<E>) {
+                    E item = {};
+                    if (!assign_from_value(item, value)) {
+                        return false;
+                    }
+                    dst.push_back(item);
+                    return true;
+                } else if constexpr (std::is_same_v<E, std::string>) {
+                    return assign_from_string(dst, format_value(value));
+                }
+            }
+            return false;
+        }
+    }
+
+    template<Described T>
+    void EncodeDescribed(IEncoder &encoder, const std::string &name, const T &obj);
+
+    namespace detail {
+        template<typename M>
+        static void encode_value(IEncoder &encoder, const std::string &key, const M &value) {
+            if constexpr (std::is_same_v<M, bool>) {
+                encoder.WriteBoolField(key, value);
+            } else if constexpr (std::is_integral_v<M>) {
+                if constexpr (std::numeric_limits<M>::max() <= std::numeric_limits<int>::max()) {
+                    encoder.WriteIntField(key, static_cast<int>(value));
+                } else {
+                    // the encoders have no unsigned 64 bit writer, values above INT64_MAX would wrap
+                    static_assert(std::numeric_limits<M>::max() <= std::numeric_limits<int64_t>::max(), "EncodeDescribed: unsigned 64 bit members are not supported");
+                    encoder.WriteInt64Field(key, static_cast<int64_t>(value));
+                }
+            } else if constexpr (std::is_floating_point_v<M>) {
+                encoder.WriteFloatField(key, value);
+            } else if constexpr (std::is_same_v<M, std::string>) {
+                encoder.WriteTextField(key, value);
+            } else if constexpr (Described<M>) {
+                EncodeDescribed(encoder, key, value);
+            } else if constexpr (std::is_same_v<M, std::vector<int64_t>>) {
+                encoder.WriteIntArray(key, value);
+            } else if constexpr (std::is_same_v<M, std::vector<double>>) {
+                encoder.WriteDoubleArray(key, value);
+            } else if constexpr (is_vector<M>::value) {
+                encoder.BeginArray(key);
+                static const std::string noName = {};
+                for(auto &item : value) {
+                    encode_value(encoder, noName, item);
+                }
+                encoder.EndArray();
+            } else {
+                static_assert(!sizeof(M *), "EncodeDescribed: unsupported member type");
+            }
+        }
+    }
+
+    // Encode a described object as 'name' (use an empty name for a JSON root object)
+    template<Described T>
+    void EncodeDescribed(IEncoder &encoder, const std::string &name, const T &obj) {
+        using Type = detail::DescribedType<T>;
+        auto &keys = Type::Keys();
+
+        encoder.BeginObject(name);
+        [&]<size_t... I>(std::index_sequence<I...>) {
+            (detail::encode_value(encoder, keys[I], obj.*(std::get<I>(FieldDescriptors<T>::fields).member)), ...);
+        }(std::make_index_sequence<Type::numFields>{});
+        encoder.EndObject();
+    }
+
+    //
+    // IUnmarshal adapter for a described object, the adapter must outlive the decoding
+    //
+    template<Described T>
+    class DescribedUnmarshal : public IUnmarshalTyped, public IUnmarshalSlots {
+    public:
+        using Type = detail::DescribedType<T>;
+    public:
+        explicit DescribedUnmarshal(T &useObject) : object(useObject) {}
+        virtual ~DescribedUnmarshal() = default;
+
+        bool SetField(const std::string &fieldName, const std::string &fieldValue) override {
+            return SetString(fieldName, fieldValue);
+        }
+
+        bool SetString(std::string_view fieldName, std::string_view value) override {
+            return Set(fieldName, value);
+        }
+        bool SetInt(std::string_view fieldName, int64_t value) override {
+            return Set(fieldName, value);
+        }
+        bool SetDouble(std::string_view fieldName, double value) override {
+            return Set(fieldName, value);
+        }
+        bool SetBool(std::string_view fieldName, bool value) override {
+            return Set(fieldName, value);
+        }
+        // Null leaves the member untouched
+        bool SetNull(std::string_view fieldName) override {
+            return Type::lookup.Find(fieldName) >= 0;
+        }
+
+        // Slots are the field index
+        int ResolveSlot(std::string_view fieldName) override {
+            return Type::lookup.Find(fieldName);
+        }
+        bool SetSlot(int slot, const UnmarshalValue &value) override {
+            if ((slot < 0) || (slot >= static_cast<int>(Type::numFields))) {
+                return false;
+            }
+            switch(value.type) {
+                case UnmarshalValue::kType::kInt :
+                    return setters<int64_t>[slot](object, value.intValue);
+                case UnmarshalValue::kType::kDouble :
+                    return setters<double>[slot](object, value.doubleValue);
+                case UnmarshalValue::kType::kBool :
+                    return setters<bool>[slot](object, value.boolValue);
+                case UnmarshalValue::kType::kNull :
+                    return true;
+                case UnmarshalValue::kType::kString :
+                default:
+                    return setters<std::string_view>[slot](object, value.str);
+            }
+        }
+
+        IUnmarshal *GetUnmarshalForField(const std::string &fieldName) override {
+            auto idx = Type::lookup.Find(fieldName);
+            if (idx < 0) {
+                return nullptr;
+            }
+            // A previous child for this field is done by now, so we just replace it
+            children[idx] = childFactories[idx](object);
+            return children[idx].get();
+        }
+
+        // Items are appended to the vector when the decoder asks for them (see GetUnmarshalForField)
+        bool PushToArray(const std::string &arrayName, IUnmarshal *pData) override {
+            return Type::lookup.Find(arrayName) >= 0;
+        }
+
+    protected:
+        template<typename V>
+        using SetterFunc = bool (*)(T &obj, V value);
+        using ChildFactoryFunc = std::unique_ptr<IUnmarshal> (*)(T &obj);
+
+        template<typename V>
+        bool Set(std::string_view fieldName, V value) {
+            auto idx = Type::lookup.Find(fieldName);
+            if (idx < 0) {
+                return false;
+            }
+            return setters<V>[idx](object, value);
+        }
+
+        template<size_t I, typename V>
+        static bool SetMember(T &obj, V value) {
+            auto &member = obj.*(std::get<I>(FieldDescriptors<T>::fields).member);
+            if constexpr (std::is_same_v<V, std::string_view>) {
+                return detail::assign_from_string(member, value);
+            } else {
+                return detail::assign_from_value(member, value);
+            }
+        }
+
+        template<size_t I>
+        static std::unique_ptr<IUnmarshal> CreateChild(T &obj) {
+            auto &member = obj.*(std::get<I>(FieldDescriptors<T>::fields).member);
+            using M = std::remove_cvref_t<decltype(member)>;
+            if constexpr (Described<M>) {
+                return std::make_unique<DescribedUnmarshal<M>>(member);
+            } else if constexpr (detail::is_vector<M>::value) {
+                if constexpr (Described<typename M::value_type>) {
+                    return std::make_unique<DescribedUnmarshal<typename M::value_type>>(member.emplace_back());
+                }
+            }
+            return nullptr;
+        }
+
+        // One table per value type, indexed by the field index
+        template<typename V>
+        static constexpr std::array<SetterFunc<V>, Type::numFields> setters = []<size_t... I>(std::index_sequence<I...>) {
+            return std::array<SetterFunc<V>, Type::numFields>{ &SetMember<I, V>... };
+        }(std::make_index_sequence<Type::numFields>{});
+
+        static constexpr std::array<ChildFactoryFunc, Type::numFields> childFactories = []<size_t... I>(std::index_sequence<I...>) {
+            return std::array<ChildFactoryFunc, Type::numFields>{ &CreateChild<I>... };
+        }(std::make_index_sequence<Type::numFields>{});
+
+    protected:
+        T &object;
+        std::array<std::unique_ptr<IUnmarshal>, Type::numFields> children = {};
+    };
+}
+
+// Declare the fields of 'Type', use at global scope with GNILK_FIELD/GNILK_FIELD_NAMED for each field
+#define GNILK_DESCRIBE(Type, ...) \
+    template<> struct gnilk::FieldDescriptors<Type> { \
+        using Self = Type; \
+        static constexpr auto fields = std::make_tuple(__VA_ARGS__); \
+    }
+
+#define GNILK_FIELD(member) gnilk::Field(#member, &Self::member)
+#define GNILK_FIELD_NAMED(name, member) gnilk::Field(name, &Self::member)
+
+#endif //GNILK_FIELDDESCRIPTORS_H
@@ -0,0 +1,70 @@
+//
+// Created by gnilk on 19.10.2026.
+//
+// Non blocking byte sources for coroutine based decoding, see BaseDecoder::UnmarshalAsync.
+// Anything with a 'ReadAsync(out, maxbytes)' returning an awaiter which yields the number of bytes read works, with the
+// same meaning as IReader::Read (0 - end of stream, negative - error).
+//
+
+#ifndef GNILK_IASYNCREADER_H
+#define GNILK_IASYNCREADER_H
+
+#include <concepts>
+#include <coroutine>
+#include <optional>
+#include <string>
+#include <stdint.h>
+#include <stddef.h>
+
+#include "IReader.h"
+#include "Task.h"
+
+namespace gnilk {
+
+    template<typename T>
+    concept AsyncReader = requires(T &reader, void *out, size_t maxbytes) {
+        { reader.ReadAsync(out, maxbytes).await_ready() } -> std::convertible_to<bool>;
+        { reader.ReadAsync(out, maxbytes).await_resume() } -> std::convertible_to<int32_t>;
+    };
+
+    // Wraps a regular (blocking) reader, reads complete right away
+    class SyncAsyncReader {
+    public:
+        struct ReadAwaiter {
+            int32_t nRead;
+            bool await_ready() const noexcept { return true; }
+            void await_suspend(std::coroutine_handle<>) const noexcept {}
+            int32_t await_resume() const noexcept { return nRead; }
+        };
+    public:
+        explicit SyncAsyncReader(IReader::Ref useReader) : reader(std::move(useReader)) {}
+
+        ReadAwaiter ReadAsync(void *out, size_t maxbytes) {
+            return {reader->Read(out, maxbytes)};
+        }
+    private:
+        IReader::Ref reader;
+    };
+
+    // Reads until end of stream, returns nothing on read errors
+    template<AsyncReader R>
+    Task<std::optional<std::string>> ReadAllAsync(R &reader, size_t chunkSize = 16384) {
+        std::string data;
+        size_t nUsed = 0;
+        while(true) {
+            data.resize(nUsed + chunkSize);
+            auto nRead = co_await reader.ReadAsync(data.data() + nUsed, chunkSize);
+            if (nRead < 0) {
+                co_return std::nullopt;
+            }
+            if (nRead == 0) {
+                break;
+            }
+            nUsed += static_cast<size_t>(nRead);
+        }
+        data.resize(nUsed);
+        co_return std::move(data);
+    }
+}
+
+#endif //GNILK_IASYNCREADER_H
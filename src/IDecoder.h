@@ -9,7 +9,12 @@
 #include <memory>
 #include <string>
 #include "IReader.h"
+#include "IAsyncReader.h"
 #include "IUnmarshal.h"
+#include "ParseLimits.h"
+#include "ShapeCache.h"
+#include "StringReader.h"
+#include "Task.h"
 
 namespace gnilk {
 
@@ -42,6 +47,8 @@ namespace gnilk {
             virtual void Previous() {};
             virtual bool Equals(const ArrayIterator::Ref &other) const { return false; };
             virtual bool End() const { return true; }
+            // Number of items if known up front, 0 otherwise
+            virtual size_t Size() const { return 0; }
         public:
             virtual bool IsArray() { return false; }
             virtual bool IsObject() { return false; }
@@ -100,8 +107,41 @@ namespace gnilk {
         std::optional<float> ReadFloatField(const std::string &name) override { return {}; }
         std::optional<std::string> ReadTextField(const std::string &name) override { return {}; }
 
+        // Reads everything from 'asyncReader' without blocking the thread, then parses and unmarshals it.
+        // Both the reader and 'rootObject' must stay alive until the task is done.
+        template<AsyncReader R>
+        Task<bool> UnmarshalAsync(R &asyncReader, IUnmarshal *rootObject) {
+            auto data = co_await ReadAllAsync(asyncReader);
+            if (!data.has_value()) {
+                co_return false;
+            }
+            Begin(StringReader::Create(*data));
+            co_return Unmarshal(rootObject);
+        }
+
+        // Shape cache used when unmarshalling objects implementing IUnmarshalSlots, set one to share it between decoders
+        void SetShapeCache(ShapeCache::Ref cache) {
+            shapeCache = cache;
+        }
+        ShapeCache::Ref GetShapeCache() {
+            if (shapeCache == nullptr) {
+                shapeCache = ShapeCache::Create();
+            }
+            return shapeCache;
+        }
+
+        // Limits for parsing (untrusted) data, used by 'Begin' - data given to the constructors is parsed with the defaults
+        void SetParseLimits(const ParseLimits &limits) {
+            parseLimits = limits;
+        }
+        const ParseLimits &GetParseLimits() const {
+            return parseLimits;
+        }
+
     protected:
         IReader::Ref reader;
+        ShapeCache::Ref shapeCache = {};
+        ParseLimits parseLimits = {};
     };
 }
 
@@ -10,6 +10,7 @@
 #include <utility>
 #include <algorithm>
 #include <variant>
+#include <span>
 #include <stdint.h>
 #include "IWriter.h"
 
@@ -35,6 +36,13 @@ namespace gnilk {
         virtual void WriteFloatField(const std::string &name, double value) = 0;
         virtual void WriteTextField(const std::string &name, const std::string &value) = 0;
 
+        // Arrays, fields written within an array should have an empty name (it is ignored)
+        virtual void BeginArray(const std::string &name) = 0;
+        virtual void EndArray() = 0;
+        // Bulk writers - the full span is written as an array in one go (i.e. Begin/Write/EndArray)
+        virtual void WriteIntArray(const std::string &name, std::span<const int64_t> values) = 0;
+        virtual void WriteDoubleArray(const std::string &name, std::span<const double> values) = 0;
+
         virtual IWriter::Ref GetWriter() = 0;
         virtual bool IsFeatureSupported(kFeature feature) = 0;
     };
@@ -86,6 +94,25 @@ namespace gnilk {
         void WriteFloatField(const std::string &name, double value) override {}
         void WriteTextField(const std::string &name, const std::string &value) override {}
 
+        void BeginArray(const std::string &name) override {}
+        void EndArray() override {}
+
+        // Default bulk writers just loop, override these in the encoder for speed...
+        void WriteIntArray(const std::string &name, std::span<const int64_t> values) override {
+            BeginArray(name);
+            for(auto v : values) {
+                WriteInt64Field({}, v);
+            }
+            EndArray();
+        }
+        void WriteDoubleArray(const std::string &name, std::span<const double> values) override {
+            BeginArray(name);
+            for(auto v : values) {
+                WriteFloatField({}, v);
+            }
+            EndArray();
+        }
+
         // From EncoderWithAttributes
         void BeginObject(const std::string &name, const std::vector<EncoderObjectAttribute > &&attributes) override {}
         void SingleObject(const std::string &name, const std::vector<EncoderObjectAttribute > &&attributes) override {}
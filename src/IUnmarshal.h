@@ -6,6 +6,9 @@
 #define GNILK_IUNMARSHAL_H
 
 #include <string>
+#include <string_view>
+#include <charconv>
+#include <stdint.h>
 
 namespace gnilk {
     class IUnmarshal {
@@ -17,6 +20,10 @@ namespace gnilk {
         virtual bool SetField(const std::string &fieldName, const std::string &fieldValue) = 0;
         virtual IUnmarshal *GetUnmarshalForField(const std::string &fieldName) = 0;
         virtual bool PushToArray(const std::string &arrayName, IUnmarshal *pData) = 0;
+        // Called before the items of an array, 'count' is 0 when the decoder can't count ahead - use it to pre-size containers.
+        // XML has no arrays, it is called once per child name and decoded children are only given to 'PushToArray'
+        // for names where this returns true. JSON always pushes and ignores the result.
+        virtual bool ReserveArray(const std::string &arrayName, size_t count) { return false; }
     };
 
     class BaseUnmarshal : public IUnmarshal {
@@ -26,6 +33,75 @@ namespace gnilk {
         IUnmarshal *GetUnmarshalForField(const std::string &fieldName) override {return nullptr; }
         bool PushToArray(const std::string &arrayName, IUnmarshal *pData) override {return false; }
     };
+
+    // Typed callbacks, decoders use these (instead of SetField) when the object implements this interface.
+    // The views are only valid during the call.
+    // Decoders knowing the type of a value (like JSON) call the matching function, others call SetString.
+    class IUnmarshalTyped : public IUnmarshal {
+    public:
+        virtual ~IUnmarshalTyped() = default;
+
+        virtual bool SetInt(std::string_view fieldName, int64_t value) = 0;
+        virtual bool SetDouble(std::string_view fieldName, double value) = 0;
+        virtual bool SetBool(std::string_view fieldName, bool value) = 0;
+        virtual bool SetNull(std::string_view fieldName) = 0;
+        virtual bool SetString(std::string_view fieldName, std::string_view value) = 0;
+    };
+
+    // A decoded scalar value, 'str' always holds the text from the document
+    struct UnmarshalValue {
+        enum class kType : uint8_t {
+            kString,
+            kInt,
+            kDouble,
+            kBool,
+            kNull,
+        };
+        kType type = kType::kString;
+        std::string_view str = {};
+        int64_t intValue = 0;
+        double doubleValue = 0.0;
+        bool boolValue = false;
+    };
+
+    // Optional, objects implementing this get field name resolution cached per object layout (see ShapeCache).
+    // Slots must be the same for all instances of a class, like the index of the field in a table.
+    class IUnmarshalSlots {
+    public:
+        virtual ~IUnmarshalSlots() = default;
+
+        // Return the slot for 'fieldName' or -1 if unknown (the decoder will then use the regular callbacks)
+        virtual int ResolveSlot(std::string_view fieldName) = 0;
+        virtual bool SetSlot(int slot, const UnmarshalValue &value) = 0;
+    };
+
+    // Typed callbacks fall back to SetField - override the ones you want
+    class BaseUnmarshalTyped : public IUnmarshalTyped {
+    public:
+        virtual ~BaseUnmarshalTyped() = default;
+        bool SetField(const std::string &fieldName, const std::string &fieldValue) override { return false; }
+        IUnmarshal *GetUnmarshalForField(const std::string &fieldName) override {return nullptr; }
+        bool PushToArray(const std::string &arrayName, IUnmarshal *pData) override {return false; }
+
+        bool SetInt(std::string_view fieldName, int64_t value) override {
+            return SetField(std::string(fieldName), std::to_string(value));
+        }
+        bool SetDouble(std::string_view fieldName, double value) override {
+            // shortest form that reads back to the same value, std::to_string would print 1e-7 as 0.000000
+            char buffer[32];
+            auto res = std::to_chars(buffer, buffer + sizeof(buffer), value);
+            return SetField(std::string(fieldName), std::string(buffer, res.ptr));
+        }
+        bool SetBool(std::string_view fieldName, bool value) override {
+            return SetField(std::string(fieldName), value ? "true" : "false");
+        }
+        bool SetNull(std::string_view fieldName) override {
+            return SetField(std::string(fieldName), "null");
+        }
+        bool SetString(std::string_view fieldName, std::string_view value) override {
+            return SetField(std::string(fieldName), std::string(value));
+        }
+    };
 }
 
 #endif //GNILK_IUNMARSHAL_H
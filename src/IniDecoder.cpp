@@ -7,30 +7,41 @@
 
 using namespace gnilk;
 IniDecoder::IniDecoder(IReader::Ref incoming) {
-    parser = IniParser::Create(incoming);
+    ownedParser = IniParser::Create(incoming);
+    parser = ownedParser.get();
     Initialize();
 }
 
 IniDecoder::IniDecoder(const std::string &data)  {
-    parser = IniParser::Create(data);
+    ownedParser = IniParser::Create(data);
+    parser = ownedParser.get();
     Initialize();
 }
 
+IniDecoder::IniDecoder(const IniParser &parsed) : parser(&parsed) {
+}
+
 void IniDecoder::Begin(IReader::Ref incoming) {
     if (!parser) {
-        parser = IniParser::Create(incoming);
+        ownedParser = IniParser::Create(incoming);
+        parser = ownedParser.get();
     }
     Initialize();
 }
 void IniDecoder::Begin(const std::string &data) {
     if (!parser) {
-        parser = IniParser::Create(data);
+        ownedParser = IniParser::Create(data);
+        parser = ownedParser.get();
     }
     Initialize();
 }
 
 void IniDecoder::Initialize() {
-    parser->ProcessData();
+    // Parsers given to us are already processed
+    if (ownedParser != nullptr) {
+        ownedParser->SetLimits(parseLimits);
+        ownedParser->ProcessData();
+    }
 }
 
 bool IniDecoder::BeginObject(const std::string &name) {
@@ -121,8 +132,21 @@ bool IniDecoder::Unmarshal(IUnmarshal *rootObject) {
             return false;
         }
         auto workObject = rootObject->GetUnmarshalForField(section->name);
+        // Values before the first section belong to the root object
+        if ((workObject == nullptr) && section->name.empty()) {
+            workObject = rootObject;
+        }
+        if (workObject == nullptr) {
+            continue;
+        }
+        // INI has no types, typed objects just get the strings without copies
+        auto pTyped = dynamic_cast<IUnmarshalTyped *>(workObject);
         for(auto &[fieldName, fieldValue] : section->values) {
-            workObject->SetField(fieldName, fieldValue);
+            if (pTyped != nullptr) {
+                pTyped->SetString(fieldName, fieldValue);
+            } else {
+                workObject->SetField(fieldName, fieldValue);
+            }
         }
     }
     return true;
@@ -21,6 +21,8 @@ namespace gnilk {
         IniDecoder() = default;
         explicit IniDecoder(IReader::Ref incoming);
         explicit IniDecoder(const std::string &data);
+        // Reads an already parsed (i.e. ProcessData called) ini file, the parser must outlive the decoder
+        explicit IniDecoder(const IniParser &parsed);
         virtual ~IniDecoder() = default;
 
         bool Unmarshal(IUnmarshal *rootObject) override;
@@ -41,7 +43,9 @@ namespace gnilk {
     protected:
         void Initialize();
     protected:
-        IniParser::Ref parser;
+        // Only set when we parse ourselves
+        IniParser::Ref ownedParser;
+        const IniParser *parser = nullptr;
         std::stack<IniParser::Section::Ref> objectStack;
         IniParser::Section::Ref currentSection = {};
 
@@ -3,6 +3,7 @@
 //
 
 #include "IniEncoder.h"
+#include "EncoderHelpers.h"
 
 using namespace gnilk;
 
@@ -15,8 +16,9 @@ void IniEncoder::Begin(IWriter::Ref writer) {
 
 // This is used by the messages
 void IniEncoder::BeginObject(const std::string &name) {
-    if (name.length() > 0) {
-        ss << "[" << name << "]" << StringWriter::eol;
+    auto &sectionName = KeyName(name);
+    if (sectionName.length() > 0) {
+        ss << "[" << sectionName << "]" << StringWriter::eol;
     }
 }
 
@@ -27,20 +29,59 @@ void IniEncoder::EndObject() {
 
 // Note: 'hasNext' is deprecated, parameter ignored
 void IniEncoder::WriteBoolField(const std::string &name, bool value) {
-    ss << name << " = " << value << StringWriter::eol;
+    ss << KeyName(name) << " = " << value << StringWriter::eol;
 }
 
 void IniEncoder::WriteIntField(const std::string &name, int value) {
-    ss << name << " = " << value << StringWriter::eol;
+    ss << KeyName(name) << " = " << value << StringWriter::eol;
 }
 void IniEncoder::WriteInt64Field(const std::string &name, int64_t value) {
-    ss << name << " = " << value << StringWriter::eol;
+    ss << KeyName(name) << " = " << value << StringWriter::eol;
 }
 
 void IniEncoder::WriteFloatField(const std::string &name, double value) {
-    ss << name << " = " << value << StringWriter::eol;
+    ss << KeyName(name) << " = " << value << StringWriter::eol;
 }
 
 void IniEncoder::WriteTextField(const std::string &name, const std::string &value) {
-    ss << name << " = " << value << StringWriter::eol;
+    ss << KeyName(name) << " = " << value << StringWriter::eol;
+}
+
+void IniEncoder::BeginArray(const std::string &name) {
+    arrayStack.push_back(KeyName(name));
+}
+
+void IniEncoder::EndArray() {
+    arrayStack.pop_back();
+}
+
+void IniEncoder::WriteIntArray(const std::string &name, std::span<const int64_t> values) {
+    WriteArrayImpl(name, values);
+}
+
+void IniEncoder::WriteDoubleArray(const std::string &name, std::span<const double> values) {
+    WriteArrayImpl(name, values);
+}
+
+// All 'key = value' lines are formatted into one buffer and written in one go
+template<typename T>
+void IniEncoder::WriteArrayImpl(const std::string &name, std::span<const T> values) {
+    auto &key = KeyName(name);
+    std::string out;
+    out.reserve(values.size() * (key.size() + 3 + StringWriter::eol.size() + 8));
+    for(auto &v : values) {
+        out += key;
+        out += " = ";
+        append_to(out, v);
+        out += StringWriter::eol;
+    }
+    ss << out;
+}
+
+// Unnamed values within an array are written with the array name as key
+const std::string &IniEncoder::KeyName(const std::string &name) {
+    if (!name.empty() || arrayStack.empty()) {
+        return name;
+    }
+    return arrayStack.back();
 }
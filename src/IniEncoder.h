@@ -7,6 +7,7 @@
 
 #include <string>
 #include <memory>
+#include <vector>
 
 #include "IEncoder.h"
 #include "StringWriter.h"
@@ -44,11 +45,20 @@ namespace gnilk {
         virtual IWriter::Ref GetWriter() override { return {}; }
         virtual bool IsFeatureSupported(kFeature feature) override {  return false; }
 
-//        void BeginArray(const char *name, IEncoder::kArrayTypeSpec typeSpec) override;
-//        void EndArray(bool hasNext = false) override;
+        // Arrays are written as multi-value keys, i.e. the key is repeated once per value
+        void BeginArray(const std::string &name) override;
+        void EndArray() override;
 
+        void WriteIntArray(const std::string &name, std::span<const int64_t> values) override;
+        void WriteDoubleArray(const std::string &name, std::span<const double> values) override;
+
+    private:
+        const std::string &KeyName(const std::string &name);
+        template<typename T>
+        void WriteArrayImpl(const std::string &name, std::span<const T> values);
     private:
         StringWriter ss;
+        std::vector<std::string> arrayStack;
     };
 }
 
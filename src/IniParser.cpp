@@ -18,6 +18,7 @@ IniParser::IniParser(IReader::Ref stream) : inStream(stream)
 bool IniParser::ProcessData() {
     bool res = false;
     state = kSectionStart;
+    guard.Reset();
 
     ResetKey();
     ResetValue();
@@ -26,6 +27,9 @@ bool IniParser::ProcessData() {
     char next;
     // FIXME: rewrite as 'while(inStream->Available()) {
     while((nread = inStream->Read((uint8_t *)&next, sizeof(next))) > 0) {
+        if (!guard.OnBytes(1)) {
+            goto leave;
+        }
         switch(state) {
             case kUnknown :
                 // printf("Unknown state, this should not happen - developer error...\n");
@@ -116,16 +120,25 @@ bool IniParser::ProcessData() {
                 break;
 
         }
+        if (!guard.CheckStringLength(section.size()) || !guard.CheckStringLength(key.size()) ||
+            !guard.CheckStringLength(value.size()) || guard.IsExceeded()) {
+            goto leave;
+        }
     }
-    // Assume we are all good...
-    res = true;
+    // An unterminated section name or a key without '=' is an error, anything else is all good
+    res = (state != kSectionName) && (state != kKey) && (state != kSeparator);
 
     // Check if we are running of data and we are in the Value state, assume file terminates after the last char of value...
     if ((nread == 0) && (state == kValue)) {
         Commit();
+        res = !guard.IsExceeded();
     }
 
 leave:
+    // Nothing half parsed is kept when a limit was hit
+    if (guard.IsExceeded()) {
+        sectionMap.clear();
+    }
     return res;
 }
 
@@ -139,5 +152,7 @@ void IniParser::Commit() {
     }
     auto &s = sectionMap[section];
     s->values.push_back({key, value});
+    guard.OnStep();
+    guard.CheckMembers(s->values.size());
 }
 
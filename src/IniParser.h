@@ -13,6 +13,7 @@
 
 #include "IReader.h"
 #include "IDecoder.h"
+#include "ParseLimits.h"
 
 namespace gnilk {
 
@@ -52,14 +53,18 @@ namespace gnilk {
             return std::make_shared<IniParser>(inStream);
         }
 
-        IniParser::Section::Ref GetSection(const std::string &section) {
-            if (!sectionMap.contains(section)) {
+        IniParser::Section::Ref GetSection(const std::string &section) const {
+            auto it = sectionMap.find(section);
+            if (it == sectionMap.end()) {
                 return nullptr;
             }
-            return sectionMap[section];
+            return it->second;
         }
 
         void SetValueDelegate(ValueDelegate valueDelegate) { cbValue = valueDelegate; }
+        void SetLimits(const ParseLimits &limits) { guard = ParseGuard(limits); }
+        // The limit which made the last parse fail, kNone if none
+        ParseLimits::kLimit GetExceededLimit() const { return guard.GetExceeded(); }
         bool ProcessData();
     private:
         void Commit();
@@ -110,6 +115,7 @@ namespace gnilk {
         kState stateAfterWhiteSpace = kUnknown;
         IReader::Ref inStream = {};
         ValueDelegate cbValue = nullptr;
+        ParseGuard guard = {};
 
 
     };
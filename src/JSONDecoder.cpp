@@ -9,28 +9,55 @@ using namespace gnilk;
 
 static JSONObject::Ref FindObject(const JSONObject::Ref &root, const std::string &name);
 static JSONArray::Ref FindArray(const JSONObject::Ref &root, const std::string &name);
+static UnmarshalValue ToUnmarshalValue(const JSONValue &value);
+static bool SetTypedField(IUnmarshalTyped *pObject, std::string_view name, const UnmarshalValue &value);
 
 JSONDecoder::JSONDecoder(IReader::Ref incoming) {
-    doc = JSONParser::Load(incoming);
+    ownedDoc = JSONParser::Load(incoming);
+    doc = ownedDoc.get();
     Initialize();
 }
 JSONDecoder::JSONDecoder(const std::string &jsondata) {
-    doc = JSONParser::Load(jsondata);
+    ownedDoc = JSONParser::Load(jsondata);
+    doc = ownedDoc.get();
+    Initialize();
+}
+
+JSONDecoder::JSONDecoder(const JSONDoc &document) : doc(&document) {
     Initialize();
 }
 
 void JSONDecoder::Begin(IReader::Ref incoming) {
-    doc = JSONParser::Load(incoming);
+    streamParser = {};
+    ownedDoc = JSONParser::Load(incoming, parseLimits);
+    doc = ownedDoc.get();
     Initialize();
 }
 
 void JSONDecoder::Begin(const std::string &jsonData) {
-    doc = JSONParser::Load(jsonData);
+    streamParser = {};
+    ownedDoc = JSONParser::Load(jsonData, parseLimits);
+    doc = ownedDoc.get();
+    Initialize();
+}
+
+void JSONDecoder::BeginValue(IReader::Ref incoming) {
+    streamParser = {};
+    ownedDoc = JSONParser::LoadValue(incoming, parseLimits);
+    doc = ownedDoc.get();
+    Initialize();
+}
+
+void JSONDecoder::BeginStream(IReader::Ref incoming) {
+    ownedDoc = {};
+    doc = nullptr;
+    streamParser = std::make_unique<JSONParser>(incoming);
+    streamParser->SetLimits(parseLimits);
     Initialize();
 }
 
 void JSONDecoder::Initialize() {
-    if (doc == nullptr) {
+    if ((doc == nullptr) && (streamParser == nullptr)) {
         return;
     }
     // Make sure we push the first state...
@@ -38,10 +65,17 @@ void JSONDecoder::Initialize() {
 }
 
 bool JSONDecoder::Unmarshal(IUnmarshal *rootObject) {
-    auto root = doc->GetRoot();
+    if (streamParser != nullptr) {
+        return UnmarshalStream(rootObject);
+    }
+    if (doc == nullptr) {
+        return false;
+    }
+    auto &root = doc->GetRoot();
     // try fetch as JSONObject
     auto ptrJsonRootObject = std::get_if<JSONObject::Ref>(&root);
-    if (ptrJsonRootObject != nullptr) {
+    // Empty documents and scalar roots have neither
+    if ((ptrJsonRootObject != nullptr) && (*ptrJsonRootObject != nullptr)) {
         auto jsonObject = *ptrJsonRootObject;
         return UnmarshalObject(rootObject, jsonObject);
     }
@@ -49,7 +83,7 @@ bool JSONDecoder::Unmarshal(IUnmarshal *rootObject) {
     // Wasn't a JSONObject, try as JSON array - if that fails we simply bail
     // JSON can have two root types (Object or Array)
     auto ptrJsonRootArray = std::get_if<JSONArray::Ref>(&root);
-    if (ptrJsonRootArray == nullptr) {
+    if ((ptrJsonRootArray == nullptr) || (*ptrJsonRootArray == nullptr)) {
         return false;
     }
     auto jsonArray = *ptrJsonRootArray;
@@ -59,20 +93,39 @@ bool JSONDecoder::Unmarshal(IUnmarshal *rootObject) {
 bool JSONDecoder::UnmarshalObject(IUnmarshal *pObject, const JSONObject::Ref &jsonObject) {
     if (pObject == nullptr) return false;
 
+    // Typed objects get the values already converted
+    auto pTyped = dynamic_cast<IUnmarshalTyped *>(pObject);
+    // Objects with slots have their layout cached
+    auto pSlots = dynamic_cast<IUnmarshalSlots *>(pObject);
+    ShapeCache::Cursor shapeCursor;
+    if (pSlots != nullptr) {
+        shapeCursor = GetShapeCache()->Begin(pSlots);
+    }
+
     for(auto &[name, value] : jsonObject->GetValues()) {
-        if (value->IsString()) {
+        int slot = -1;
+        if (pSlots != nullptr) {
+            slot = shapeCache->Resolve(shapeCursor, name);
+        }
+        if (value.IsString()) {
             // if we are holding a string (i.e. number, text, etc..) we just call setfield with the array as the field name
-            pObject->SetField(name, value->GetAsString());
-        } else if (value->IsObject()) {
+            if (slot >= 0) {
+                pSlots->SetSlot(slot, ToUnmarshalValue(value));
+            } else if (pTyped != nullptr) {
+                SetTypedField(pTyped, name, ToUnmarshalValue(value));
+            } else {
+                pObject->SetField(std::string(name), std::string(value.GetAsString()));
+            }
+        } else if (value.IsObject()) {
             // we have an object - try to fetch the unmarshal for that object
-            auto newUnmarshal = pObject->GetUnmarshalForField(name);
+            auto newUnmarshal = pObject->GetUnmarshalForField(std::string(name));
             if (newUnmarshal != nullptr) {
-                if (!UnmarshalObject(newUnmarshal, value->GetAsObject())) {
+                if (!UnmarshalObject(newUnmarshal, value.GetAsObject())) {
                     return false;
                 }
             }
-        } else if (value->IsArray()) {
-            if (!UnmarshalArray(pObject, value->GetAsArray())) {
+        } else if (value.IsArray()) {
+            if (!UnmarshalArray(pObject, value.GetAsArray())) {
                 return false;
             }
         }
@@ -81,34 +134,61 @@ bool JSONDecoder::UnmarshalObject(IUnmarshal *pObject, const JSONObject::Ref &js
 }
 
 bool JSONDecoder::UnmarshalArray(IUnmarshal *pObject, const JSONArray::Ref &jsonArray) {
+    auto pTyped = dynamic_cast<IUnmarshalTyped *>(pObject);
+    (void)pObject->ReserveArray(jsonArray->GetName(), jsonArray->Size());
     for(auto &item : jsonArray->GetValues()) {
-        if (item->IsString()) {
-            pObject->SetField(jsonArray->GetName(), item->GetAsString());
-        } else if (item->IsObject()) {
-            // Note: we simply don't have the object name here - instead we just assume the consumer knows about it...
-            auto newUnmarshal = pObject->GetUnmarshalForField(jsonArray->GetName());
-            if (newUnmarshal != nullptr) {
-                // Note: We don't return here as we are in a loop
-                if (!UnmarshalObject(newUnmarshal, item->GetAsObject())) {
-                    return false;
-                }
-                pObject->PushToArray(jsonArray->GetName(), newUnmarshal);
+        if (!UnmarshalArrayItem(pObject, pTyped, jsonArray->GetName(), item)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool JSONDecoder::UnmarshalArrayItem(IUnmarshal *pObject, IUnmarshalTyped *pTyped, const std::string &arrayName, const JSONValue &item) {
+    if (item.IsString()) {
+        if (pTyped != nullptr) {
+            SetTypedField(pTyped, arrayName, ToUnmarshalValue(item));
+        } else {
+            pObject->SetField(arrayName, std::string(item.GetAsString()));
+        }
+    } else if (item.IsObject()) {
+        // Note: we simply don't have the object name here - instead we just assume the consumer knows about it...
+        auto newUnmarshal = pObject->GetUnmarshalForField(arrayName);
+        if (newUnmarshal != nullptr) {
+            if (!UnmarshalObject(newUnmarshal, item.GetAsObject())) {
+                return false;
             }
-        } else if (item->IsArray()) {
-            // Note: We simply don't have an idea of the array name - instead we just assume the consumer knows abou it...
-            auto newUnmarshal = pObject->GetUnmarshalForField(jsonArray->GetName());
-            if (newUnmarshal) {
-                // Note: We don't return here as we are in a loop
-                if (!UnmarshalArray(newUnmarshal, item->GetAsArray())) {
-                    return false;
-                }
-                pObject->PushToArray(jsonArray->GetName(), newUnmarshal);
+            pObject->PushToArray(arrayName, newUnmarshal);
+        }
+    } else if (item.IsArray()) {
+        // Note: We simply don't have an idea of the array name - instead we just assume the consumer knows abou it...
+        auto newUnmarshal = pObject->GetUnmarshalForField(arrayName);
+        if (newUnmarshal) {
+            if (!UnmarshalArray(newUnmarshal, item.GetAsArray())) {
+                return false;
             }
+            pObject->PushToArray(arrayName, newUnmarshal);
         }
     }
     return true;
 }
 
+// Root arrays are unmarshalled one item at a time, other roots would need the full document
+bool JSONDecoder::UnmarshalStream(IUnmarshal *pObject) {
+    if (pObject == nullptr) return false;
+    if (streamParser->BeginArrayStream({}) != JSONParser::kResult::Ok) {
+        return false;
+    }
+    auto pTyped = dynamic_cast<IUnmarshalTyped *>(pObject);
+    JSONValue::Ref item;
+    JSONParser::kResult res;
+    while(((res = streamParser->NextArrayStreamItem(item)) == JSONParser::kResult::Ok) && (item != nullptr)) {
+        if (!UnmarshalArrayItem(pObject, pTyped, {}, *item)) {
+            return false;
+        }
+    }
+    return (res == JSONParser::kResult::Ok);
+}
 
 bool JSONDecoder::BeginObject(const std::string &name) {
     // If we are in an array - we treat this differently...
@@ -118,11 +198,15 @@ bool JSONDecoder::BeginObject(const std::string &name) {
     }
 
     if (objStack.empty()) {
+        // Streams are only read through arrays
+        if (doc == nullptr) {
+            return false;
+        }
         // If stack is empty - we assume the first call to 'BeginObject' is the actual object we want to deserialize...
-        auto root = doc->GetRoot();
+        auto &root = doc->GetRoot();
         auto rootObject = std::get_if<JSONObject::Ref>(&root);
-        if (rootObject == nullptr) {
-            // this is an array - and we don't yet process it..
+        if ((rootObject == nullptr) || (*rootObject == nullptr)) {
+            // an array, a scalar or nothing at all - we don't process it here..
             return false;
         }
         objStack.push(*rootObject);
@@ -183,9 +267,15 @@ IDecoder::ArrayIterator::Ref JSONDecoder::BeginArray(const std::string &name) {
     }
 
     if (objStack.empty()) {
-        auto root = doc->GetRoot();
+        if (streamParser != nullptr) {
+            return BeginArrayStream(name);
+        }
+        if (doc == nullptr) {
+            return BaseDecoder::BeginArray("");
+        }
+        auto &root = doc->GetRoot();
         auto rootObject = std::get_if<JSONArray::Ref>(&root);
-        if (rootObject == nullptr) {
+        if ((rootObject == nullptr) || (*rootObject == nullptr)) {
             // we don't have something so return a dummy iterator...
             return BaseDecoder::BeginArray("");
         }
@@ -210,6 +300,20 @@ IDecoder::ArrayIterator::Ref JSONDecoder::BeginArray(const std::string &name) {
     return it;
 }
 
+IDecoder::ArrayIterator::Ref JSONDecoder::BeginArrayStream(const std::string &name) {
+    // Should always be called - even if the array is missing
+    ChangeState(kState::kInArray);
+    if (streamParser->BeginArrayStream(name) != JSONParser::kResult::Ok) {
+        arrStack.push({BaseDecoder::BeginArray(""), {}});
+        return arrStack.top().iterator;
+    }
+    auto it = std::make_shared<JSONStreamArrayIterator>(*streamParser);
+    // Bring in the first item
+    it->result = streamParser->NextArrayStreamItem(it->current);
+    arrStack.push({it, {}});
+    return it;
+}
+
 // This is for nested array's at the iteration point...
 IDecoder::ArrayIterator::Ref JSONDecoder::BeginArray(const JSONArrayIterator::Ref &it) {
     return nullptr;
@@ -290,8 +394,8 @@ std::optional<std::string> JSONDecoder::ReadTextField(const std::string &name) {
         return {};
     }
 
-    auto &strValue = value->GetAsString();
-    return {strValue};
+    auto strValue = value->GetAsString();
+    return std::string(strValue);
 }
 
 
@@ -301,8 +405,64 @@ static JSONObject::Ref FindObject(const JSONObject::Ref &root, const std::string
 
     for(auto &[memberName, value] : root->GetValues()) {
         if (memberName != name) continue;
-        if (value->IsObject()) return value->GetAsObject();
+        if (value.IsObject()) return value.GetAsObject();
     }
 
     return {};
 }
+
+// Convert a scalar to what it was in the document
+static UnmarshalValue ToUnmarshalValue(const JSONValue &value) {
+    UnmarshalValue result;
+    auto strValue = value.GetAsString();
+    result.str = strValue;
+    switch(value.GetScalarType()) {
+        case JSONValue::kScalar::kBool :
+            result.type = UnmarshalValue::kType::kBool;
+            result.boolValue = (strValue == "true");
+            break;
+        case JSONValue::kScalar::kNull :
+            result.type = UnmarshalValue::kType::kNull;
+            break;
+        case JSONValue::kScalar::kNumber :
+            // Integers are passed as such unless they don't fit
+            if (strValue.find_first_of(".eE") == std::string_view::npos) {
+                auto intValue = convert_to<int64_t>(strValue);
+                if (intValue.has_value()) {
+                    result.type = UnmarshalValue::kType::kInt;
+                    result.intValue = *intValue;
+                    break;
+                }
+            }
+            {
+                auto doubleValue = convert_to<double>(strValue);
+                if (doubleValue.has_value()) {
+                    result.type = UnmarshalValue::kType::kDouble;
+                    result.doubleValue = *doubleValue;
+                }
+            }
+            // Not a valid number - let the object decide, it will get the string
+            break;
+        case JSONValue::kScalar::kText :
+        default:
+            break;
+    }
+    return result;
+}
+
+// Calls the typed setter matching what the value was in the document
+static bool SetTypedField(IUnmarshalTyped *pObject, std::string_view name, const UnmarshalValue &value) {
+    switch(value.type) {
+        case UnmarshalValue::kType::kBool :
+            return pObject->SetBool(name, value.boolValue);
+        case UnmarshalValue::kType::kNull :
+            return pObject->SetNull(name);
+        case UnmarshalValue::kType::kInt :
+            return pObject->SetInt(name, value.intValue);
+        case UnmarshalValue::kType::kDouble :
+            return pObject->SetDouble(name, value.doubleValue);
+        case UnmarshalValue::kType::kString :
+        default:
+            return pObject->SetString(name, value.str);
+    }
+}
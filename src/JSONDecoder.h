@@ -36,21 +36,33 @@ namespace gnilk {
             }
             return (idxCurrent == array->Size());
         }
+        size_t Size() const override {
+            if (array == nullptr) {
+                return 0;
+            }
+            return array->Size();
+        }
     public:
         bool IsArray() override {
-            auto &item = array->At(idxCurrent);
+            auto item = GetValue();
+            if (item == nullptr) {
+                return false;
+            }
             return item->IsArray();
         }
 
         bool IsObject() override {
-            auto &item = array->At(idxCurrent);
+            auto item = GetValue();
+            if (item == nullptr) {
+                return false;
+            }
             return item->IsObject();
         }
 
 
         bool ReadBool() override {
-            auto &item = array->At(idxCurrent);
-            if (!item->IsString()) {
+            auto item = GetValue();
+            if ((item == nullptr) || !item->IsString()) {
                 return false;
             }
             auto out = convert_to<bool>(item->GetAsString());
@@ -60,8 +72,8 @@ namespace gnilk {
             return *out;
         }
         int ReadInt() override {
-            auto &item = array->At(idxCurrent);
-            if (!item->IsString()) {
+            auto item = GetValue();
+            if ((item == nullptr) || !item->IsString()) {
                 return -1;
             }
             auto out = convert_to<int>(item->GetAsString());
@@ -71,8 +83,8 @@ namespace gnilk {
             return *out;
         }
         int64_t ReadInt64() override {
-            auto &item = array->At(idxCurrent);
-            if (!item->IsString()) {
+            auto item = GetValue();
+            if ((item == nullptr) || !item->IsString()) {
                 return -1;
             }
             auto out = convert_to<int64_t>(item->GetAsString());
@@ -82,8 +94,8 @@ namespace gnilk {
             return *out;
         }
         float ReadFloat() override {
-            auto &item = array->At(idxCurrent);
-            if (!item->IsString()) {
+            auto item = GetValue();
+            if ((item == nullptr) || !item->IsString()) {
                 return -1;
             }
             auto out = convert_to<float>(item->GetAsString());
@@ -93,32 +105,80 @@ namespace gnilk {
             return *out;
         }
         std::string ReadText() override {
-            auto &item = array->At(idxCurrent);
-            if (!item->IsString()) {
+            auto item = GetValue();
+            if ((item == nullptr) || !item->IsString()) {
                 return {};
             }
-            return item->GetAsString();
+            return std::string(item->GetAsString());
         }
 
     protected:
         static ArrayIterator::Ref Create(JSONArray::Ref jsArray) {
             return std::make_shared<JSONArrayIterator>(jsArray);
         }
-        JSONValue::Ref GetValue() {
+        virtual JSONValue::Ref GetValue() {
             return array->At(idxCurrent);
         }
     protected:
         size_t idxCurrent;
         JSONArray::Ref array;
     };
+
+    //
+    // Iterates an array straight off the stream, each item is parsed when the iterator advances and released when it
+    // moves past it - memory is bounded by the largest item. Forward only, a parse error ends the iteration.
+    //
+    class JSONStreamArrayIterator : public JSONArrayIterator {
+        friend JSONDecoder;
+    public:
+        JSONStreamArrayIterator(JSONParser &streamParser) : JSONArrayIterator(JSONArray::Ref{}), parser(streamParser) {
+
+        }
+        virtual ~JSONStreamArrayIterator() = default;
+
+        void Next() override {
+            if (current == nullptr) {
+                return;
+            }
+            ++idxCurrent;
+            result = parser.NextArrayStreamItem(current);
+        }
+        void Previous() override {}
+        bool Equals(const ArrayIterator::Ref &other) const override {
+            return (this == other.get());
+        }
+        bool End() const override {
+            return (current == nullptr);
+        }
+        // True if the iteration ended because of a parse error
+        bool Failed() const {
+            return (result != JSONParser::kResult::Ok);
+        }
+    protected:
+        JSONValue::Ref GetValue() override {
+            return current;
+        }
+    protected:
+        JSONParser &parser;
+        JSONValue::Ref current = {};
+        JSONParser::kResult result = JSONParser::kResult::Ok;
+    };
     public:
         JSONDecoder() = default;
         explicit JSONDecoder(IReader::Ref incoming);
         explicit JSONDecoder(const std::string &jsondata);
+        // Reads an already parsed document, the document must outlive the decoder.
+        // Decoders don't modify the document - any number of them can read the same document concurrently.
+        explicit JSONDecoder(const JSONDoc &document);
         virtual ~JSONDecoder() = default;
 
         void Begin(IReader::Ref incoming) override;
         void Begin(const std::string &jsondata);
+        // Streaming mode, nothing is parsed up front. 'BeginArray' returns a JSONStreamArrayIterator over the root array
+        // or an array member of the root object, 'Unmarshal' handles root arrays one item at a time.
+        void BeginStream(IReader::Ref incoming);
+        // Decodes a single value from the current position of 'incoming', used to read elements located through a JSONIndex
+        void BeginValue(IReader::Ref incoming);
 
         bool IsValid() {
             return (doc != nullptr);
@@ -144,6 +204,9 @@ namespace gnilk {
         ArrayIterator::Ref BeginArray(const JSONArrayIterator::Ref &it);
         bool UnmarshalObject(IUnmarshal *pObject, const JSONObject::Ref &jsonObject);
         bool UnmarshalArray(IUnmarshal *pObject, const JSONArray::Ref &jsonObject);
+        bool UnmarshalArrayItem(IUnmarshal *pObject, IUnmarshalTyped *pTyped, const std::string &arrayName, const JSONValue &item);
+        bool UnmarshalStream(IUnmarshal *pObject);
+        ArrayIterator::Ref BeginArrayStream(const std::string &name);
 
     protected:
         enum class kState {
@@ -165,12 +228,17 @@ namespace gnilk {
         // Assume we are in regular state
         kState state = kState::kRegular;
 
-        std::unique_ptr<JSONDoc> doc;
+        // Only set when we parsed the document ourselves
+        std::unique_ptr<JSONDoc> ownedDoc;
+        const JSONDoc *doc = nullptr;
+        // Only in streaming mode
+        std::unique_ptr<JSONParser> streamParser;
         // Only objects for now - arrays will come later...
-        std::stack<JSONObject::Ref> objStack;
+        // vector backed - an unused decoder doesn't allocate
+        std::stack<JSONObject::Ref, std::vector<JSONObject::Ref>> objStack;
         //std::stack<ArrayWorkItem> arrStack;
-        std::stack<ArrayWorkObject> arrStack;
-        std::stack<kState> stateStack;
+        std::stack<ArrayWorkObject, std::vector<ArrayWorkObject>> arrStack;
+        std::stack<kState, std::vector<kState>> stateStack;
 
 
 
@@ -5,6 +5,7 @@
 //
 
 #include "JSONEncoder.h"
+#include "EncoderHelpers.h"
 
 using namespace gnilk;
 
@@ -43,18 +44,19 @@ void JSONEncoder::Begin(IWriter::Ref outStream) {
 // This is used by the messages
 void JSONEncoder::BeginObject(const std::string &name) {
     WriteFieldSeparator();
-    if (!name.empty()) {
-        ss << spacing() << quote << name << quote << separator << beginobj << eol;
-    } else {
-        ss << spacing() << beginobj << eol;
-    }
+    ss << spacing();
+    WriteLabel(name);
+    ss << beginobj << eol;
+
     fieldStack.push_back(fieldCount);
+    arrayStack.push_back(false);
     fieldCount = 0;
 }
 
 void JSONEncoder::EndObject() {
     fieldCount = fieldStack.back();
     fieldStack.pop_back();
+    arrayStack.pop_back();
 
     ss << eol << spacing() << endobj;
 
@@ -64,66 +66,94 @@ void JSONEncoder::EndObject() {
 
 void JSONEncoder::WriteBoolField(const std::string &name, bool value) {
     WriteFieldSeparator();
-    if (!name.empty()) {
-        ss << spacing() << quote << name << quote << separator << (value?jsontrue:jsonfalse);
-    } else {
-        ss << spacing() << (value?jsontrue:jsonfalse);
-    }
+    ss << spacing();
+    WriteLabel(name);
+    ss << (value?jsontrue:jsonfalse);
 }
 void JSONEncoder::WriteIntField(const std::string &name, int value) {
     WriteFieldSeparator();
-    if (!name.empty()) {
-        ss << spacing() << quote << name << quote << separator << std::to_string(value);
-    } else {
-        ss << spacing() << std::to_string(value);
-    }
+    ss << spacing();
+    WriteLabel(name);
+    ss << std::to_string(value);
 }
 void JSONEncoder::WriteInt64Field(const std::string &name, int64_t value) {
     WriteFieldSeparator();
-    if (!name.empty()) {
-        ss << spacing() << quote << name << quote << separator << std::to_string(value);
-    } else {
-        ss << spacing() << std::to_string(value);
-    }
+    ss << spacing();
+    WriteLabel(name);
+    ss << std::to_string(value);
 }
 
 void JSONEncoder::WriteFloatField(const std::string &name, double value) {
     WriteFieldSeparator();
-    if (!name.empty()) {
-        ss << spacing() << quote << name << quote << separator << std::to_string(value);
-    } else {
-        ss << spacing() << std::to_string(value);
-    }
+    ss << spacing();
+    WriteLabel(name);
+    ss << std::to_string(value);
 }
 void JSONEncoder::WriteTextField(const std::string &name, const std::string &value) {
     WriteFieldSeparator();
-    if (!name.empty()) {
-        ss << spacing() << quote << name << quote << separator << quote << value << quote;
-    } else {
-        ss << spacing() << quote << value << quote;
-    }
+    ss << spacing();
+    WriteLabel(name);
+    ss << quote << value << quote;
 }
 
-/*
-void JSONEncoder::BeginArray(const std::string &name, IEncoder::kArrayTypeSpec typeSpec) {
+void JSONEncoder::BeginArray(const std::string &name) {
     WriteFieldSeparator();
-    if (!name.empty()) {
-        ss << spacing() << quote << name << quote << separator << beginarray << eol;
-    } else {
-        ss << spacing() << beginarray << eol;
-    }
+    ss << spacing();
+    WriteLabel(name);
+    ss << beginarray << eol;
+
     fieldStack.push_back(fieldCount);
+    arrayStack.push_back(true);
     fieldCount = 0;
 }
+
 void JSONEncoder::EndArray() {
     fieldCount = fieldStack.back();
     fieldStack.pop_back();
+    arrayStack.pop_back();
 
-    ss << eol << spacing() << endarray << eol;
+    ss << eol << spacing() << endarray;
 
     fieldCount += 1;
 }
-*/
+
+void JSONEncoder::WriteIntArray(const std::string &name, std::span<const int64_t> values) {
+    WriteArrayImpl(name, values);
+}
+
+void JSONEncoder::WriteDoubleArray(const std::string &name, std::span<const double> values) {
+    WriteArrayImpl(name, values);
+}
+
+// Formats the whole array into one buffer and writes it in one go - no per-element virtual calls
+template<typename T>
+void JSONEncoder::WriteArrayImpl(const std::string &name, std::span<const T> values) {
+    BeginArray(name);
+
+    auto indent = spacing();
+    std::string out;
+    out.reserve(values.size() * (indent.size() + eol.size() + 8));
+    for(size_t i=0;i<values.size();i++) {
+        if (i > 0) {
+            out += nextfield;
+            out += eol;
+        }
+        out += indent;
+        append_to(out, values[i]);
+    }
+    ss << out;
+    fieldCount = static_cast<int>(values.size());
+
+    EndArray();
+}
+
+void JSONEncoder::WriteLabel(const std::string &name) {
+    // values within an array don't have labels
+    if (name.empty() || (!arrayStack.empty() && arrayStack.back())) {
+        return;
+    }
+    ss << quote << name << quote << separator;
+}
 
 void JSONEncoder::WriteFieldSeparator() {
     if (fieldStack.empty()) return;
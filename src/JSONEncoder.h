@@ -33,15 +33,23 @@ namespace gnilk {
         void WriteFloatField(const std::string &name, double value) override;
         void WriteTextField(const std::string &name, const std::string &value) override;
 
-//        void BeginArray(const char *name, IEncoder::kArrayTypeSpec typeSpec) override;
-//        void EndArray(bool hasNext = false) override;
+        void BeginArray(const std::string &name) override;
+        void EndArray() override;
+
+        void WriteIntArray(const std::string &name, std::span<const int64_t> values) override;
+        void WriteDoubleArray(const std::string &name, std::span<const double> values) override;
     private:
         void WriteFieldSeparator();
+        void WriteLabel(const std::string &name);
+        template<typename T>
+        void WriteArrayImpl(const std::string &name, std::span<const T> values);
     private:
         bool pretty = false;
         std::string eol = "";
         StringWriter ss;
         std::vector<int> fieldStack;
+        // true if the corresponding level in the field stack is an array (values in arrays don't have labels)
+        std::vector<bool> arrayStack;
         int fieldCount;
     };
 }
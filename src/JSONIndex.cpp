@@ -0,0 +1,316 @@
+//
+// Created by gnilk on 19.10.2026.
+//
+
+#include <stdio.h>
+#include <string.h>
+#include "JSONIndex.h"
+#include "DocumentCache.h"
+
+using namespace gnilk;
+
+static constexpr char kFileMagic[8] = {'G','J','S','O','N','I','D','X'};
+static constexpr uint32_t kFileVersion = 3;
+
+static bool IsWhiteSpace(char ch) {
+    return (ch == ' ') || (ch == '\t') || (ch == '\n') || (ch == '\r');
+}
+
+static size_t SkipWhiteSpace(std::string_view data, size_t pos) {
+    while((pos < data.size()) && IsWhiteSpace(data[pos])) {
+        pos++;
+    }
+    return pos;
+}
+
+// 'pos' is on the opening quote, returns the position after the closing quote or npos
+static size_t ScanString(std::string_view data, size_t pos) {
+    pos++;
+    while((pos = data.find_first_of("\"\\", pos)) != std::string_view::npos) {
+        if (data[pos] == '\"') {
+            return pos + 1;
+        }
+        // escaped char
+        pos += 2;
+    }
+    return std::string_view::npos;
+}
+
+// Returns the position after the value starting at 'pos' or npos if it doesn't end
+static size_t ScanValue(std::string_view data, size_t pos) {
+    if (pos >= data.size()) {
+        return std::string_view::npos;
+    }
+    auto ch = data[pos];
+    if (ch == '\"') {
+        return ScanString(data, pos);
+    }
+    if ((ch == '{') || (ch == '[')) {
+        size_t depth = 0;
+        while(pos < data.size()) {
+            ch = data[pos];
+            if (ch == '\"') {
+                if ((pos = ScanString(data, pos)) == std::string_view::npos) {
+                    return pos;
+                }
+                continue;
+            }
+            if ((ch == '{') || (ch == '[')) {
+                depth++;
+            } else if ((ch == '}') || (ch == ']')) {
+                if (--depth == 0) {
+                    return pos + 1;
+                }
+            }
+            pos++;
+        }
+        return std::string_view::npos;
+    }
+    // scalar
+    while((pos < data.size()) && !IsWhiteSpace(data[pos]) && (data[pos] != ',') && (data[pos] != ']') && (data[pos] != '}')) {
+        pos++;
+    }
+    return pos;
+}
+
+// Start of the next non-empty line at or after 'pos', npos if none
+static size_t NextLine(std::string_view data, size_t pos) {
+    while(pos < data.size()) {
+        auto eol = data.find('\n', pos);
+        if (eol == std::string_view::npos) {
+            eol = data.size();
+        }
+        while((pos < eol) && IsWhiteSpace(data[pos])) {
+            pos++;
+        }
+        if (pos < eol) {
+            return pos;
+        }
+        pos = eol + 1;
+    }
+    return std::string_view::npos;
+}
+
+// Skips the array element at 'pos' and its separator, returns the start of the next element
+static size_t NextArrayElement(std::string_view data, size_t pos) {
+    pos = ScanValue(data, pos);
+    if (pos == std::string_view::npos) {
+        return pos;
+    }
+    pos = SkipWhiteSpace(data, pos);
+    if ((pos >= data.size()) || (data[pos] != ',')) {
+        return std::string_view::npos;
+    }
+    return SkipWhiteSpace(data, pos + 1);
+}
+
+// Hash of the first, middle and last 'kSampleSize' bytes, small data is hashed as a whole
+static uint64_t SampleHash(std::string_view data) {
+    auto sampleSize = JSONIndex::kSampleSize;
+    if (data.size() <= 3 * sampleSize) {
+        return DocumentCache::Hash(data);
+    }
+    auto hash = DocumentCache::Hash(data.substr(0, sampleSize));
+    hash = DocumentCache::Hash(data.substr((data.size() - sampleSize) / 2, sampleSize), hash);
+    return DocumentCache::Hash(data.substr(data.size() - sampleSize), hash);
+}
+
+// static
+JSONIndex::Ref JSONIndex::Build(std::string_view data, size_t stride, kLayout layout) {
+    auto index = std::make_shared<JSONIndex>();
+    index->stride = (stride == 0) ? 1 : stride;
+    index->dataSize = data.size();
+    index->checksum = DocumentCache::Hash(data);
+    index->sampleChecksum = SampleHash(data);
+
+    auto pos = SkipWhiteSpace(data, 0);
+    if (layout == kLayout::kAuto) {
+        layout = ((pos < data.size()) && (data[pos] == '[')) ? kLayout::kArray : kLayout::kLines;
+    }
+    if (layout == kLayout::kLines) {
+        index->layout = kLayout::kLines;
+        pos = NextLine(data, 0);
+        while(pos != std::string_view::npos) {
+            if ((index->nElements % index->stride) == 0) {
+                index->offsets.push_back(pos);
+            }
+            index->nElements++;
+            auto eol = data.find('\n', pos);
+            pos = (eol == std::string_view::npos) ? eol : NextLine(data, eol + 1);
+        }
+        return index;
+    }
+
+    index->layout = kLayout::kArray;
+    if ((pos >= data.size()) || (data[pos] != '[')) {
+        return {};
+    }
+    pos = SkipWhiteSpace(data, pos + 1);
+    if ((pos < data.size()) && (data[pos] == ']')) {
+        return (SkipWhiteSpace(data, pos + 1) == data.size()) ? index : nullptr;
+    }
+    while(pos < data.size()) {
+        if ((index->nElements % index->stride) == 0) {
+            index->offsets.push_back(pos);
+        }
+        index->nElements++;
+
+        pos = ScanValue(data, pos);
+        if (pos == std::string_view::npos) {
+            return {};
+        }
+        pos = SkipWhiteSpace(data, pos);
+        if (pos >= data.size()) {
+            break;
+        }
+        if (data[pos] == ']') {
+            // nothing but white space may follow the root array
+            return (SkipWhiteSpace(data, pos + 1) == data.size()) ? index : nullptr;
+        }
+        if (data[pos] != ',') {
+            return {};
+        }
+        pos = SkipWhiteSpace(data, pos + 1);
+    }
+    // the array never ended
+    return {};
+}
+
+size_t JSONIndex::FindElement(std::string_view data, size_t idx) const {
+    // Only the size is checked per lookup, see IsValidFor
+    if ((idx >= nElements) || (data.size() != dataSize)) {
+        return std::string_view::npos;
+    }
+    size_t pos = offsets[idx / stride];
+    if (pos >= data.size()) {
+        return std::string_view::npos;
+    }
+    for(size_t i=0;(i < (idx % stride)) && (pos != std::string_view::npos);i++) {
+        if (layout == kLayout::kLines) {
+            auto eol = data.find('\n', pos);
+            pos = (eol == std::string_view::npos) ? eol : NextLine(data, eol + 1);
+        } else {
+            pos = NextArrayElement(data, pos);
+        }
+    }
+    return (pos < data.size()) ? pos : std::string_view::npos;
+}
+
+bool JSONIndex::IsValidFor(std::string_view data) const {
+    return (data.size() == dataSize) && (SampleHash(data) == sampleChecksum);
+}
+
+bool JSONIndex::Verify(std::string_view data) const {
+    return (data.size() == dataSize) && (DocumentCache::Hash(data) == checksum);
+}
+
+std::string_view JSONIndex::Element(std::string_view data, size_t idx) const {
+    auto pos = FindElement(data, idx);
+    if (pos == std::string_view::npos) {
+        return {};
+    }
+    size_t end;
+    if (layout == kLayout::kLines) {
+        end = data.find('\n', pos);
+        if (end == std::string_view::npos) {
+            end = data.size();
+        }
+        while((end > pos) && IsWhiteSpace(data[end - 1])) {
+            end--;
+        }
+    } else {
+        end = ScanValue(data, pos);
+        if (end == std::string_view::npos) {
+            return {};
+        }
+    }
+    return data.substr(pos, end - pos);
+}
+
+bool JSONIndex::Seek(MMapReader &reader, size_t idx) const {
+    auto pos = FindElement(reader.GetData(), idx);
+    if (pos == std::string_view::npos) {
+        return false;
+    }
+    return reader.Seek(pos);
+}
+
+//
+// File format (native endian): magic, version, layout, stride, number of elements, data size, data checksum,
+// sampled data checksum, number of offsets, offsets
+//
+bool JSONIndex::Save(const std::string &filename) const {
+    auto f = fopen(filename.c_str(), "wb");
+    if (f == nullptr) {
+        return false;
+    }
+    auto layoutValue = static_cast<uint32_t>(layout);
+    uint64_t nOffsets = offsets.size();
+    bool ok = (fwrite(kFileMagic, sizeof(kFileMagic), 1, f) == 1) &&
+              (fwrite(&kFileVersion, sizeof(kFileVersion), 1, f) == 1) &&
+              (fwrite(&layoutValue, sizeof(layoutValue), 1, f) == 1) &&
+              (fwrite(&stride, sizeof(stride), 1, f) == 1) &&
+              (fwrite(&nElements, sizeof(nElements), 1, f) == 1) &&
+              (fwrite(&dataSize, sizeof(dataSize), 1, f) == 1) &&
+              (fwrite(&checksum, sizeof(checksum), 1, f) == 1) &&
+              (fwrite(&sampleChecksum, sizeof(sampleChecksum), 1, f) == 1) &&
+              (fwrite(&nOffsets, sizeof(nOffsets), 1, f) == 1) &&
+              (fwrite(offsets.data(), sizeof(uint64_t), offsets.size(), f) == offsets.size());
+    if (fclose(f) != 0) {
+        ok = false;
+    }
+    return ok;
+}
+
+// Bytes from the current position to the end of 'f', the position is kept
+static uint64_t RemainingBytes(FILE *f) {
+    auto pos = ftell(f);
+    if ((pos < 0) || (fseek(f, 0, SEEK_END) != 0)) {
+        return 0;
+    }
+    auto end = ftell(f);
+    fseek(f, pos, SEEK_SET);
+    return (end > pos) ? static_cast<uint64_t>(end - pos) : 0;
+}
+
+// static
+JSONIndex::Ref JSONIndex::Load(const std::string &filename) {
+    auto f = fopen(filename.c_str(), "rb");
+    if (f == nullptr) {
+        return {};
+    }
+    auto index = std::make_shared<JSONIndex>();
+    char magic[sizeof(kFileMagic)] = {};
+    uint32_t version = 0;
+    uint32_t layoutValue = 0;
+    uint64_t nOffsets = 0;
+    bool ok = (fread(magic, sizeof(magic), 1, f) == 1) &&
+              (memcmp(magic, kFileMagic, sizeof(magic)) == 0) &&
+              (fread(&version, sizeof(version), 1, f) == 1) &&
+              (version == kFileVersion) &&
+              (fread(&layoutValue, sizeof(layoutValue), 1, f) == 1) &&
+              (layoutValue <= static_cast<uint32_t>(kLayout::kLines)) &&
+              (fread(&index->stride, sizeof(index->stride), 1, f) == 1) &&
+              (fread(&index->nElements, sizeof(index->nElements), 1, f) == 1) &&
+              (fread(&index->dataSize, sizeof(index->dataSize), 1, f) == 1) &&
+              (fread(&index->checksum, sizeof(index->checksum), 1, f) == 1) &&
+              (fread(&index->sampleChecksum, sizeof(index->sampleChecksum), 1, f) == 1) &&
+              (fread(&nOffsets, sizeof(nOffsets), 1, f) == 1) &&
+              (index->stride > 0) &&
+              (nOffsets == (index->nElements / index->stride) + (((index->nElements % index->stride) != 0) ? 1 : 0)) &&
+              (nOffsets <= RemainingBytes(f) / sizeof(uint64_t));
+    if (ok) {
+        index->layout = static_cast<kLayout>(layoutValue);
+        index->offsets.resize(nOffsets);
+        ok = (fread(index->offsets.data(), sizeof(uint64_t), nOffsets, f) == nOffsets);
+    }
+    // A damaged file must not send lookups outside of the data
+    for(size_t i=0;ok && (i < index->offsets.size());i++) {
+        ok = (index->offsets[i] < index->dataSize) && ((i == 0) || (index->offsets[i] > index->offsets[i-1]));
+    }
+    fclose(f);
+    if (!ok) {
+        return {};
+    }
+    return index;
+}
@@ -0,0 +1,89 @@
+//
+// Created by gnilk on 19.10.2026.
+//
+// Sidecar offset index for large JSON arrays and JSON Lines (NDJSON) files.
+// One pass over the data records the byte offset of every K:th element, fetching element N is then a jump to the
+// closest offset and a scan over at most K-1 elements.
+//
+//   auto reader = MMapReader::Create("export.json");
+//   auto index = JSONIndex::Build(reader->GetData());
+//   index->Save(JSONIndex::SidecarName("export.json"));
+//   ...
+//   index->Seek(*reader, 123456);
+//   JSONDecoder decoder;
+//   decoder.BeginValue(reader);
+//
+
+#ifndef GNILK_JSONINDEX_H
+#define GNILK_JSONINDEX_H
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <stdint.h>
+
+#include "MMapReader.h"
+
+namespace gnilk {
+    class JSONIndex {
+    public:
+        using Ref = std::shared_ptr<JSONIndex>;
+        enum class kLayout : uint32_t {
+            kArray,     // elements of the root array
+            kLines,     // one value per line, empty lines are skipped
+            kAuto,      // Build only, detected from the data - never stored
+        };
+        static constexpr size_t kDefaultStride = 1024;
+        static constexpr size_t kSampleSize = 4096;
+    public:
+        JSONIndex() = default;
+        virtual ~JSONIndex() = default;
+
+        // With kAuto the layout is detected, data starting with '[' is an array - anything else is lines. Pass kLines for
+        // JSON Lines files whose records are arrays.
+        // Returns null if the data is not a complete array (unbalanced brackets or strings).
+        static Ref Build(std::string_view data, size_t stride = kDefaultStride, kLayout layout = kLayout::kAuto);
+        static Ref Load(const std::string &filename);
+        bool Save(const std::string &filename) const;
+
+        static std::string SidecarName(const std::string &dataFilename) {
+            return dataFilename + ".idx";
+        }
+
+        // An index is only valid for the data it was built from. IsValidFor is the cheap staleness check, it compares the
+        // size and a hash of the first, middle and last kSampleSize bytes. Verify compares a hash of all of the data,
+        // use it when edits that keep the size and miss the samples must be caught. Lookups only compare the size.
+        bool IsValidFor(std::string_view data) const;
+        bool Verify(std::string_view data) const;
+
+        // The text of element 'idx' or an empty view if out of range
+        std::string_view Element(std::string_view data, size_t idx) const;
+        // Positions 'reader' at element 'idx'
+        bool Seek(MMapReader &reader, size_t idx) const;
+
+        size_t Size() const {
+            return nElements;
+        }
+        size_t GetStride() const {
+            return stride;
+        }
+        kLayout GetLayout() const {
+            return layout;
+        }
+
+    protected:
+        size_t FindElement(std::string_view data, size_t idx) const;
+    protected:
+        kLayout layout = kLayout::kArray;
+        uint64_t stride = kDefaultStride;
+        uint64_t nElements = 0;
+        uint64_t dataSize = 0;
+        uint64_t checksum = 0;
+        uint64_t sampleChecksum = 0;
+        // offset of element i * stride
+        std::vector<uint64_t> offsets;
+    };
+}
+
+#endif //GNILK_JSONINDEX_H
@@ -14,6 +14,7 @@
 //
 
 #include <string.h>
+#include <ctype.h>
 #include "StringReader.h"
 #include "JSONParser.h"
 
@@ -39,10 +40,6 @@ void Error(const char *fmt, Args... args) {
 }
 
 
-#ifndef GNILK_JSON_MAX_DEPTH
-#define GNILK_JSON_MAX_DEPTH 255
-#endif
-
 using namespace gnilk;
 
 JSONParser::JSONParser(IReader::Ref stream) : inStream(stream) {
@@ -69,6 +66,21 @@ std::unique_ptr<JSONDoc> JSONParser::GetDocument() {
     return std::move(document);
 }
 
+const JSONDoc *JSONParser::Reparse(IReader::Ref stream) {
+    inStream = stream;
+    lookAhead = -1;
+    Reset();
+    if (document == nullptr) {
+        document = std::make_unique<JSONDoc>();
+    } else {
+        document->Clear();
+    }
+    if (CheckLimits(ProcessDataInternal()) != kResult::Ok) {
+        return nullptr;
+    }
+    return document.get();
+}
+
 // static
 std::unique_ptr<JSONDoc> JSONParser::Load(const std::string &data) {
     JSONParser parser(data);
@@ -81,13 +93,182 @@ std::unique_ptr<JSONDoc> JSONParser::Load(IReader::Ref stream) {
     return parser.GetDocument();
 }
 
+// static
+std::unique_ptr<JSONDoc> JSONParser::Load(const std::string &data, const ParseLimits &limits) {
+    // Known up front, don't even start
+    if (data.size() > limits.maxBytes) {
+        return {};
+    }
+    JSONParser parser(data);
+    parser.SetLimits(limits);
+    return parser.GetDocument();
+}
+
+// static
+std::unique_ptr<JSONDoc> JSONParser::Load(IReader::Ref stream, const ParseLimits &limits) {
+    JSONParser parser(stream);
+    parser.SetLimits(limits);
+    return parser.GetDocument();
+}
+
+// static
+std::unique_ptr<JSONDoc> JSONParser::LoadValue(IReader::Ref stream, const ParseLimits &limits) {
+    JSONParser parser(stream);
+    parser.SetLimits(limits);
+    parser.isSingleValue = true;
+    return parser.GetDocument();
+}
+
+
+// static
+std::unique_ptr<JSONDoc> JSONParser::LoadLazy(const std::string &data) {
+    auto document = std::make_unique<JSONDoc>();
+    document->lazy = std::make_unique<JSONLazyIndex>(*document, data);
+    auto &lazy = *document->lazy;
+    if (!lazy.Build()) {
+        return {};
+    }
+    size_t pos = 0;
+    uint32_t idxContainer = 0;
+    JSONValue rootValue;
+    if (!lazy.ParseValue(pos, {}, idxContainer, rootValue)) {
+        return {};
+    }
+    if (rootValue.IsObject()) {
+        document->root = rootValue.GetAsObject();
+    } else if (rootValue.IsArray()) {
+        document->root = rootValue.GetAsArray();
+    } else {
+        return {};
+    }
+    document->rootValue = rootValue;
+    return document;
+}
+
+//
+// Array streaming, the items are parsed one by one into the same document which is cleared in between
+//
+JSONParser::kResult JSONParser::BeginArrayStream(const std::string &name) {
+    Reset();
+    document = std::make_unique<JSONDoc>();
+    isStreamFirstItem = true;
+    isStreamEnd = true;
+
+    int ch;
+    if ((ch = SkipWhiteSpace()) < 0) {
+        return CheckLimits(kResult::ErrUnexpectedEOF);
+    }
+    if (ch == '[') {
+        streamLabel = {};
+        isStreamEnd = false;
+        return kResult::Ok;
+    }
+    if (ch != '{') {
+        return kResult::ErrUnexpectedToken;
+    }
+
+    // Skip members of the root object until we find the array
+    kResult procRes;
+    while(true) {
+        if ((ch = SkipWhiteSpace()) < 0) {
+            return CheckLimits(kResult::ErrUnexpectedEOF);
+        }
+        if (ch == '}') {
+            return kResult::ErrKeyMissing;
+        }
+        if (ch != '\"') {
+            return kResult::ErrKeyMissing;
+        }
+        if ((procRes = ProcessString()) != kResult::Ok) {
+            return CheckLimits(procRes);
+        }
+        std::string label = valueCurrent;
+        if ((ch = SkipWhiteSpace()) < 0) {
+            return CheckLimits(kResult::ErrUnexpectedEOF);
+        }
+        if (ch != ':') {
+            return kResult::ErrSeparatorMissing;
+        }
+        if ((ch = SkipWhiteSpace()) < 0) {
+            return CheckLimits(kResult::ErrUnexpectedEOF);
+        }
+        if ((ch == '[') && (label == name)) {
+            streamLabel = label;
+            isStreamEnd = false;
+            return kResult::Ok;
+        }
+        if ((procRes = SkipValue(ch)) != kResult::Ok) {
+            return CheckLimits(procRes);
+        }
+        if ((ch = SkipWhiteSpace()) < 0) {
+            return CheckLimits(kResult::ErrUnexpectedEOF);
+        }
+        if (ch == '}') {
+            return kResult::ErrKeyMissing;
+        }
+        if (ch != ',') {
+            return kResult::ErrUnexpectedToken;
+        }
+    }
+}
+
+JSONParser::kResult JSONParser::NextArrayStreamItem(JSONValue::Ref &outItem) {
+    outItem = {};
+    if (isStreamEnd) {
+        return kResult::Ok;
+    }
+    // Release the previous item
+    document->Clear();
+    pendingItems.clear();
+    pendingMembers.clear();
 
+    int ch;
+    if ((ch = SkipWhiteSpace()) < 0) {
+        isStreamEnd = true;
+        return CheckLimits(kResult::ErrUnexpectedEOF);
+    }
+    if (ch == ']') {
+        isStreamEnd = true;
+        return kResult::Ok;
+    }
+    if (!isStreamFirstItem) {
+        if (ch != ',') {
+            isStreamEnd = true;
+            return kResult::ErrUnexpectedToken;
+        }
+        if ((ch = SkipWhiteSpace()) < 0) {
+            isStreamEnd = true;
+            return CheckLimits(kResult::ErrUnexpectedEOF);
+        }
+    }
+    isStreamFirstItem = false;
+
+    // Items are named after the array - like the regular parser
+    kResult procRes;
+    if ((procRes = ProcessValue(ch, streamLabel, streamItem, 1)) != kResult::Ok) {
+        isStreamEnd = true;
+        return CheckLimits(procRes);
+    }
+    outItem = JSONValue::Ref(&streamItem);
+    return kResult::Ok;
+}
 
 // Process data
 JSONParser::kResult JSONParser::ProcessData() {
     Reset();
     document = std::make_unique<JSONDoc>();
-    return ProcessDataInternal();
+    return CheckLimits(ProcessDataInternal());
+}
+
+// Any error after a limit was hit is because of the limit
+JSONParser::kResult JSONParser::CheckLimits(kResult result) {
+    if (!guard.IsExceeded()) {
+        return result;
+    }
+    if (guard.GetExceeded() == ParseLimits::kLimit::kDepth) {
+        return kResult::ErrMaxDepth;
+    }
+    return kResult::ErrLimitExceeded;
 }
 
 // Private/Protected functionality below this point
@@ -96,7 +277,10 @@ JSONParser::kResult JSONParser::ProcessData() {
 // Reset decoder internal values - currently not much, was more convoluted when decoder was iterative...
 //
 void JSONParser::Reset() {
+    guard.Reset();
     ResetCurrentValue();
+    pendingItems.clear();
+    pendingMembers.clear();
 }
 
 //
@@ -106,6 +290,9 @@ void JSONParser::Reset() {
 JSONParser::kResult JSONParser::ProcessDataInternal() {
     std::string emptyLabel = {};
     idxParser = 0;
+    if (isSingleValue) {
+        return ProcessSingleValue();
+    }
     int ch;
     kResult procRes = kResult::Ok;
     while((ch = Next()) > 0) {
@@ -117,20 +304,45 @@ JSONParser::kResult JSONParser::ProcessDataInternal() {
             if ((procRes = ProcessObject(obj, 0)) != kResult::Ok) {
                 return procRes;
             }
-            document->root = {obj};
+            document->root = JSONObject::Ref(obj);
+            document->rootValue = JSONValue::Create(obj);
         } else if (ch == '[') {
             auto array = CreateJSONArray({});
             if ((procRes = ProcessArray(array,emptyLabel, 0)) != kResult::Ok) {
                 return procRes;
             }
-            document->root = {array};
+            document->root = JSONArray::Ref(array);
+            document->rootValue = JSONValue::Create(array);
         } else  {
             // any other root object??
+            continue;
         }
     }
     return kResult::Ok;
 }
 
+//
+// Exactly the value at the current position, scalars included - nothing after it is read
+//
+JSONParser::kResult JSONParser::ProcessSingleValue() {
+    int ch;
+    if ((ch = SkipWhiteSpace()) < 0) {
+        return kResult::ErrUnexpectedEOF;
+    }
+    JSONValue value;
+    kResult procRes;
+    if ((procRes = ProcessValue(ch, {}, value, 0)) != kResult::Ok) {
+        return procRes;
+    }
+    if (value.IsObject()) {
+        document->root = value.GetAsObject();
+    } else if (value.IsArray()) {
+        document->root = value.GetAsArray();
+    }
+    document->rootValue = value;
+    return kResult::Ok;
+}
+
 int JSONParser::SkipWhiteSpace() {
     int ch;
     while((ch = Next()) > 0) {
@@ -144,7 +356,7 @@ int JSONParser::SkipWhiteSpace() {
 //
 // Process object
 //
-JSONParser::kResult JSONParser::ProcessObject(JSONObject::Ref &currentObject, size_t depth) {
+JSONParser::kResult JSONParser::ProcessObject(JSONObject *currentObject, size_t depth) {
     int ch;
     if ((ch = SkipWhiteSpace()) < 0) {
         return kResult::ErrUnexpectedEOF;
@@ -158,6 +370,9 @@ JSONParser::kResult JSONParser::ProcessObject(JSONObject::Ref &currentObject, si
 
     std::string label = {};
     kResult procRes = {};
+    JSONValue value;
+    // Members are collected like array items, nested objects push above ours
+    auto idxFirstMember = pendingMembers.size();
     do {
         if ((procRes = ProcessString()) != kResult::Ok) {
             return procRes;
@@ -172,9 +387,13 @@ JSONParser::kResult JSONParser::ProcessObject(JSONObject::Ref &currentObject, si
             //Error("ProcessObject, Missing separator after label");
             return kResult::ErrSeparatorMissing;
         }
-        if ((procRes = ProcessValue(Next(), label, currentObject, depth)) != kResult::Ok) {
+        if ((procRes = ProcessValue(Next(), label, value, depth)) != kResult::Ok) {
             return procRes;
         }
+        pendingMembers.push_back({document->StoreString(label), value});
+        if (!guard.CheckMembers(pendingMembers.size() - idxFirstMember)) {
+            return kResult::ErrLimitExceeded;
+        }
 
         // FIXME: OnValue()
         if ((ch = SkipWhiteSpace()) < 0) {
@@ -200,14 +419,16 @@ JSONParser::kResult JSONParser::ProcessObject(JSONObject::Ref &currentObject, si
         }
     } while(true);
 
+    currentObject->members = document->StoreRange(std::span<const JSONObject::Member>(pendingMembers).subspan(idxFirstMember));
+    pendingMembers.resize(idxFirstMember);
     return kResult::Ok;
 }
 
 //
 // Process array
 //
-JSONParser::kResult JSONParser::ProcessArray(JSONArray::Ref &currentObject, const std::string &label, size_t depth) {
-    if (depth > GNILK_JSON_MAX_DEPTH) {
+JSONParser::kResult JSONParser::ProcessArray(JSONArray *currentObject, const std::string &label, size_t depth) {
+    if (!guard.CheckDepth(depth)) {
         //Error("Max Recursion Depth %zu exceeded", depth);
         return kResult::ErrMaxDepth;
     }
@@ -222,14 +443,23 @@ JSONParser::kResult JSONParser::ProcessArray(JSONArray::Ref &currentObject, cons
         return kResult::Ok;
     }
 
-    // Mark the current object as we are 'in an array...
+    // Items are collected on the pending stack, nested arrays push above ours and are gone when they complete
+    auto idxFirstItem = pendingItems.size();
     kResult procRes;
-    while((procRes = ProcessValue(ch, label, currentObject, depth+1)) == kResult::Ok) {
+    JSONValue value;
+    while((procRes = ProcessValue(ch, label, value, depth+1)) == kResult::Ok) {
+        pendingItems.push_back(value);
+        if (!guard.CheckArrayLength(pendingItems.size() - idxFirstItem)) {
+            return kResult::ErrLimitExceeded;
+        }
         if ((ch = SkipWhiteSpace()) < 0) {
             return kResult::ErrUnexpectedEOF;
         }
         if (ch == ']') {
             // Debug("ProcessArray, end of array");
+            // Move the items to one contiguous range in the document
+            currentObject->values = document->StoreRange(std::span<const JSONValue>(pendingItems).subspan(idxFirstItem));
+            pendingItems.resize(idxFirstItem);
             return kResult::Ok;
         }
 
@@ -264,19 +494,31 @@ JSONParser::kResult JSONParser::ProcessString() {
             return kResult::ErrUnexpectedToken;
         }
 
-        // FIXME: Handle escape values
+        // FIXME: Handle escape values, for now they are kept as is - but an escaped quote doesn't end the string
         AppendToValue(ch);
+        if (ch == '\\') {
+            if ((ch = Next()) < 0) {
+                break;
+            }
+            AppendToValue(ch);
+        }
+        if (!guard.CheckStringLength(valueCurrent.size())) {
+            return kResult::ErrLimitExceeded;
+        }
     }
     return kResult::ErrUnexpectedEOF;
 }
 
 // Process a value
-JSONParser::kResult JSONParser::ProcessValue(int ch, const std::string &label, JSONCoreObject::Ref parent, size_t depth) {
-    if (depth > GNILK_JSON_MAX_DEPTH) {
+JSONParser::kResult JSONParser::ProcessValue(int ch, const std::string &label, JSONValue &outValue, size_t depth) {
+    if (!guard.CheckDepth(depth)) {
         //Error("Max Recursion Depth %zu exceeded", depth);
         return kResult::ErrMaxDepth;
     }
 
+    if (!guard.OnStep()) {
+        return kResult::ErrLimitExceeded;
+    }
     if (std::isspace(ch)) {
         if ((ch = SkipWhiteSpace()) < 0) {
             return kResult::ErrUnexpectedEOF;
@@ -292,8 +534,7 @@ JSONParser::kResult JSONParser::ProcessValue(int ch, const std::string &label, J
             if ((procRes = ProcessString()) != kResult::Ok) {
                 return procRes;
             }
-            OnValue(parent, label);
-            // OnValue(currentObject, label);
+            outValue = OnValue(JSONValue::kScalar::kText);
             break;
         case '{' :
             {
@@ -303,7 +544,7 @@ JSONParser::kResult JSONParser::ProcessValue(int ch, const std::string &label, J
                     return procRes;
                 }
 
-                parent->AddValue(label, JSONValue::Create(newObject));
+                outValue = JSONValue::Create(newObject);
             }
             break;
         case '[' : {
@@ -313,7 +554,7 @@ JSONParser::kResult JSONParser::ProcessValue(int ch, const std::string &label, J
                     return procRes;
                 }
 
-                parent->AddValue(label, JSONValue::Create(newArray));
+                outValue = JSONValue::Create(newArray);
 
             }
             break;
@@ -321,19 +562,19 @@ JSONParser::kResult JSONParser::ProcessValue(int ch, const std::string &label, J
             if ((procRes = ProcessExpected(ch, "true")) != kResult::Ok) {
                 return procRes;
             }
-            OnValue(parent,label);
+            outValue = OnValue(JSONValue::kScalar::kBool);
             break;
         case 'f' :
             if ((procRes = ProcessExpected(ch, "false")) != kResult::Ok) {
                 return procRes;
             }
-            OnValue(parent,label);
+            outValue = OnValue(JSONValue::kScalar::kBool);
             break;
         case 'n' :
             if ((procRes = ProcessExpected(ch, "null")) != kResult::Ok) {
                 return procRes;
             }
-            OnValue(parent,label);
+            outValue = OnValue(JSONValue::kScalar::kNull);
             break;
         default : {
                 if (!IsValidNumberStart(ch)) {
@@ -343,7 +584,7 @@ JSONParser::kResult JSONParser::ProcessValue(int ch, const std::string &label, J
                 if ((procRes = ProcessNumber(ch)) != kResult::Ok) {
                     return procRes;
                 }
-                OnValue(parent, label);
+                outValue = OnValue(JSONValue::kScalar::kNumber);
             }
             break;
     }
@@ -367,10 +608,17 @@ JSONParser::kResult JSONParser::ProcessNumber(int ch) {
     // FIXME: This needs a more elaborate state machine...
     do {
         AppendToValue(ch);
+        if (!guard.CheckStringLength(valueCurrent.size())) {
+            return kResult::ErrLimitExceeded;
+        }
 
         if ((ch = Peek()) < -1) {
             return kResult::ErrUnexpectedEOF;
         }
+        // End of stream ends a number (a single value), the callers deal with missing brackets
+        if (ch < 0) {
+            break;
+        }
         // End of number - perhaps a better detection is good
         if (ch == ',') {
             break;
@@ -434,6 +682,40 @@ JSONParser::kResult JSONParser::ProcessExpected(int ch, const char *expected) {
 
 }
 
+//
+// Consumes a value without storing anything, 'ch' is the first char of the value
+//
+JSONParser::kResult JSONParser::SkipValue(int ch) {
+    size_t depth = 0;
+    bool isString = false;
+    do {
+        if (isString) {
+            if (ch == '\\') {
+                Next();
+            } else if (ch == '\"') {
+                isString = false;
+            }
+        } else if (ch == '\"') {
+            isString = true;
+        } else if ((ch == '{') || (ch == '[')) {
+            depth++;
+        } else if ((ch == '}') || (ch == ']')) {
+            if (depth == 0) {
+                return kResult::ErrUnexpectedToken;
+            }
+            depth--;
+        }
+        // scalar (or complete container) - stop before the separator
+        if (!isString && (depth == 0)) {
+            auto chNext = Peek();
+            if ((chNext < 0) || (chNext == ',') || (chNext == '}') || (chNext == ']') || std::isspace(chNext)) {
+                return kResult::Ok;
+            }
+        }
+    } while((ch = Next()) >= 0);
+    return kResult::ErrUnexpectedEOF;
+}
+
 // Resets the current work-value
 void JSONParser::ResetCurrentValue() {
     valueCurrent = {};
@@ -446,24 +728,28 @@ void JSONParser::AppendToValue(int ch) {
 }
 
 // Private
-JSONObject::Ref JSONParser::CreateJSONObject(const std::string &name) {
-    return std::make_shared<JSONObject>(name);
+JSONObject *JSONParser::CreateJSONObject(const std::string &name) {
+    return document->NewObject(name);
 }
 
-JSONArray::Ref JSONParser::CreateJSONArray(const std::string &name) {
-    return std::make_shared<JSONArray>(name);
+JSONArray *JSONParser::CreateJSONArray(const std::string &name) {
+    return document->NewArray(name);
 }
 
-void JSONParser::OnValue(JSONCoreObject::Ref currentObject, const std::string &label) {
+JSONValue JSONParser::OnValue(JSONValue::kScalar scalarType) {
 //    if (cbValue != nullptr) {
 //        cbValue(currentObject->label, label.c_str(), valueCurrent);
 //    }
 
-//    auto newValue = JSONValue();
-//    newValue.value = valueCurrent;
-    currentObject->AddValue(label, JSONValue::Create(valueCurrent));
+    // Short values are stored inline, the rest goes to the document arena
+    std::string_view str = valueCurrent;
+    if (str.size() > JSONValue::kMaxInline) {
+        str = document->StoreString(str);
+    }
+    auto value = JSONValue::Create(str, scalarType);
 
     ResetCurrentValue();
+    return value;
 }
 
 //
@@ -508,6 +794,10 @@ int JSONParser::ReadNext() {
         return -1;
     }
 
+    // Reading past the limit looks like end of stream to the parser, the result is fixed up in 'CheckLimits'
+    if (!guard.OnBytes(1)) {
+        return -1;
+    }
     idxParser++;
     return ch;
 }
@@ -520,6 +810,7 @@ const std::string &JSONParser::ErrToString(JSONParser::kResult err) {
             {kResult::ErrUnexpectedToken, "Unexpected token"},
             {kResult::ErrKeyMissing, "Key missing"},
             {kResult::ErrSeparatorMissing, "Separator missing"},
+            {kResult::ErrLimitExceeded, "Parse limit exceeded"},
     };
     static std::string unkErr = "Unknown error";
     if (!errToStr.contains(err)) {
@@ -527,3 +818,210 @@ const std::string &JSONParser::ErrToString(JSONParser::kResult err) {
     }
     return errToStr[err];
 }
+
+
+//
+// Lazy documents
+//
+void JSONObject::Expand() const {
+    lazy->Expand(*this);
+}
+
+void JSONArray::Expand() const {
+    lazy->Expand(*this);
+}
+
+static bool IsJSONWhiteSpace(char ch) {
+    return (ch == ' ') || (ch == '\t') || (ch == '\n') || (ch == '\r');
+}
+
+static void SkipWhiteSpace(const std::string &text, size_t &pos) {
+    while((pos < text.size()) && IsJSONWhiteSpace(text[pos])) {
+        pos++;
+    }
+}
+
+// 'pos' is on the opening quote, returns the position of the closing quote or npos
+static size_t FindEndOfString(const std::string &text, size_t pos) {
+    for(pos = pos + 1; pos < text.size(); pos++) {
+        if (text[pos] == '\\') {
+            pos++;
+        } else if (text[pos] == '\"') {
+            return pos;
+        }
+    }
+    return std::string::npos;
+}
+
+// One pass - match all brackets, skipping strings
+bool JSONLazyIndex::Build() {
+    std::vector<uint32_t> open;
+    for(size_t pos = 0; pos < text.size(); pos++) {
+        auto ch = text[pos];
+        if (ch == '\"') {
+            pos = FindEndOfString(text, pos);
+            if (pos == std::string::npos) {
+                return false;
+            }
+        } else if ((ch == '{') || (ch == '[')) {
+            open.push_back(static_cast<uint32_t>(containers.size()));
+            containers.push_back({pos, 0, 0});
+        } else if ((ch == '}') || (ch == ']')) {
+            if (open.empty()) {
+                return false;
+            }
+            auto &container = containers[open.back()];
+            if (text[container.begin] != ((ch == '}') ? '{' : '[')) {
+                return false;
+            }
+            container.end = pos;
+            container.idxNextSibling = static_cast<uint32_t>(containers.size());
+            open.pop_back();
+            // Only the first root value is used
+            if (open.empty()) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+bool JSONLazyIndex::ParseValue(size_t &pos, const std::string &label, uint32_t &idxNextContainer, JSONValue &outValue) {
+    SkipWhiteSpace(text, pos);
+    if (pos >= text.size()) {
+        return false;
+    }
+    auto ch = text[pos];
+    if ((ch == '{') || (ch == '[')) {
+        if ((idxNextContainer >= containers.size()) || (containers[idxNextContainer].begin != pos)) {
+            return false;
+        }
+        if (ch == '{') {
+            auto object = doc.NewObject(label);
+            object->lazy = this;
+            object->lazyContainer = idxNextContainer;
+            object->expanded = false;
+            outValue = JSONValue::Create(object);
+        } else {
+            auto array = doc.NewArray(label);
+            array->lazy = this;
+            array->lazyContainer = idxNextContainer;
+            array->expanded = false;
+            outValue = JSONValue::Create(array);
+        }
+        pos = containers[idxNextContainer].end + 1;
+        idxNextContainer = containers[idxNextContainer].idxNextSibling;
+        return true;
+    }
+
+    // Scalars point into the text (unless they fit in the value)
+    std::string_view view(text);
+    if (ch == '\"') {
+        auto end = FindEndOfString(text, pos);
+        if (end == std::string::npos) {
+            return false;
+        }
+        outValue = JSONValue::Create(view.substr(pos + 1, end - pos - 1), JSONValue::kScalar::kText);
+        pos = end + 1;
+        return true;
+    }
+    auto end = pos;
+    while((end < text.size()) && !IsJSONWhiteSpace(text[end]) && (text[end] != ',') && (text[end] != '}') && (text[end] != ']')) {
+        end++;
+    }
+    auto token = view.substr(pos, end - pos);
+    if ((token == "true") || (token == "false")) {
+        outValue = JSONValue::Create(token, JSONValue::kScalar::kBool);
+    } else if (token == "null") {
+        outValue = JSONValue::Create(token, JSONValue::kScalar::kNull);
+    } else if ((ch == '-') || std::isdigit(static_cast<unsigned char>(ch))) {
+        outValue = JSONValue::Create(token, JSONValue::kScalar::kNumber);
+    } else {
+        return false;
+    }
+    pos = end;
+    return true;
+}
+
+void JSONLazyIndex::Expand(const JSONObject &object) {
+    std::lock_guard<std::mutex> guard(lock);
+    if (object.expanded.load(std::memory_order_relaxed)) {
+        return;
+    }
+    auto &container = containers[object.lazyContainer];
+    auto pos = container.begin + 1;
+    auto idxNextContainer = object.lazyContainer + 1;
+    std::vector<JSONObject::Member> members;
+    std::string_view view(text);
+    SkipWhiteSpace(text, pos);
+    bool afterComma = false;
+    while(pos < container.end) {
+        afterComma = false;
+        if (text[pos] != '\"') {
+            break;
+        }
+        auto end = FindEndOfString(text, pos);
+        if ((end == std::string::npos) || (end >= container.end)) {
+            break;
+        }
+        auto name = view.substr(pos + 1, end - pos - 1);
+        pos = end + 1;
+        SkipWhiteSpace(text, pos);
+        if ((pos >= container.end) || (text[pos] != ':')) {
+            break;
+        }
+        pos++;
+        JSONValue value;
+        if (!ParseValue(pos, std::string(name), idxNextContainer, value)) {
+            break;
+        }
+        members.push_back({name, value});
+        SkipWhiteSpace(text, pos);
+        if ((pos >= container.end) || (text[pos] != ',')) {
+            break;
+        }
+        pos++;
+        SkipWhiteSpace(text, pos);
+        afterComma = true;
+    }
+    // Anything but a clean stop on the closing bracket is a syntax error, the members up to it are kept
+    if ((pos != container.end) || afterComma) {
+        failed.store(true, std::memory_order_relaxed);
+    }
+    object.members = doc.StoreRange(std::span<const JSONObject::Member>(members));
+    object.expanded.store(true, std::memory_order_release);
+}
+
+void JSONLazyIndex::Expand(const JSONArray &array) {
+    std::lock_guard<std::mutex> guard(lock);
+    if (array.expanded.load(std::memory_order_relaxed)) {
+        return;
+    }
+    auto &container = containers[array.lazyContainer];
+    auto pos = container.begin + 1;
+    auto idxNextContainer = array.lazyContainer + 1;
+    std::vector<JSONValue> items;
+    SkipWhiteSpace(text, pos);
+    bool afterComma = false;
+    while(pos < container.end) {
+        afterComma = false;
+        JSONValue value;
+        // items are named after the array - like the regular parser
+        if (!ParseValue(pos, array.name, idxNextContainer, value)) {
+            break;
+        }
+        items.push_back(value);
+        SkipWhiteSpace(text, pos);
+        if ((pos >= container.end) || (text[pos] != ',')) {
+            break;
+        }
+        pos++;
+        SkipWhiteSpace(text, pos);
+        afterComma = true;
+    }
+    if ((pos != container.end) || afterComma) {
+        failed.store(true, std::memory_order_relaxed);
+    }
+    array.values = doc.StoreRange(std::span<const JSONValue>(items));
+    array.expanded.store(true, std::memory_order_release);
+}
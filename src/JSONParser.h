@@ -13,74 +13,294 @@
 #include <optional>
 #include <memory>
 #include <variant>
-
+#include <deque>
+#include <span>
+#include <string_view>
+#include <unordered_map>
+#include <atomic>
+#include <mutex>
+#include <string.h>
+
+#include "Arena.h"
 #include "IReader.h"
-#include "JSONParser.h"
+#include "ParseLimits.h"
+#include "PerfectHash.h"
 
 
 namespace gnilk {
     class JSONValue;
-    using JSONValueRef = std::shared_ptr<JSONValue>;
+    class JSONObject;
+    class JSONArray;
+    class JSONDoc;
+    class JSONParser;
+    class JSONLazyIndex;
 
-    class JSONCoreObject {
-    public:
-        using Ref = std::shared_ptr<JSONCoreObject>;
+    // Non-owning handle to a node, all nodes are owned by the JSONDoc they belong to and live as long as it does
+    template<typename T>
+    class JSONNodeRef {
     public:
-        virtual ~JSONCoreObject() = default;
+        JSONNodeRef() = default;
+        JSONNodeRef(std::nullptr_t) {}
+        explicit JSONNodeRef(T *ptrNode) : node(ptrNode) {}
 
-        virtual void AddValue(const std::string &label, const JSONValueRef &value) = 0;
+        T *operator->() const { return node; }
+        T &operator*() const { return *node; }
+        T *get() const { return node; }
+
+        explicit operator bool() const { return node != nullptr; }
+        bool operator==(const JSONNodeRef &other) const { return node == other.node; }
+        bool operator==(std::nullptr_t) const { return node == nullptr; }
+    private:
+        T *node = nullptr;
     };
 
-    class JSONObject : public JSONCoreObject {
+    using JSONValueRef = JSONNodeRef<const JSONValue>;
+
+    //
+    // A value is 16 bytes and held by value in objects and arrays.
+    // Scalars of up to 14 chars are stored inline, longer ones point into the document arena.
+    //
+    class JSONValue {
     public:
-        using Ref = std::shared_ptr<JSONObject>;
+        using Ref = JSONValueRef;
+        // All scalars are stored as strings, this is what they were in the document
+        enum class kScalar : uint8_t {
+            kText,
+            kNumber,
+            kBool,
+            kNull,
+        };
+        static constexpr size_t kMaxInline = 14;
     public:
-        JSONObject() = default;
-        explicit JSONObject(const std::string &objName) : name(objName) {
+        JSONValue() = default;
+
+        // 'data' is copied when it fits inline, otherwise it must outlive the value (i.e. be stored in the document)
+        static JSONValue Create(std::string_view data, kScalar scalarType = kScalar::kText) {
+            JSONValue value;
+            value.tag = static_cast<kTag>(scalarType);
+            if (data.size() <= kMaxInline) {
+                memcpy(value.storage, data.data(), data.size());
+                value.inlineLen = static_cast<uint8_t>(data.size());
+            } else {
+                auto ptr = data.data();
+                auto len = static_cast<uint32_t>(data.size());
+                memcpy(value.storage, &ptr, sizeof(ptr));
+                memcpy(value.storage + sizeof(ptr), &len, sizeof(len));
+                value.inlineLen = kNotInline;
+            }
+            return value;
+        }
+        static JSONValue Create(const JSONObject *object) {
+            JSONValue value;
+            value.tag = kTag::kObject;
+            memcpy(value.storage, &object, sizeof(object));
+            return value;
+        }
+        static JSONValue Create(const JSONArray *array) {
+            JSONValue value;
+            value.tag = kTag::kArray;
+            memcpy(value.storage, &array, sizeof(array));
+            return value;
+        }
 
+        bool IsObject() const {
+            return tag == kTag::kObject;
+        }
+        bool IsArray() const {
+            return tag == kTag::kArray;
+        }
+        bool IsString() const {
+            return tag < kTag::kObject;
+        }
+        // Only valid if 'IsString' is true
+        kScalar GetScalarType() const {
+            return IsString() ? static_cast<kScalar>(tag) : kScalar::kText;
+        }
+
+        const JSONNodeRef<const JSONObject> GetAsObject() const {
+            if (!IsObject()) {
+                return {};
+            }
+            return JSONNodeRef<const JSONObject>(LoadPointer<const JSONObject>());
+        }
+        const JSONNodeRef<const JSONArray> GetAsArray() const {
+            if (!IsArray()) {
+                return {};
+            }
+            return JSONNodeRef<const JSONArray>(LoadPointer<const JSONArray>());
+        }
+        // Returns a view into the value (or document), valid as long as the document
+        const std::string_view GetAsString() const {
+            if (!IsString()) {
+                return {};
+            }
+            if (inlineLen != kNotInline) {
+                return {storage, inlineLen};
+            }
+            uint32_t len = 0;
+            memcpy(&len, storage + sizeof(const char *), sizeof(len));
+            return {LoadPointer<const char>(), static_cast<size_t>(len)};
         }
-        virtual ~JSONObject() = default;
 
-        static JSONObject::Ref Create(const std::string &objName = {}) {
-            return std::make_shared<JSONObject>(objName);
+    protected:
+        // scalars first, kept in the same order as kScalar
+        enum class kTag : uint8_t {
+            kText,
+            kNumber,
+            kBool,
+            kNull,
+            kObject,
+            kArray,
+        };
+        static constexpr uint8_t kNotInline = 0xff;
+
+        template<typename T>
+        T *LoadPointer() const {
+            T *ptr = nullptr;
+            memcpy(&ptr, storage, sizeof(ptr));
+            return ptr;
         }
+    protected:
+        // inline string, pointer + 32 bit length or pointer to object/array
+        char storage[kMaxInline] = {};
+        uint8_t inlineLen = 0;
+        kTag tag = kTag::kNull;
+    };
+    static_assert(sizeof(JSONValue) == 16, "JSONValue must be 16 bytes");
+    static_assert(std::is_trivially_copyable_v<JSONValue>, "JSONValue must be trivially copyable");
+
+    //
+    // Members are kept in document order as one contiguous range in the document arena.
+    // Small objects are searched linearly, larger ones get a hash index on first lookup.
+    // Duplicate keys are all kept (and iterated), lookup returns the last one.
+    //
+    class JSONObject {
+        friend JSONParser;
+        friend JSONLazyIndex;
+    public:
+        using Ref = JSONNodeRef<const JSONObject>;
+        struct Member {
+            std::string_view name;
+            JSONValue value;
+        };
+        // Objects with more members than this get an index
+        static constexpr size_t kIndexThreshold = 8;
+    public:
+        JSONObject() = default;
+        explicit JSONObject(const std::string &objName) : name(objName) {
 
-        void AddValue(const std::string &label, const JSONValueRef &value) override {
-            values[label] = value;
+        }
+        virtual ~JSONObject() {
+            delete[] index.load(std::memory_order_relaxed);
         }
 
         bool IsEmpty() const {
-            return values.empty();
+            EnsureExpanded();
+            return members.empty();
+        }
+
+        size_t Size() const {
+            EnsureExpanded();
+            return members.size();
         }
 
         const std::string &GetName() const {
             return name;
         }
 
-        bool HasValue(const std::string &valueName) const {
-            return values.contains(valueName);
+        bool HasValue(std::string_view valueName) const {
+            return FindMember(valueName) >= 0;
         }
 
-        const JSONValueRef GetValue(const std::string &valueName) const {
-            if (!values.contains(valueName)) {
+        const JSONValue::Ref GetValue(std::string_view valueName) const {
+            auto idx = FindMember(valueName);
+            if (idx < 0) {
                 return {};
             }
-            return values.at(valueName);
+            return JSONValue::Ref(&members[idx].value);
         }
         [[nodiscard]]
-        const std::unordered_map<std::string, JSONValueRef> &GetValues() const {
-            return values;
+        std::span<const Member> GetValues() const {
+            EnsureExpanded();
+            return members;
+        }
+
+    protected:
+        // Objects of lazily loaded documents are parsed on first access
+        void EnsureExpanded() const {
+            if ((lazy != nullptr) && !expanded.load(std::memory_order_acquire)) {
+                Expand();
+            }
+        }
+        void Expand() const;
+
+        int FindMember(std::string_view valueName) const {
+            EnsureExpanded();
+            if (members.size() <= kIndexThreshold) {
+                for(size_t i=members.size();i>0;i--) {
+                    if (members[i-1].name == valueName) {
+                        return static_cast<int>(i-1);
+                    }
+                }
+                return -1;
+            }
+            auto slots = GetIndex();
+            auto mask = IndexCapacity() - 1;
+            for(auto pos = hash_fnv1a(valueName) & mask;slots[pos] != 0;pos = (pos + 1) & mask) {
+                if (members[slots[pos] - 1].name == valueName) {
+                    return static_cast<int>(slots[pos] - 1);
+                }
+            }
+            return -1;
+        }
+
+        size_t IndexCapacity() const {
+            size_t capacity = 1;
+            while(capacity < members.size() * 2) capacity <<= 1;
+            return capacity;
         }
 
+        // Open addressing, linear probing - slots hold member index + 1, 0 is free
+        // Built on first use, racing builders are fine - the first one to publish wins
+        const uint32_t *GetIndex() const {
+            auto current = index.load(std::memory_order_acquire);
+            if (current != nullptr) {
+                return current;
+            }
+            auto capacity = IndexCapacity();
+            auto mask = capacity - 1;
+            auto slots = new uint32_t[capacity]();
+            for(size_t i=0;i<members.size();i++) {
+                auto pos = hash_fnv1a(members[i].name) & mask;
+                while((slots[pos] != 0) && (members[slots[pos] - 1].name != members[i].name)) {
+                    pos = (pos + 1) & mask;
+                }
+                // later duplicates replace earlier ones
+                slots[pos] = static_cast<uint32_t>(i + 1);
+            }
+            if (!index.compare_exchange_strong(current, slots, std::memory_order_acq_rel)) {
+                delete[] slots;
+                return current;
+            }
+            return slots;
+        }
 
     protected:
         std::string name;
-        std::unordered_map<std::string, JSONValueRef> values;
+        mutable std::span<const Member> members = {};
+        mutable std::atomic<uint32_t *> index = nullptr;
+
+        JSONLazyIndex *lazy = nullptr;
+        uint32_t lazyContainer = 0;
+        mutable std::atomic<bool> expanded = true;
     };
 
-    class JSONArray : public JSONCoreObject {
+    // Array items are stored as one contiguous range of values in the document arena
+    class JSONArray {
+        friend JSONParser;
+        friend JSONLazyIndex;
     public:
-        using Ref = std::shared_ptr<JSONArray>;
+        using Ref = JSONNodeRef<const JSONArray>;
     public:
         JSONArray() = default;
         explicit JSONArray(const std::string &arrayName) : name(arrayName) {
@@ -88,22 +308,17 @@ namespace gnilk {
         }
         virtual ~JSONArray() = default;
 
-        static JSONArray::Ref Create(const std::string &arrayName = {}) {
-            return std::make_shared<JSONArray>(arrayName);
-        }
-
-        void AddValue(const std::string &label, const JSONValueRef &value) override {
-            values.push_back(value);
-        }
-
         bool IsEmpty() const {
+            EnsureExpanded();
             return values.empty();
         }
 
         size_t Size() const {
+            EnsureExpanded();
             return values.size();
         }
-        const std::vector<JSONValueRef> &GetValues() const {
+        std::span<const JSONValue> GetValues() const {
+            EnsureExpanded();
             return values;
         }
 
@@ -111,112 +326,141 @@ namespace gnilk {
             return name;
         }
 
-        const JSONValueRef At(size_t idx) const {
+        const JSONValue::Ref At(size_t idx) const {
+            EnsureExpanded();
             if (idx >= values.size()) {
                 return {};
             }
-            return values.at(idx);
+            return JSONValue::Ref(&values[idx]);
         }
 
     protected:
-        std::string name;
-        std::vector<JSONValueRef> values = {};
-    };
-
-    class JSONValue {
-    public:
-        using Ref = JSONValueRef;
-    public:
-        JSONValue() = default;
-
-        virtual ~JSONValue() = default;
-
-        template<typename T>
-        static JSONValue::Ref Create(T &data) {
-            auto refValue = std::make_shared<JSONValue>();
-            refValue->value = data;
-            return refValue;
-        }
-        template<typename T>
-        const T& As() const {
-            if constexpr (std::is_same_v<T, JSONObject::Ref>) {
-                auto res = std::get_if<JSONObject::Ref>(&value);
-                if (res == nullptr) {
-                    return {};
-                }
-                return *res;
+        void EnsureExpanded() const {
+            if ((lazy != nullptr) && !expanded.load(std::memory_order_acquire)) {
+                Expand();
             }
+        }
+        void Expand() const;
 
-            if constexpr (std::is_same_v<T, JSONArray::Ref>) {
-                auto res = std::get_if<JSONArray::Ref>(&value);
-                if (res == nullptr) {
-                    return {};
-                }
-                return *res;
-            }
+    protected:
+        std::string name;
+        mutable std::span<const JSONValue> values = {};
 
-            if constexpr (std::is_same_v<T, std::string>) {
-               auto res = std::get_if<std::string>(&value);
-               if (res == nullptr) {
-                   return {};
-               }
-               return *res;
-            }
-        }
+        JSONLazyIndex *lazy = nullptr;
+        uint32_t lazyContainer = 0;
+        mutable std::atomic<bool> expanded = true;
+    };
 
-        bool IsObject() const {
-            return (std::holds_alternative<JSONObject::Ref>(value));
-        }
-        bool IsArray() const {
-            return (std::holds_alternative<JSONArray::Ref>(value));
-        }
-        bool IsString() const {
-            return (std::holds_alternative<std::string>(value));
-        }
+    //
+    // Structural index of a lazily loaded document, built in one pass over the text: where each object/array starts
+    // and ends. Containers are expanded (one level) into real nodes on first access and scalars point straight into
+    // the text, so the cost of a sparse read scales with what is accessed.
+    // Expansion is serialized with a lock, reading an expanded node is lock free.
+    //
+    // Note: Only brackets and strings are checked up front, syntax errors elsewhere show up as missing values
+    //
+    class JSONLazyIndex {
+        friend JSONParser;
+        friend JSONObject;
+        friend JSONArray;
+    public:
+        JSONLazyIndex(JSONDoc &owner, const std::string &data) : doc(owner), text(data) {}
+        virtual ~JSONLazyIndex() = default;
 
-        const JSONObject::Ref &GetAsObject() {
-            auto res = std::get_if<JSONObject::Ref>(&value);
-            if (res == nullptr) {
-                static JSONObject::Ref empty = {};
-                return empty;
-            }
-            return *res;
+        // Number of objects and arrays in the document
+        size_t Size() const {
+            return containers.size();
         }
-        const JSONArray::Ref &GetAsArray() {
-            auto res = std::get_if<JSONArray::Ref>(&value);
-            if (res == nullptr) {
-                static JSONArray::Ref empty = {};
-                return empty;
-            }
-            return *res;
+        // True once an expanded object or array turned out to be malformed (unterminated string, missing ',' or ':' etc)
+        bool Failed() const {
+            return failed.load(std::memory_order_relaxed);
         }
-        const std::string &GetAsString() {
-            auto res = std::get_if<std::string>(&value);
-            if (res == nullptr) {
-                static std::string empty = {};
-                return empty;
-            }
-            return *res;
-        }
-
     protected:
-        std::variant<JSONObject::Ref, JSONArray::Ref, std::string> value;
+        struct Container {
+            size_t begin;           // position of '{' or '['
+            size_t end;             // position of the matching '}' or ']'
+            uint32_t idxNextSibling;   // first container after this one and everything within it
+        };
+        bool Build();
+        void Expand(const JSONObject &object);
+        void Expand(const JSONArray &array);
+        // Parses the value at 'pos', containers become unexpanded nodes
+        bool ParseValue(size_t &pos, const std::string &label, uint32_t &idxNextContainer, JSONValue &outValue);
+    protected:
+        JSONDoc &doc;
+        const std::string text;
+        std::vector<Container> containers;
+        std::mutex lock;
+        std::atomic<bool> failed = false;
     };
 
 
-    class JSONParser;
-
+    //
+    // Owns all nodes of a parsed document, objects/arrays are pooled and strings/array items are bump allocated
+    // from large blocks. Nothing moves once allocated - so handles stay valid until the document is destroyed.
+    //
     class JSONDoc {
         friend JSONParser;
+        friend JSONLazyIndex;
     public:
         JSONDoc() = default;
         virtual ~JSONDoc() = default;
 
+        JSONDoc(const JSONDoc &) = delete;
+        JSONDoc &operator=(const JSONDoc &) = delete;
+
+        // Holds a null object for empty documents and scalar roots
         const std::variant<JSONObject::Ref, JSONArray::Ref> &GetRoot() const {
             return root;
         }
+        // Any root value, scalars included (see JSONParser::LoadValue) - null for empty documents
+        JSONValue::Ref GetRootValue() const {
+            return rootValue.has_value() ? JSONValue::Ref(&*rootValue) : JSONValue::Ref{};
+        }
+
+        // Bytes held by the document arena (keys, strings longer than JSONValue::kMaxInline, array items and object members)
+        size_t GetArenaSize() const {
+            return arena.Size();
+        }
+
+        // Lazily loaded documents are only checked as they are expanded, true if a malformed container was found so far
+        bool HasErrors() const {
+            return (lazy != nullptr) && lazy->Failed();
+        }
+    protected:
+        // Drops all nodes, one arena block is kept for reuse
+        void Clear() {
+            root = {};
+            rootValue.reset();
+            objects.clear();
+            arrays.clear();
+            arena.Clear();
+        }
+
+        JSONObject *NewObject(const std::string &name) {
+            return &objects.emplace_back(name);
+        }
+        JSONArray *NewArray(const std::string &name) {
+            return &arrays.emplace_back(name);
+        }
+        std::string_view StoreString(std::string_view str) {
+            return arena.StoreString(str);
+        }
+        // array items and object members
+        template<typename T>
+        std::span<const T> StoreRange(std::span<const T> items) {
+            return arena.StoreRange(items);
+        }
     protected:
         std::variant<JSONObject::Ref, JSONArray::Ref> root;
+        std::optional<JSONValue> rootValue;
+        // Only for lazily loaded documents
+        std::unique_ptr<JSONLazyIndex> lazy;
+
+        std::deque<JSONObject> objects;
+        std::deque<JSONArray> arrays;
+
+        Arena arena;
     };
 
     class JSONParser {
@@ -229,6 +473,7 @@ namespace gnilk {
             ErrUnexpectedToken,
             ErrSeparatorMissing,
             ErrMaxDepth,
+            ErrLimitExceeded,       // see GetExceededLimit
         };
     public:
         // Note: Factory is unsued - these constructors are only here for API compatibility right now..
@@ -245,33 +490,60 @@ namespace gnilk {
 
 
         std::unique_ptr<JSONDoc> GetDocument();
+        // Parses 'stream' into the document held by this parser, the parser and the document (nodes and arena) are
+        // reused between calls. The document is valid until the next call, null on error.
+        const JSONDoc *Reparse(IReader::Ref stream);
         static std::unique_ptr<JSONDoc> Load(const std::string &data);
         static std::unique_ptr<JSONDoc> Load(IReader::Ref stream);
+        static std::unique_ptr<JSONDoc> Load(const std::string &data, const ParseLimits &limits);
+        static std::unique_ptr<JSONDoc> Load(IReader::Ref stream, const ParseLimits &limits);
+        // Parses exactly the value at the current position and stops (see JSONIndex), scalars are only available
+        // through JSONDoc::GetRootValue. Null if there is no valid value.
+        static std::unique_ptr<JSONDoc> LoadValue(IReader::Ref stream, const ParseLimits &limits = {});
+        // Only builds a structural index, objects and arrays are parsed when first accessed - see JSONLazyIndex
+        static std::unique_ptr<JSONDoc> LoadLazy(const std::string &data);
+
+        // Streaming of large arrays, only the current item is kept in memory.
+        // The array is either the root or a member 'name' of the root object, other members are skipped.
+        JSONParser::kResult BeginArrayStream(const std::string &name);
+        // Parses the next item, it replaces (and releases) the previous one. 'outItem' is null at the end of the array.
+        JSONParser::kResult NextArrayStreamItem(JSONValue::Ref &outItem);
+
+        void SetLimits(const ParseLimits &limits) {
+            guard = ParseGuard(limits);
+        }
+        // The limit which made the last parse fail, kNone if none
+        ParseLimits::kLimit GetExceededLimit() const {
+            return guard.GetExceeded();
+        }
 
         const std::string &ErrToString(JSONParser::kResult err);
 
     protected:
         void SetValueDelegate(ValueDelegate valueDelegate) { cbValue = valueDelegate; }
         JSONParser::kResult ProcessData();
+        JSONParser::kResult CheckLimits(JSONParser::kResult result);
 
         JSONParser::kResult ProcessDataInternal();
-        JSONParser::kResult ProcessObject(JSONObject::Ref &currentObject, size_t depth);
-        JSONParser::kResult ProcessArray(JSONArray::Ref &currentObject, const std::string &label, size_t depth);
+        JSONParser::kResult ProcessSingleValue();
+        JSONParser::kResult ProcessObject(JSONObject *currentObject, size_t depth);
+        JSONParser::kResult ProcessArray(JSONArray *currentObject, const std::string &label, size_t depth);
         JSONParser::kResult ProcessString();
         bool IsValidNumberStart(int ch);
         JSONParser::kResult ProcessNumber(int ch);
-        JSONParser::kResult ProcessValue(int ch, const std::string &label, JSONCoreObject::Ref currentObject, size_t depth);
+        JSONParser::kResult ProcessValue(int ch, const std::string &label, JSONValue &outValue, size_t depth);
         JSONParser::kResult ProcessExpected(int ch, const char *expected);
+        JSONParser::kResult SkipValue(int ch);
         int SkipWhiteSpace();
 
-        void OnValue(JSONCoreObject::Ref currentObject, const std::string &label);
+        JSONValue OnValue(JSONValue::kScalar scalarType);
     private:
 
         void ResetCurrentValue();
         void AppendToValue(int ch);
 
-        JSONObject::Ref CreateJSONObject(const std::string &name);
-        JSONArray::Ref CreateJSONArray(const std::string &name);
+        JSONObject *CreateJSONObject(const std::string &name);
+        JSONArray *CreateJSONArray(const std::string &name);
 
 
         void Reset();
@@ -287,8 +559,19 @@ namespace gnilk {
 
         int idxValueCurrent = 0;
         std::string valueCurrent = {};
+        // items of the arrays currently being parsed, moved to the document when the array is complete
+        std::vector<JSONValue> pendingItems = {};
+        std::vector<JSONObject::Member> pendingMembers = {};
 
         std::unique_ptr<JSONDoc> document;
+        bool isSingleValue = false;
+        ParseGuard guard = {};
+
+        // Array streaming
+        std::string streamLabel = {};
+        bool isStreamFirstItem = true;
+        bool isStreamEnd = true;
+        JSONValue streamItem = {};
     };
 
 }
@@ -0,0 +1,45 @@
+//
+// Created by gnilk on 19.10.2026.
+//
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "MMapReader.h"
+
+using namespace gnilk;
+
+MMapReader::~MMapReader() {
+    if (data != nullptr) {
+        munmap(const_cast<char *>(data), size);
+    }
+}
+
+// static
+MMapReader::Ref MMapReader::Create(const std::string &filename) {
+    auto fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return {};
+    }
+    struct stat st = {};
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return {};
+    }
+    auto reader = std::make_shared<MMapReader>();
+    // Can't map an empty file - but it is still a valid (empty) source
+    if (st.st_size > 0) {
+        auto ptr = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (ptr == MAP_FAILED) {
+            close(fd);
+            return {};
+        }
+        reader->data = static_cast<const char *>(ptr);
+        reader->size = static_cast<size_t>(st.st_size);
+    }
+    // the mapping stays valid after close
+    close(fd);
+    return reader;
+}
@@ -0,0 +1,70 @@
+//
+// Created by gnilk on 19.10.2026.
+//
+
+#ifndef GNILK_MMAPREADER_H
+#define GNILK_MMAPREADER_H
+
+#include <memory>
+#include <algorithm>
+#include <string>
+#include <string_view>
+#include <string.h>
+
+#include "IReader.h"
+
+namespace gnilk {
+
+    //
+    // Reads a memory mapped file, the whole file is one contiguous (read only) range which can be used directly
+    // through 'GetData' or read from any position after 'Seek'.
+    //
+    class MMapReader : public IReader {
+    public:
+        using Ref = std::shared_ptr<MMapReader>;
+    public:
+        MMapReader() = default;
+        virtual ~MMapReader();
+
+        MMapReader(const MMapReader &) = delete;
+        MMapReader &operator=(const MMapReader &) = delete;
+
+        // Returns null if the file can't be opened or mapped
+        static Ref Create(const std::string &filename);
+
+        int32_t Read(void *out, size_t maxbytes) override {
+            auto ncopy = std::min(maxbytes, size - idx);
+            memcpy(out, data + idx, ncopy);
+            idx += ncopy;
+            return static_cast<int32_t>(ncopy);
+        }
+        bool Available() override {
+            return (idx < size);
+        }
+
+        bool Seek(size_t offset) {
+            if (offset > size) {
+                return false;
+            }
+            idx = offset;
+            return true;
+        }
+        size_t Position() const {
+            return idx;
+        }
+
+        std::string_view GetData() const {
+            return {data, size};
+        }
+        size_t Size() const {
+            return size;
+        }
+
+    private:
+        const char *data = nullptr;
+        size_t size = 0;
+        size_t idx = 0;
+    };
+}
+
+#endif //GNILK_MMAPREADER_H
@@ -0,0 +1,146 @@
+//
+// Created by gnilk on 19.10.2026.
+//
+// Resource limits for parsing untrusted input, accepted by the JSON, XML and INI parsers.
+// Everything except the nesting depth is unlimited by default, a parse exceeding a limit fails right away and the
+// parser tells which limit it was (see 'GetExceededLimit').
+//
+//   ParseLimits limits;
+//   limits.maxBytes = 1024 * 1024;
+//   limits.maxStringLength = 64 * 1024;
+//   limits.deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(50);
+//   auto doc = JSONParser::Load(data, limits);
+//
+
+#ifndef GNILK_PARSELIMITS_H
+#define GNILK_PARSELIMITS_H
+
+#include <chrono>
+#include <limits>
+#include <optional>
+#include <stddef.h>
+#include <stdint.h>
+
+// Default nesting limit, GNILK_JSON_MAX_DEPTH is still honored
+#ifndef GNILK_PARSE_MAX_DEPTH
+#ifdef GNILK_JSON_MAX_DEPTH
+#define GNILK_PARSE_MAX_DEPTH GNILK_JSON_MAX_DEPTH
+#else
+#define GNILK_PARSE_MAX_DEPTH 255
+#endif
+#endif
+
+namespace gnilk {
+    struct ParseLimits {
+        static constexpr size_t kUnlimited = std::numeric_limits<size_t>::max();
+        enum class kLimit : uint8_t {
+            kNone,
+            kDepth,
+            kBytes,
+            kStringLength,
+            kMembers,
+            kArrayLength,
+            kAttributes,
+            kSteps,
+            kDeadline,
+        };
+
+        size_t maxDepth = GNILK_PARSE_MAX_DEPTH;    // nested objects/arrays/tags
+        size_t maxBytes = kUnlimited;               // total input
+        size_t maxStringLength = kUnlimited;        // keys, names, values and content
+        size_t maxMembers = kUnlimited;             // members of a JSON object, children of a tag or values of an INI section
+        size_t maxArrayLength = kUnlimited;         // JSON array items
+        size_t maxAttributes = kUnlimited;          // attributes of an XML tag
+        size_t maxSteps = kUnlimited;               // tokens (values, keys, tags)
+        // Checked every kDeadlineInterval steps
+        std::optional<std::chrono::steady_clock::time_point> deadline = {};
+
+        static constexpr size_t kDeadlineInterval = 1024;
+
+        static const char *ToString(kLimit limit) {
+            switch(limit) {
+                case kLimit::kNone : return "none";
+                case kLimit::kDepth : return "max depth";
+                case kLimit::kBytes : return "max bytes";
+                case kLimit::kStringLength : return "max string length";
+                case kLimit::kMembers : return "max members";
+                case kLimit::kArrayLength : return "max array length";
+                case kLimit::kAttributes : return "max attributes";
+                case kLimit::kSteps : return "step budget";
+                case kLimit::kDeadline : return "deadline";
+            }
+            return "unknown";
+        }
+    };
+
+    // Tracks a parse against its limits, the first limit exceeded is kept
+    class ParseGuard {
+    public:
+        using kLimit = ParseLimits::kLimit;
+    public:
+        ParseGuard() = default;
+        explicit ParseGuard(const ParseLimits &useLimits) : limits(useLimits) {}
+
+        void Reset() {
+            nBytes = 0;
+            nSteps = 0;
+            exceeded = kLimit::kNone;
+        }
+
+        __inline bool OnBytes(size_t n) {
+            nBytes += n;
+            return (nBytes <= limits.maxBytes) || Fail(kLimit::kBytes);
+        }
+        // One per token, the clock is only read every kDeadlineInterval steps
+        __inline bool OnStep() {
+            nSteps++;
+            if (nSteps > limits.maxSteps) {
+                return Fail(kLimit::kSteps);
+            }
+            if (limits.deadline.has_value() && ((nSteps % ParseLimits::kDeadlineInterval) == 0)) {
+                if (std::chrono::steady_clock::now() > *limits.deadline) {
+                    return Fail(kLimit::kDeadline);
+                }
+            }
+            return true;
+        }
+        __inline bool CheckDepth(size_t depth) {
+            return (depth <= limits.maxDepth) || Fail(kLimit::kDepth);
+        }
+        __inline bool CheckStringLength(size_t len) {
+            return (len <= limits.maxStringLength) || Fail(kLimit::kStringLength);
+        }
+        __inline bool CheckMembers(size_t n) {
+            return (n <= limits.maxMembers) || Fail(kLimit::kMembers);
+        }
+        __inline bool CheckArrayLength(size_t n) {
+            return (n <= limits.maxArrayLength) || Fail(kLimit::kArrayLength);
+        }
+        __inline bool CheckAttributes(size_t n) {
+            return (n <= limits.maxAttributes) || Fail(kLimit::kAttributes);
+        }
+
+        bool Fail(kLimit limit) {
+            if (exceeded == kLimit::kNone) {
+                exceeded = limit;
+            }
+            return false;
+        }
+        bool IsExceeded() const {
+            return (exceeded != kLimit::kNone);
+        }
+        kLimit GetExceeded() const {
+            return exceeded;
+        }
+        const ParseLimits &GetLimits() const {
+            return limits;
+        }
+    protected:
+        ParseLimits limits = {};
+        size_t nBytes = 0;
+        size_t nSteps = 0;
+        kLimit exceeded = kLimit::kNone;
+    };
+}
+
+#endif //GNILK_PARSELIMITS_H
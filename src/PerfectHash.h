@@ -0,0 +1,224 @@
+//
+// Created by gnilk on 19.10.2026.
+//
+// Compile time perfect hashing of a fixed set of strings (field names and such).
+// Uses 'hash and displace', each key is hashed once into a bucket, each bucket has a seed (displacement) which places
+// all keys of the bucket in distinct slots. Lookup is one hash of the key, one table lookup and one verifying compare.
+//
+// Build the table in a constexpr context - failing to build (like duplicate keys) is a compile error:
+//   static constexpr PerfectHash<3> table({"id", "name", "ts"});
+//   auto idx = table.Find("name");    // 1
+//
+// For hand written IUnmarshal implementations use FieldSwitch:
+//   using Fields = FieldSwitch<"id", "name", "ts">;
+//   switch(Fields::Index(fieldName)) {
+//       case Fields::IndexOf("id") : ...
+//       case Fields::IndexOf("name") : ...
+//       default : return false;   // -1, unknown field
+//   }
+//
+
+#ifndef GNILK_PERFECTHASH_H
+#define GNILK_PERFECTHASH_H
+
+#include <array>
+#include <string_view>
+#include <algorithm>
+#include <optional>
+#include <type_traits>
+#include <stdint.h>
+#include <stddef.h>
+
+namespace gnilk {
+
+    // FNV-1a, good enough for short identifiers and trivial to evaluate at compile time
+    constexpr uint64_t hash_fnv1a(std::string_view str) {
+        uint64_t hash = 0xcbf29ce484222325ull;
+        for(auto c : str) {
+            hash ^= static_cast<uint8_t>(c);
+            hash *= 0x100000001b3ull;
+        }
+        return hash;
+    }
+
+    template<size_t N>
+    class PerfectHash {
+    public:
+        static constexpr size_t nextPow2(size_t n) {
+            size_t res = 1;
+            while(res < n) res <<= 1;
+            return res;
+        }
+        // Number of buckets (one seed per bucket) and slots, the slot table is kept at a load of at most 0.5
+        static constexpr size_t kNumBuckets = nextPow2(N == 0 ? 1 : N);
+        static constexpr size_t kNumSlots = kNumBuckets * 2;
+        // keep this below the compilers constexpr loop limit
+        static constexpr uint32_t kMaxSeed = 1u << 16;
+    public:
+        PerfectHash() = delete;
+        consteval explicit PerfectHash(const std::array<std::string_view, N> &useKeys) : keys(useKeys) {
+            Build();
+        }
+
+        // Returns the index of 'key' in the array given at construction time or -1 if not found
+        constexpr int Find(std::string_view key) const {
+            if constexpr (N == 0) {
+                return -1;
+            }
+            auto hash = hash_fnv1a(key);
+            auto idx = slots[Slot(hash, seeds[hash & (kNumBuckets - 1)])];
+            if ((idx < 0) || (keys[idx] != key)) {
+                return -1;
+            }
+            return idx;
+        }
+
+        constexpr std::string_view KeyAt(size_t idx) const {
+            return keys[idx];
+        }
+
+        static constexpr size_t Size() {
+            return N;
+        }
+
+    protected:
+        static constexpr size_t Slot(uint64_t hash, uint32_t seed) {
+            // splitmix64 finalizer on the (already hashed) key
+            uint64_t x = hash + (static_cast<uint64_t>(seed) + 1) * 0x9e3779b97f4a7c15ull;
+            x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+            x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+            x = x ^ (x >> 31);
+            return x & (kNumSlots - 1);
+        }
+
+        consteval void Build() {
+            std::array<uint64_t, N> hashes = {};
+            for(size_t i=0;i<N;i++) {
+                for(size_t j=0;j<i;j++) {
+                    if (keys[i] == keys[j]) {
+                        throw "PerfectHash, duplicate key";
+                    }
+                }
+                hashes[i] = hash_fnv1a(keys[i]);
+            }
+
+            // Place the largest buckets first - they are the hardest to fit
+            std::array<size_t, kNumBuckets> bucketSize = {};
+            std::array<size_t, kNumBuckets> order = {};
+            for(size_t i=0;i<N;i++) {
+                bucketSize[hashes[i] & (kNumBuckets - 1)]++;
+            }
+            for(size_t b=0;b<kNumBuckets;b++) {
+                order[b] = b;
+            }
+            std::sort(order.begin(), order.end(), [&bucketSize](size_t a, size_t b) {
+                return bucketSize[a] > bucketSize[b];
+            });
+
+            slots.fill(-1);
+            seeds.fill(0);
+            std::array<size_t, kNumSlots> candidate = {};
+            for(auto bucket : order) {
+                if (bucketSize[bucket] == 0) break;
+
+                uint32_t seed = 0;
+                for(;seed < kMaxSeed; seed++) {
+                    size_t nPlaced = 0;
+                    bool ok = true;
+                    for(size_t i=0;(i<N) && ok;i++) {
+                        if ((hashes[i] & (kNumBuckets - 1)) != bucket) continue;
+                        auto slot = Slot(hashes[i], seed);
+                        if (slots[slot] >= 0) {
+                            ok = false;
+                        }
+                        // collision within the bucket itself
+                        for(size_t k=0;(k<nPlaced) && ok;k++) {
+                            if (candidate[k] == slot) ok = false;
+                        }
+                        candidate[nPlaced++] = slot;
+                    }
+                    if (ok) break;
+                }
+                if (seed == kMaxSeed) {
+                    throw "PerfectHash, unable to find seed";
+                }
+                seeds[bucket] = seed;
+                for(size_t i=0;i<N;i++) {
+                    if ((hashes[i] & (kNumBuckets - 1)) != bucket) continue;
+                    slots[Slot(hashes[i], seed)] = static_cast<int32_t>(i);
+                }
+            }
+        }
+
+    protected:
+        std::array<std::string_view, N> keys = {};
+        std::array<uint32_t, kNumBuckets> seeds = {};
+        std::array<int32_t, kNumSlots> slots = {};
+    };
+
+    // String literal usable as template argument, like FieldSwitch<"id", "name">
+    template<size_t N>
+    struct FixedString {
+        char data[N] = {};
+
+        consteval FixedString(const char (&str)[N]) {
+            std::copy_n(str, N, data);
+        }
+        constexpr std::string_view View() const {
+            return {data, N - 1};
+        }
+    };
+
+    // Maps a field name to a dense index [0..N) or -1, with one hash and one compare
+    template<FixedString... Names>
+    class FieldSwitch {
+    public:
+        static constexpr size_t Size() {
+            return sizeof...(Names);
+        }
+
+        static constexpr int Index(std::string_view name) {
+            return table.Find(name);
+        }
+
+        // Compile time index of a name, intended for case labels - unknown names will not compile
+        static consteval int IndexOf(std::string_view name) {
+            auto idx = table.Find(name);
+            if (idx < 0) {
+                throw "FieldSwitch, unknown name";
+            }
+            return idx;
+        }
+
+        static constexpr std::string_view Name(size_t idx) {
+            return table.KeyAt(idx);
+        }
+
+    protected:
+        static constexpr PerfectHash<sizeof...(Names)> table = PerfectHash<sizeof...(Names)>(std::array<std::string_view, sizeof...(Names)>{ Names.View()... });
+    };
+
+    // String to enum (and back), the names map to the enum values 0..N-1 in the given order
+    template<typename E, FixedString... Names>
+    class EnumSwitch : public FieldSwitch<Names...> {
+        static_assert(std::is_enum_v<E>, "EnumSwitch, E must be an enum");
+    public:
+        static constexpr std::optional<E> FromString(std::string_view name) {
+            auto idx = FieldSwitch<Names...>::Index(name);
+            if (idx < 0) {
+                return std::nullopt;
+            }
+            return static_cast<E>(idx);
+        }
+
+        static constexpr std::string_view ToString(E value) {
+            auto idx = static_cast<size_t>(value);
+            if (idx >= sizeof...(Names)) {
+                return {};
+            }
+            return FieldSwitch<Names...>::Name(idx);
+        }
+    };
+}
+
+#endif //GNILK_PERFECTHASH_H
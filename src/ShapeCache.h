@@ -0,0 +1,109 @@
+//
+// Created by gnilk on 19.10.2026.
+//
+// Caches the layout (shape) of decoded objects per target class - much like hidden classes in JS engines.
+// Streams tend to repeat the same keys in the same order, on a hit the field slot is found by comparing the key at
+// the same position in the previous object instead of resolving the name through the object.
+// Only used for objects implementing IUnmarshalSlots.
+//
+// Note: Not thread safe, share a cache only between decoders running on the same thread.
+//
+
+#ifndef GNILK_SHAPECACHE_H
+#define GNILK_SHAPECACHE_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <typeindex>
+#include <unordered_map>
+#include <stdint.h>
+
+#include "IUnmarshal.h"
+
+namespace gnilk {
+
+    class ShapeCache {
+    public:
+        using Ref = std::shared_ptr<ShapeCache>;
+
+        struct Stats {
+            uint64_t hits = 0;
+            uint64_t misses = 0;
+            size_t shapes = 0;
+        };
+
+        // Slot of positions a nested object of the same class cut away, they never hit
+        static constexpr int kPadding = -2;
+
+        // Observed key sequence and the resolved slots
+        struct Shape {
+            std::vector<std::string> keys;
+            std::vector<int> slots;
+        };
+
+        // Position within the shape of the object currently being decoded
+        class Cursor {
+            friend ShapeCache;
+        public:
+            Cursor() = default;
+        protected:
+            Shape *shape = nullptr;
+            IUnmarshalSlots *object = nullptr;
+            size_t pos = 0;
+        };
+
+    public:
+        ShapeCache() = default;
+        virtual ~ShapeCache() = default;
+
+        static Ref Create() {
+            return std::make_shared<ShapeCache>();
+        }
+
+        Cursor Begin(IUnmarshalSlots *pObject) {
+            Cursor cursor;
+            cursor.object = pObject;
+            cursor.shape = &shapes[std::type_index(typeid(*pObject))];
+            return cursor;
+        }
+
+        // Resolve the next key of the object, keys must be resolved in document order
+        int Resolve(Cursor &cursor, std::string_view key) {
+            auto &shape = *cursor.shape;
+            auto pos = cursor.pos++;
+            if ((pos < shape.keys.size()) && (shape.slots[pos] != kPadding) && (shape.keys[pos] == key)) {
+                hits++;
+                return shape.slots[pos];
+            }
+            misses++;
+
+            // The layout changed from here on - relearn it. A nested object of the same class shares the shape and
+            // may have cut it shorter than 'pos', the gap is padding.
+            auto slot = cursor.object->ResolveSlot(key);
+            shape.keys.resize(pos);
+            shape.slots.resize(pos, kPadding);
+            shape.keys.emplace_back(key);
+            shape.slots.push_back(slot);
+            return slot;
+        }
+
+        Stats GetStats() const {
+            return {hits, misses, shapes.size()};
+        }
+
+        void Clear() {
+            shapes.clear();
+            hits = 0;
+            misses = 0;
+        }
+
+    protected:
+        std::unordered_map<std::type_index, Shape> shapes;
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+    };
+}
+
+#endif //GNILK_SHAPECACHE_H
@@ -36,6 +36,10 @@ namespace gnilk {
         bool Available() override {
             return (idx < data.size());
         };
+        // Reads the (possibly changed) string again from the start
+        void Rewind() {
+            idx = 0;
+        }
 
 
     private:
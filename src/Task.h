@@ -0,0 +1,123 @@
+//
+// Created by gnilk on 19.10.2026.
+//
+// Minimal lazy coroutine task. Nothing runs until the task is awaited (from another coroutine) or started.
+// When awaited the awaiting coroutine is resumed once the task completes.
+//
+// From regular code:
+//   auto task = decoder.UnmarshalAsync(reader, &object);
+//   task.Start();
+//   ... drive your event loop until task.IsDone() ...
+//   auto ok = task.Result();
+//
+
+#ifndef GNILK_TASK_H
+#define GNILK_TASK_H
+
+#include <coroutine>
+#include <optional>
+#include <exception>
+#include <stdexcept>
+#include <utility>
+
+namespace gnilk {
+
+    template<typename T>
+    class Task {
+    public:
+        struct promise_type {
+            std::optional<T> value = {};
+            std::exception_ptr exception = {};
+            std::coroutine_handle<> continuation = {};
+
+            Task get_return_object() {
+                return Task(std::coroutine_handle<promise_type>::from_promise(*this));
+            }
+            std::suspend_always initial_suspend() noexcept { return {}; }
+
+            // Transfer to whoever awaited us (if anyone)
+            struct FinalAwaiter {
+                bool await_ready() noexcept { return false; }
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> h) noexcept {
+                    auto next = h.promise().continuation;
+                    return next ? next : std::noop_coroutine();
+                }
+                void await_resume() noexcept {}
+            };
+            FinalAwaiter final_suspend() noexcept { return {}; }
+
+            void return_value(T result) {
+                value = std::move(result);
+            }
+            void unhandled_exception() {
+                exception = std::current_exception();
+            }
+        };
+    public:
+        Task() = default;
+        explicit Task(std::coroutine_handle<promise_type> h) : handle(h) {}
+        Task(Task &&other) noexcept : handle(std::exchange(other.handle, {})) {}
+        Task &operator=(Task &&other) noexcept {
+            if (this != &other) {
+                if (handle) handle.destroy();
+                handle = std::exchange(other.handle, {});
+            }
+            return *this;
+        }
+        Task(const Task &) = delete;
+        Task &operator=(const Task &) = delete;
+
+        virtual ~Task() {
+            if (handle) {
+                handle.destroy();
+            }
+        }
+
+        // Runs the task until it completes or suspends (waiting for something), only call this once
+        void Start() {
+            if (handle && !handle.done()) {
+                handle.resume();
+            }
+        }
+        bool IsDone() const {
+            return !handle || handle.done();
+        }
+        // Only valid once done, rethrows any exception from the task.
+        // Throws std::logic_error for an empty (moved from) or unfinished task, or if the result was already taken.
+        T Result() {
+            if (!handle) {
+                throw std::logic_error("Task::Result, no task");
+            }
+            if (!handle.done()) {
+                throw std::logic_error("Task::Result, task not done");
+            }
+            auto &promise = handle.promise();
+            if (promise.exception) {
+                std::rethrow_exception(promise.exception);
+            }
+            if (!promise.value.has_value()) {
+                throw std::logic_error("Task::Result, no value");
+            }
+            T result = std::move(*promise.value);
+            promise.value.reset();
+            return result;
+        }
+
+        // Awaitable from other coroutines
+        bool await_ready() const noexcept {
+            return IsDone();
+        }
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+            handle.promise().continuation = awaiting;
+            return handle;
+        }
+        T await_resume() {
+            return Result();
+        }
+
+    private:
+        std::coroutine_handle<promise_type> handle = {};
+    };
+}
+
+#endif //GNILK_TASK_H
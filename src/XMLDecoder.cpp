@@ -1,16 +1,20 @@
 //
 // Created by gnilk on 16.12.25.
 //
-// Note: does not support 'content' of the tag nor repeated sub-tag's (i.e. lists)...
+// Note: content is only supported for leaf tags (treated as fields).
+// Lists are repeated sub-tags, XML has nothing telling a list from a single object so the consumer decides - object
+// children are only pushed with 'PushToArray' for names it said yes to in 'ReserveArray'. Leaf items are set with
+// 'SetField' one by one, like JSON arrays.
 //
 
 #include "XMLDecoder.h"
 #include "DecoderHelpers.h"
+#include <algorithm>
 #include <charconv>
 
 using namespace gnilk;
 
-static xml::Tag::Ref FindNode(const xml::Tag::Ref &root, const std::string &name);
+static const xml::Tag *FindNode(const xml::Document &doc, const xml::Tag *root, const std::string &name);
 
 // Helpers..
 
@@ -18,12 +22,21 @@ XMLDecoder::XMLDecoder(const std::string &data)  : docData(data) {
 }
 
 XMLDecoder::XMLDecoder(IReader::Ref instream) : docData () {
-    // FIXME: the XML Parser does not support streams...
+    Begin(instream);
+}
+
+XMLDecoder::XMLDecoder(const xml::Document &document) : doc(&document) {
+    if (doc->GetRoot() != nullptr) {
+        tagStack.push(doc->GetRoot());
+    }
 }
 
 
 
 bool XMLDecoder::Unmarshal(IUnmarshal *rootObject) {
+    if (streamIn != nullptr) {
+        return UnmarshalStream(rootObject);
+    }
     // Sanity checks
     if (doc == nullptr) {
         // can't parse and empty XML document
@@ -45,29 +58,215 @@ bool XMLDecoder::Unmarshal(IUnmarshal *rootObject) {
     return true;
 }
 
-bool XMLDecoder::TraverseFrom(const xml::Tag::Ref tag, IUnmarshal *pObject) {
-    for(auto &attr : tag->GetAttributes()) {
-        pObject->SetField(attr->GetName(), attr->GetValue());
-    }
+bool XMLDecoder::TraverseFrom(const xml::Tag *tag, IUnmarshal *pObject) {
+    UnmarshalAttributes(pObject, tag->GetAttributes());
 
-    for(auto &childTag : tag->GetChildren()) {
-        auto pObjectChild = pObject->GetUnmarshalForField(childTag->GetName());
-        if (pObjectChild == nullptr) continue;
-        // Can't happen - but might in the future...
-        if (!TraverseFrom(childTag, pObjectChild)) {
+    auto children = tag->GetChildren();
+    // The consumer is asked once per name (with all children of that name, like XMLArrayIterator) if it is a list
+    std::vector<ListName> lists;
+    for(auto childTag : children) {
+        auto itList = std::find_if(lists.begin(), lists.end(), [childTag](const ListName &list) {
+            return list.nameId == childTag->GetNameId();
+        });
+        if (itList == lists.end()) {
+            size_t count = 0;
+            for(auto other : children) {
+                count += (other->GetNameId() == childTag->GetNameId()) ? 1 : 0;
+            }
+            fieldName.assign(childTag->GetName());
+            itList = lists.insert(lists.end(), {childTag->GetNameId(), pObject->ReserveArray(fieldName, count)});
+        }
+        if (!UnmarshalChild(pObject, childTag, itList->isList)) {
             return false;
         }
     }
     return true;
 }
 
+bool XMLDecoder::UnmarshalChild(IUnmarshal *pObject, xml::Tag::Ref childTag, bool isListItem) {
+    fieldName.assign(childTag->GetName());
+    auto pObjectChild = pObject->GetUnmarshalForField(fieldName);
+    if (pObjectChild == nullptr) {
+        // Leaf elements, like '<name>value</name>', are treated as fields
+        if (childTag->GetChildren().empty() && childTag->GetAttributes().empty()) {
+            UnmarshalLeaf(pObject, childTag->GetName(), childTag->GetContent());
+        }
+        return true;
+    }
+    if (!TraverseFrom(childTag, pObjectChild)) {
+        return false;
+    }
+    if (isListItem) {
+        // the name is reused while traversing, restore it
+        fieldName.assign(childTag->GetName());
+        pObject->PushToArray(fieldName, pObjectChild);
+    }
+    return true;
+}
+
+void XMLDecoder::UnmarshalAttributes(IUnmarshal *pObject, std::span<const xml::Attribute> attributes) {
+    // XML has no types, typed objects just get the strings without copies
+    auto pTyped = dynamic_cast<IUnmarshalTyped *>(pObject);
+    // Objects with slots have their attribute layout cached
+    auto pSlots = dynamic_cast<IUnmarshalSlots *>(pObject);
+    ShapeCache::Cursor shapeCursor;
+    if (pSlots != nullptr) {
+        shapeCursor = GetShapeCache()->Begin(pSlots);
+    }
+
+    for(auto &attr : attributes) {
+        int slot = -1;
+        if (pSlots != nullptr) {
+            slot = shapeCache->Resolve(shapeCursor, attr.GetName());
+        }
+        if (slot >= 0) {
+            UnmarshalValue value;
+            value.str = attr.GetValue();
+            pSlots->SetSlot(slot, value);
+        } else if (pTyped != nullptr) {
+            pTyped->SetString(attr.GetName(), attr.GetValue());
+        } else {
+            fieldName.assign(attr.GetName());
+            fieldValue.assign(attr.GetValue());
+            pObject->SetField(fieldName, fieldValue);
+        }
+    }
+}
+
+void XMLDecoder::UnmarshalLeaf(IUnmarshal *pObject, std::string_view name, std::string_view content) {
+    auto pTyped = dynamic_cast<IUnmarshalTyped *>(pObject);
+    if (pTyped != nullptr) {
+        pTyped->SetString(name, content);
+    } else {
+        fieldName.assign(name);
+        fieldValue.assign(content);
+        pObject->SetField(fieldName, fieldValue);
+    }
+}
+
+//
+// Streaming unmarshal - the same rules as 'TraverseFrom' applied to the parser events
+//
+class XMLDecoder::StreamHandler : public xml::ISaxEvents {
+public:
+    StreamHandler(XMLDecoder &useDecoder, IUnmarshal *rootObject) : decoder(useDecoder), pRoot(rootObject) {}
+
+    bool StartElement(std::string_view name, std::span<const xml::Attribute> attributes) override {
+        // top level elements all go to the root object
+        if (frames.empty()) {
+            decoder.UnmarshalAttributes(pRoot, attributes);
+            frames.push_back({pRoot});
+            return true;
+        }
+        auto &parent = frames.back();
+        // only a leaf without children is a field
+        if (parent.pObject == nullptr) {
+            parent.isLeaf = false;
+            return false;
+        }
+        auto isListItem = IsListItem(parent, name);
+        decoder.fieldName.assign(name);
+        auto pObjectChild = parent.pObject->GetUnmarshalForField(decoder.fieldName);
+        if (pObjectChild != nullptr) {
+            decoder.UnmarshalAttributes(pObjectChild, attributes);
+            frames.push_back({pObjectChild, parent.pObject, false, isListItem});
+            return true;
+        }
+        if (!attributes.empty()) {
+            return false;
+        }
+        // leaf candidate, the content is kept until we know there are no children
+        frames.push_back({nullptr, parent.pObject, true});
+        leafContent.clear();
+        return true;
+    }
+
+    void EndElement(std::string_view name) override {
+        auto frame = std::move(frames.back());
+        frames.pop_back();
+        if ((frame.pObject == nullptr) && frame.isLeaf) {
+            decoder.UnmarshalLeaf(frame.pParent, name, leafContent);
+        } else if ((frame.pObject != nullptr) && (frame.pParent != nullptr) && frame.isListItem) {
+            decoder.fieldName.assign(name);
+            frame.pParent->PushToArray(decoder.fieldName, frame.pObject);
+        }
+    }
+
+    void Content(std::string_view name, std::string_view content) override {
+        if (!frames.empty() && (frames.back().pObject == nullptr)) {
+            leafContent.assign(content);
+        }
+    }
+private:
+    struct ListName {
+        std::string name;
+        bool isList;
+    };
+    struct Frame {
+        IUnmarshal *pObject = nullptr;
+        IUnmarshal *pParent = nullptr;
+        // leaf candidates only
+        bool isLeaf = false;
+        // objects only, given to 'PushToArray' when done
+        bool isListItem = false;
+        // child names the object was asked about
+        std::vector<ListName> lists = {};
+    };
+
+    // Like 'TraverseFrom' the object is asked once per child name, the items can't be counted ahead when streaming
+    bool IsListItem(Frame &frame, std::string_view name) {
+        for(auto &list : frame.lists) {
+            if (list.name == name) {
+                return list.isList;
+            }
+        }
+        decoder.fieldName.assign(name);
+        auto isList = frame.pObject->ReserveArray(decoder.fieldName, 0);
+        frame.lists.push_back({std::string(name), isList});
+        return isList;
+    }
+    XMLDecoder &decoder;
+    IUnmarshal *pRoot;
+    std::vector<Frame> frames;
+    std::string leafContent;
+};
+
+bool XMLDecoder::UnmarshalStream(IUnmarshal *rootObject) {
+    if (rootObject == nullptr) return false;
+    auto stream = std::move(streamIn);
+    streamIn = nullptr;
+    StreamHandler handler(*this, rootObject);
+    return xml::XMLParser::Parse(stream, handler, parseLimits);
+}
+
+void XMLDecoder::BeginStream(IReader::Ref incoming) {
+    docData.clear();
+    ownedDoc = nullptr;
+    doc = nullptr;
+    tagStack = {};
+    arrayStack.clear();
+    streamIn = incoming;
+}
+
+void XMLDecoder::Begin(IReader::Ref incoming) {
+    docData.clear();
+    Initialize(xml::XMLParser::Load(incoming, parseLimits));
+}
+
 void XMLDecoder::Begin(const std::string &xmldata) {
     docData = xmldata;
     Initialize();
 }
 
 bool XMLDecoder::Initialize() {
-    doc = xml::XMLParser::Load(docData);
+    return Initialize(xml::XMLParser::Load(docData, parseLimits));
+}
+
+bool XMLDecoder::Initialize(std::unique_ptr<xml::Document> parsed) {
+    tagStack = {};
+    arrayStack.clear();
+    ownedDoc = std::move(parsed);
+    doc = ownedDoc.get();
     if (doc == nullptr) {
         return false;
     }
@@ -75,14 +274,23 @@ bool XMLDecoder::Initialize() {
     if (root == nullptr) {
         return false;
     }
-    tagStack.push(doc->GetRoot());
+    tagStack.push(root);
     return true;
 }
 
 
 bool XMLDecoder::BeginObject(const std::string &name) {
     if (tagStack.empty()) return false;
-    auto node = FindNode(tagStack.top(), name);
+    // inside an array the object is the current item
+    if (!arrayStack.empty() && (arrayStack.back().depth == tagStack.size())) {
+        auto item = arrayStack.back().iterator->GetTag();
+        if (item == nullptr) {
+            return false;
+        }
+        tagStack.push(item);
+        return true;
+    }
+    auto node = FindNode(*doc, tagStack.top(), name);
     if (node != nullptr) {
         tagStack.push(node);
         return true;
@@ -92,11 +300,33 @@ bool XMLDecoder::BeginObject(const std::string &name) {
 void XMLDecoder::EndObject() {
     tagStack.pop();
 }
+
+IDecoder::ArrayIterator::Ref XMLDecoder::BeginArray(const std::string &name) {
+    std::span<const xml::Tag::Ref> children = {};
+    auto nameId = xml::NameTable::kNoName;
+    if (!tagStack.empty()) {
+        children = tagStack.top()->GetChildren();
+        nameId = doc->FindName(name);
+    }
+    // a name the document doesn't know gives an empty iterator
+    if (nameId == xml::NameTable::kNoName) {
+        children = {};
+    }
+    auto iterator = std::make_shared<XMLArrayIterator>(children, nameId);
+    arrayStack.push_back({iterator, tagStack.size()});
+    return iterator;
+}
+
+void XMLDecoder::EndArray() {
+    if (!arrayStack.empty()) {
+        arrayStack.pop_back();
+    }
+}
 bool XMLDecoder::HasObject(const std::string &name) {
     if (tagStack.empty()) {
         return false;
     }
-    if (FindNode(tagStack.top(), name) != nullptr) {
+    if (FindNode(*doc, tagStack.top(), name) != nullptr) {
         return true;
     }
 
@@ -113,7 +343,7 @@ std::optional<int> XMLDecoder::ReadIntField(const std::string &name) {
     }
 
     if (tagStack.empty()) return {};
-    auto &attrib = tagStack.top()->GetAttributeValue(name,"");
+    auto attrib = tagStack.top()->GetAttributeValue(name,"");
     if (attrib.empty()) {
         return {};
     }
@@ -130,19 +360,17 @@ std::optional<float> XMLDecoder::ReadFloatField(const std::string &name) {
 }
 std::optional<std::string> XMLDecoder::ReadTextField(const std::string &name) {
     if (tagStack.empty()) return {};
-    auto &attrib = tagStack.top()->GetAttributeValue(name,"");
+    auto attrib = tagStack.top()->GetAttributeValue(name,"");
     if (attrib.empty()) {
         return {};
     }
-    return {attrib};
+    return std::string(attrib);
 }
 
-static xml::Tag::Ref FindNode(const xml::Tag::Ref &root, const std::string &name) {
-    if (root->GetName() == name) return root;
-    for(auto &ch : root->GetChildren()) {
-        if (ch->GetName() == name) {
-            return ch;
-        }
-    }
-    return nullptr;
+// Names are interned by the document, a name it doesn't know can't be found
+static const xml::Tag *FindNode(const xml::Document &doc, const xml::Tag *root, const std::string &name) {
+    auto id = doc.FindName(name);
+    if (id == xml::NameTable::kNoName) return nullptr;
+    if (root->GetNameId() == id) return root;
+    return root->GetFirstChild(id);
 }
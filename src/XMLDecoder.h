@@ -5,26 +5,122 @@
 #ifndef GNILK_XMLDECODER_H
 #define GNILK_XMLDECODER_H
 
+#include <stack>
+#include <vector>
+
 #include "IDecoder.h"
 #include "XMLParser.h"
+#include "DecoderHelpers.h"
 
 namespace gnilk {
 
+    //
+    // XML has no arrays, a list is the children with the same name - like all '<item>' in '<items><item/><item/></items>'.
+    // Other children in between are skipped. Items are read from their content.
+    //
+    class XMLArrayIterator : public IDecoder::ArrayIterator {
+    public:
+        using Ref = std::shared_ptr<XMLArrayIterator>;
+    public:
+        XMLArrayIterator(std::span<const xml::Tag::Ref> parentChildren, xml::NameTable::NameId itemNameId) : children(parentChildren), nameId(itemNameId) {
+            idxCurrent = Skip(0);
+        }
+        virtual ~XMLArrayIterator() = default;
+
+        void Next() override {
+            if (idxCurrent < children.size()) {
+                idxCurrent = Skip(idxCurrent + 1);
+            }
+        }
+        bool Equals(const ArrayIterator::Ref &other) const override {
+            auto itOther = std::dynamic_pointer_cast<XMLArrayIterator>(other);
+            return (itOther != nullptr) && (idxCurrent == itOther->idxCurrent);
+        }
+        bool End() const override {
+            return (idxCurrent >= children.size());
+        }
+        size_t Size() const override {
+            size_t n = 0;
+            for(auto idx = Skip(0); idx < children.size(); idx = Skip(idx + 1)) {
+                n++;
+            }
+            return n;
+        }
+
+        bool IsObject() override {
+            auto tag = GetTag();
+            return (tag != nullptr) && (!tag->GetChildren().empty() || !tag->GetAttributes().empty());
+        }
+
+        bool ReadBool() override {
+            return Read<bool>(false);
+        }
+        int ReadInt() override {
+            return Read<int>(-1);
+        }
+        int64_t ReadInt64() override {
+            return Read<int64_t>(-1);
+        }
+        float ReadFloat() override {
+            return Read<float>(-1);
+        }
+        std::string ReadText() override {
+            auto tag = GetTag();
+            if (tag == nullptr) {
+                return {};
+            }
+            return std::string(tag->GetContent());
+        }
+
+        xml::Tag::Ref GetTag() const {
+            return End() ? nullptr : children[idxCurrent];
+        }
+    protected:
+        size_t Skip(size_t idx) const {
+            while((idx < children.size()) && (children[idx]->GetNameId() != nameId)) {
+                idx++;
+            }
+            return idx;
+        }
+        template<typename T>
+        T Read(T defValue) {
+            auto tag = GetTag();
+            if (tag == nullptr) {
+                return defValue;
+            }
+            auto out = convert_to<T>(tag->GetContent());
+            return out.has_value() ? *out : defValue;
+        }
+    protected:
+        std::span<const xml::Tag::Ref> children;
+        xml::NameTable::NameId nameId;
+        size_t idxCurrent = 0;
+    };
+
     class XMLDecoder : public BaseDecoder {
     public:
         XMLDecoder() = default;
         XMLDecoder(const std::string &data);
         XMLDecoder(IReader::Ref instream);
+        // Reads an already parsed document, the document must outlive the decoder.
+        // Decoders don't modify the document - any number of them can read the same document concurrently.
+        explicit XMLDecoder(const xml::Document &document);
         virtual ~XMLDecoder() = default;
 
         bool Unmarshal(IUnmarshal *rootObject) override;
 
-        void Begin(IReader::Ref incoming) override {
-            // FIXME: Not supported..
-        }
+        // The stream is parsed through a window, there is no need to read it all first
+        void Begin(IReader::Ref incoming) override;
 
         void Begin(const std::string &xmldata);
 
+        // Streaming mode, no document is built. 'Unmarshal' is driven by the parser events - fields are set as they are
+        // parsed and elements nobody asked for are skipped without being decoded.
+        void BeginStream(IReader::Ref incoming);
+
+        // Iterates the children of the current object named 'name', within it 'BeginObject' enters the current item
+        ArrayIterator::Ref BeginArray(const std::string &name) override;
+        void EndArray() override;
 
 
         bool BeginObject(const std::string &name) override;
@@ -37,12 +133,37 @@ namespace gnilk {
         std::optional<float> ReadFloatField(const std::string &name) override;
         std::optional<std::string> ReadTextField(const std::string &name) override;
     protected:
-        bool TraverseFrom(const xml::Tag::Ref tag, IUnmarshal *pObject);
+        bool TraverseFrom(const xml::Tag *tag, IUnmarshal *pObject);
+        void UnmarshalAttributes(IUnmarshal *pObject, std::span<const xml::Attribute> attributes);
+        void UnmarshalLeaf(IUnmarshal *pObject, std::string_view name, std::string_view content);
+        bool UnmarshalChild(IUnmarshal *pObject, xml::Tag::Ref childTag, bool isListItem);
+        bool UnmarshalStream(IUnmarshal *rootObject);
         bool Initialize();
+        bool Initialize(std::unique_ptr<xml::Document> parsed);
     protected:
         std::string docData = {};
-        std::unique_ptr<xml::Document> doc;
-        std::stack<xml::Tag::Ref> tagStack;
+        // Only set when we parsed the document ourselves
+        std::unique_ptr<xml::Document> ownedDoc;
+        const xml::Document *doc = nullptr;
+        std::stack<const xml::Tag *, std::vector<const xml::Tag *>> tagStack;
+        struct OpenArray {
+            XMLArrayIterator::Ref iterator;
+            // objects begun at this depth are items of the array
+            size_t depth;
+        };
+        std::vector<OpenArray> arrayStack;
+        // child names of an object and if the object wants them as a list (see IUnmarshal::ReserveArray)
+        struct ListName {
+            xml::NameTable::NameId nameId;
+            bool isList;
+        };
+        // names and values passed to the IUnmarshal callbacks, reused so lists don't allocate per element
+        std::string fieldName;
+        std::string fieldValue;
+        // Only in streaming mode
+        IReader::Ref streamIn = {};
+    private:
+        class StreamHandler;
     };
 
 }
@@ -5,6 +5,8 @@
 #include <utility>
 #include <assert.h>
 #include "XMLEncoder.h"
+#include "EncoderHelpers.h"
+#include "XMLEntities.h"
 
 using namespace gnilk;
 
@@ -37,12 +39,14 @@ void XMLEncoder::WriteEnvelope() {
     }
 }
 void XMLEncoder::BeginObject(const std::string &name) {
-    assert(!name.empty());
+    auto &elementName = ElementName(name);
+    assert(!elementName.empty());
     WriteEnvelope();
-    ss << spacing() << begintag << name << endtag << eol;
+    ss << spacing() << begintag << elementName << endtag << eol;
 
-    objectStack.push_back(name);
+    objectStack.push_back(elementName);
     fieldStack.push_back(fieldCount);
+    scopeIsArray.push_back(false);
     fieldCount = 0;
 }
 
@@ -73,32 +77,35 @@ void XMLEncoder::SingleObject(const std::string &name, const std::vector<Encoder
 }
 
 void XMLEncoder::BeginObjectImpl(const std::string &name, const std::vector<EncoderObjectAttribute > &attributes) {
-    assert(!name.empty());
+    auto &elementName = ElementName(name);
+    assert(!elementName.empty());
 
     WriteEnvelope();
-    ss << spacing() << begintag << name;
+    ss << spacing() << begintag << elementName;
     if (attributes.size() > 0) {
         for (auto &attr : attributes) {
             ss << xmlspace;
-            ss << attr.name << xmlequals << xmlquote << EncoderObjectAttribute::ToString(attr) << xmlquote;
+            ss << attr.name << xmlequals << xmlquote << xml::Escape(EncoderObjectAttribute::ToString(attr), escaped, true) << xmlquote;
         }
     }
     ss << endtag << eol;
 
-    objectStack.push_back(name);
+    objectStack.push_back(elementName);
     fieldStack.push_back(fieldCount);
+    scopeIsArray.push_back(false);
     fieldCount = 0;
 
 }
 void XMLEncoder::SingleObjectImpl(const std::string &name, const std::vector<EncoderObjectAttribute > &attributes) {
-    assert(!name.empty());
+    auto &elementName = ElementName(name);
+    assert(!elementName.empty());
 
     WriteEnvelope();
-    ss << spacing() << begintag << name;
+    ss << spacing() << begintag << elementName;
     if (attributes.size() > 0) {
         for (auto &attr : attributes) {
             ss << xmlspace;
-            ss << attr.name << xmlequals << xmlquote << attr_value(attr) << xmlquote;
+            ss << attr.name << xmlequals << xmlquote << xml::Escape(attr_value(attr), escaped, true) << xmlquote;
         }
     }
     ss << singleendtag << eol;
@@ -111,23 +118,77 @@ void XMLEncoder::EndObject() {
 
     fieldCount = fieldStack.back();
     fieldStack.pop_back();
+    scopeIsArray.pop_back();
 
     ss << spacing() << beginendtag << name << endtag << eol;
 }
 
 void XMLEncoder::WriteBoolField(const std::string &name, bool value) {
-    ss << spacing() << begintag << name << endtag << std::to_string(value) << beginendtag << name << endtag << eol;
+    auto &elementName = ElementName(name);
+    ss << spacing() << begintag << elementName << endtag << std::to_string(value) << beginendtag << elementName << endtag << eol;
 }
 void XMLEncoder::WriteIntField(const std::string &name, int value) {
-    ss << spacing() << begintag << name << endtag << std::to_string(value) << beginendtag << name << endtag << eol;
+    auto &elementName = ElementName(name);
+    ss << spacing() << begintag << elementName << endtag << std::to_string(value) << beginendtag << elementName << endtag << eol;
 }
 void XMLEncoder::WriteInt64Field(const std::string &name, int64_t value) {
-    ss << spacing() << begintag << name << endtag << std::to_string(value) << beginendtag << name << endtag << eol;
+    auto &elementName = ElementName(name);
+    ss << spacing() << begintag << elementName << endtag << std::to_string(value) << beginendtag << elementName << endtag << eol;
 }
 void XMLEncoder::WriteFloatField(const std::string &name, double value) {
-    ss << spacing() << begintag << name << endtag << std::to_string(value) << beginendtag << name << endtag << eol;
+    auto &elementName = ElementName(name);
+    ss << spacing() << begintag << elementName << endtag << std::to_string(value) << beginendtag << elementName << endtag << eol;
 }
 void XMLEncoder::WriteTextField(const std::string &name, const std::string &value) {
-    ss << spacing() << begintag << name << endtag << value << beginendtag << name << endtag << eol;
+    auto &elementName = ElementName(name);
+    ss << spacing() << begintag << elementName << endtag << xml::Escape(value, escaped) << beginendtag << elementName << endtag << eol;
 }
 
+void XMLEncoder::BeginArray(const std::string &name) {
+    // Nested arrays without a name inherit the name of the enclosing array
+    arrayStack.push_back(ElementName(name));
+    scopeIsArray.push_back(true);
+}
+
+void XMLEncoder::EndArray() {
+    arrayStack.pop_back();
+    scopeIsArray.pop_back();
+}
+
+void XMLEncoder::WriteIntArray(const std::string &name, std::span<const int64_t> values) {
+    WriteArrayImpl(name, values);
+}
+
+void XMLEncoder::WriteDoubleArray(const std::string &name, std::span<const double> values) {
+    WriteArrayImpl(name, values);
+}
+
+// Formats all elements into one buffer and writes it in one go - no per-element virtual calls
+template<typename T>
+void XMLEncoder::WriteArrayImpl(const std::string &name, std::span<const T> values) {
+    auto &elementName = ElementName(name);
+    auto indent = spacing();
+
+    std::string out;
+    out.reserve(values.size() * (indent.size() + 2 * elementName.size() + eol.size() + 13));
+    for(auto &v : values) {
+        out += indent;
+        out += begintag;
+        out += elementName;
+        out += endtag;
+        append_to(out, v);
+        out += beginendtag;
+        out += elementName;
+        out += endtag;
+        out += eol;
+    }
+    ss << out;
+}
+
+// Element names within an array are taken from the array if not given
+const std::string &XMLEncoder::ElementName(const std::string &name) {
+    if (!name.empty() || scopeIsArray.empty() || !scopeIsArray.back()) {
+        return name;
+    }
+    return arrayStack.back();
+}
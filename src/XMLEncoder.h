@@ -39,11 +39,21 @@ namespace gnilk {
         void WriteFloatField(const std::string &name, double value) override;
         void WriteTextField(const std::string &name, const std::string &value) override;
 
+        // Arrays are written as repeated elements named after the array, there is no enclosing element
+        void BeginArray(const std::string &name) override;
+        void EndArray() override;
+
+        void WriteIntArray(const std::string &name, std::span<const int64_t> values) override;
+        void WriteDoubleArray(const std::string &name, std::span<const double> values) override;
+
     protected:
         void BeginObjectImpl(const std::string &name, const std::vector<EncoderObjectAttribute > &attributes);
         void SingleObjectImpl(const std::string &name, const std::vector<EncoderObjectAttribute > &attributes);
 
         void WriteEnvelope();
+        const std::string &ElementName(const std::string &name);
+        template<typename T>
+        void WriteArrayImpl(const std::string &name, std::span<const T> values);
     private:
         bool pretty = false;
         bool writeEnvelopeOnFirstObject = false;
@@ -51,7 +61,12 @@ namespace gnilk {
         StringWriter ss;
         std::vector<std::string> objectStack;
         std::vector<int> fieldStack;
+        // Name of each open array and whether the innermost scope is an array or an object
+        std::vector<std::string> arrayStack;
+        std::vector<bool> scopeIsArray;
         int fieldCount;
+        // text and attribute values needing escapes are escaped into this
+        std::string escaped;
 
 
     };
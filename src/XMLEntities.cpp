@@ -0,0 +1,151 @@
+//
+// Created by gnilk on 19.10.2026.
+//
+
+#include <stdint.h>
+#include "XMLEntities.h"
+
+using namespace gnilk;
+
+namespace {
+    enum kEscape : uint8_t {
+        kText = 1,          // & < >
+        kAttribute = 2,     // & < > " '
+    };
+
+    struct EscapeTable {
+        uint8_t classes[256] = {};
+        constexpr EscapeTable() {
+            for(auto ch : {'&', '<', '>'}) {
+                classes[static_cast<uint8_t>(ch)] = kText | kAttribute;
+            }
+            classes['\"'] = kAttribute;
+            classes['\''] = kAttribute;
+        }
+    };
+    constexpr EscapeTable escapeTable;
+
+    struct NamedEntity {
+        std::string_view name;
+        char ch;
+    };
+    constexpr NamedEntity namedEntities[] = {
+        {"amp", '&'}, {"lt", '<'}, {"gt", '>'}, {"quot", '\"'}, {"apos", '\''},
+    };
+}
+
+// Longest reference we bother to look for, '&#x10FFFF;'
+static constexpr size_t kMaxReference = 10;
+
+static void AppendUTF8(uint32_t cp, std::string &out) {
+    if (cp < 0x80) {
+        out += static_cast<char>(cp);
+    } else if (cp < 0x800) {
+        out += static_cast<char>(0xc0 | (cp >> 6));
+        out += static_cast<char>(0x80 | (cp & 0x3f));
+    } else if (cp < 0x10000) {
+        out += static_cast<char>(0xe0 | (cp >> 12));
+        out += static_cast<char>(0x80 | ((cp >> 6) & 0x3f));
+        out += static_cast<char>(0x80 | (cp & 0x3f));
+    } else {
+        out += static_cast<char>(0xf0 | (cp >> 18));
+        out += static_cast<char>(0x80 | ((cp >> 12) & 0x3f));
+        out += static_cast<char>(0x80 | ((cp >> 6) & 0x3f));
+        out += static_cast<char>(0x80 | (cp & 0x3f));
+    }
+}
+
+// 'ref' is the text between '&' and ';'
+static bool DecodeReference(std::string_view ref, std::string &out) {
+    if ((ref.size() > 1) && (ref[0] == '#')) {
+        bool isHex = (ref[1] == 'x') || (ref[1] == 'X');
+        auto digits = ref.substr(isHex ? 2 : 1);
+        if (digits.empty()) {
+            return false;
+        }
+        uint32_t cp = 0;
+        for(auto ch : digits) {
+            uint32_t digit;
+            if ((ch >= '0') && (ch <= '9')) {
+                digit = ch - '0';
+            } else if (isHex && (ch >= 'a') && (ch <= 'f')) {
+                digit = ch - 'a' + 10;
+            } else if (isHex && (ch >= 'A') && (ch <= 'F')) {
+                digit = ch - 'A' + 10;
+            } else {
+                return false;
+            }
+            cp = cp * (isHex ? 16 : 10) + digit;
+            if (cp > 0x10ffff) {
+                return false;
+            }
+        }
+        // no NUL and no surrogates
+        if ((cp == 0) || ((cp >= 0xd800) && (cp <= 0xdfff))) {
+            return false;
+        }
+        AppendUTF8(cp, out);
+        return true;
+    }
+    for(auto &entity : namedEntities) {
+        if (entity.name == ref) {
+            out += entity.ch;
+            return true;
+        }
+    }
+    return false;
+}
+
+void xml::DecodeReferences(std::string_view text, std::string &out) {
+    size_t pos = 0;
+    while(pos < text.size()) {
+        auto amp = static_cast<const char *>(memchr(text.data() + pos, '&', text.size() - pos));
+        if (amp == nullptr) {
+            break;
+        }
+        auto idxAmp = static_cast<size_t>(amp - text.data());
+        out.append(text.data() + pos, idxAmp - pos);
+        pos = idxAmp + 1;
+
+        auto semi = text.substr(pos, kMaxReference).find(';');
+        if ((semi != std::string_view::npos) && DecodeReference(text.substr(pos, semi), out)) {
+            pos += semi + 1;
+        } else {
+            out += '&';
+        }
+    }
+    out.append(text.data() + pos, text.size() - pos);
+}
+
+void xml::EscapeText(std::string_view text, std::string &out, bool isAttribute) {
+    auto mask = isAttribute ? kAttribute : kText;
+    size_t idxRun = 0;
+    for(size_t i = 0; i < text.size(); i++) {
+        auto ch = text[i];
+        if ((escapeTable.classes[static_cast<uint8_t>(ch)] & mask) == 0) {
+            continue;
+        }
+        out.append(text.data() + idxRun, i - idxRun);
+        idxRun = i + 1;
+        switch(ch) {
+            case '&' : out += "&amp;"; break;
+            case '<' : out += "&lt;"; break;
+            case '>' : out += "&gt;"; break;
+            case '\"' : out += "&quot;"; break;
+            case '\'' : out += "&apos;"; break;
+        }
+    }
+    out.append(text.data() + idxRun, text.size() - idxRun);
+}
+
+const std::string &xml::Escape(const std::string &text, std::string &scratch, bool isAttribute) {
+    auto mask = isAttribute ? kAttribute : kText;
+    for(size_t i = 0; i < text.size(); i++) {
+        if ((escapeTable.classes[static_cast<uint8_t>(text[i])] & mask) != 0) {
+            scratch.assign(text, 0, i);
+            EscapeText(std::string_view(text).substr(i), scratch, isAttribute);
+            return scratch;
+        }
+    }
+    return text;
+}
@@ -0,0 +1,37 @@
+//
+// Created by gnilk on 19.10.2026.
+//
+// Entity and character references, '&amp; &lt; &gt; &quot; &apos; &#NN; &#xNN;'.
+// Both directions look for the few special chars first and copy everything between them in bulk, text without any
+// costs one scan.
+//
+
+#ifndef GNILK_XMLENTITIES_H
+#define GNILK_XMLENTITIES_H
+
+#include <string>
+#include <string_view>
+#include <string.h>
+
+namespace gnilk {
+    namespace xml {
+        __inline bool HasReferences(std::string_view text) {
+            // memchr must not see the null data of an empty view
+            if (text.empty()) {
+                return false;
+            }
+            return (memchr(text.data(), '&', text.size()) != nullptr);
+        }
+
+        // Appends 'text' to 'out' with references replaced, unknown or malformed references are kept as they are
+        void DecodeReferences(std::string_view text, std::string &out);
+
+        // Appends 'text' to 'out' with '&', '<' and '>' escaped - and quotes when 'isAttribute' is set
+        void EscapeText(std::string_view text, std::string &out, bool isAttribute = false);
+
+        // 'text' itself if nothing needs escaping, otherwise the escaped text in 'scratch'
+        const std::string &Escape(const std::string &text, std::string &scratch, bool isAttribute = false);
+    }
+}
+
+#endif //GNILK_XMLENTITIES_H
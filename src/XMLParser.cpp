@@ -1,41 +1,123 @@
 // Implements a fairly speedy XML parser in less than 1000 lines of code
 #include <string>
 #include <cassert>
+#include <algorithm>
+#include <string.h>
 
 #include "XMLParser.h"
+#include "XMLEntities.h"
 
 using namespace gnilk::xml;
 
+namespace {
+    // Character classes - one table lookup instead of 'isspace' and chains of compares in the hot states
+    enum kCharClass : uint8_t {
+        kWhiteSpace = 1,
+        kTagNameEnd = 2,    // white space, '/' or '>'
+        kAttrNameEnd = 4,   // white space, '=', '/', '?' or '>'
+    };
+
+    struct CharClassTable {
+        uint8_t classes[256] = {};
+        constexpr CharClassTable() {
+            for(auto ch : {' ', '\t', '\n', '\v', '\f', '\r'}) {
+                classes[static_cast<uint8_t>(ch)] = kWhiteSpace | kTagNameEnd | kAttrNameEnd;
+            }
+            classes['/'] = kTagNameEnd | kAttrNameEnd;
+            classes['>'] = kTagNameEnd | kAttrNameEnd;
+            classes['='] = kAttrNameEnd;
+            classes['?'] = kAttrNameEnd;
+        }
+    };
+    constexpr CharClassTable charClassTable;
+}
+
+// EOF (-1) is not white space
+static __inline bool IsSpace(int c) {
+    return (c >= 0) && ((charClassTable.classes[c] & kWhiteSpace) != 0);
+}
+
 XMLParser::XMLParser(const std::string &_data) : data(_data) {
 }
 
 XMLParser::XMLParser(const std::string &_data, IParseEvents *eventHandler) : data(_data), pEventHandler(eventHandler) {
 }
 
+XMLParser::XMLParser(const std::string &_data, const ParseLimits &limits, IParseEvents *eventHandler) : data(_data), pEventHandler(eventHandler), guard(limits) {
+}
+
 std::unique_ptr<Document> XMLParser::Load(const std::string &_data, IParseEvents *pEventHandler) {
     XMLParser p(_data, pEventHandler);
     return p.GetDocument();
 }
 
+std::unique_ptr<Document> XMLParser::Load(const std::string &_data, const ParseLimits &limits, IParseEvents *pEventHandler) {
+    XMLParser p(_data, limits, pEventHandler);
+    return p.GetDocument();
+}
+
+XMLParser::XMLParser(IReader::Ref stream) : inStream(stream) {
+}
+
+XMLParser::XMLParser(IReader::Ref stream, IParseEvents *eventHandler) : inStream(stream), pEventHandler(eventHandler) {
+}
+
+XMLParser::XMLParser(IReader::Ref stream, const ParseLimits &limits, IParseEvents *eventHandler) : inStream(stream), pEventHandler(eventHandler), guard(limits) {
+}
+
+std::unique_ptr<Document> XMLParser::Load(IReader::Ref stream, IParseEvents *pEventHandler) {
+    XMLParser p(stream, pEventHandler);
+    return p.GetDocument();
+}
+
+std::unique_ptr<Document> XMLParser::Load(IReader::Ref stream, const ParseLimits &limits, IParseEvents *pEventHandler) {
+    XMLParser p(stream, limits, pEventHandler);
+    return p.GetDocument();
+}
+
+bool XMLParser::Parse(const std::string &_data, ISaxEvents &saxHandler, const ParseLimits &limits) {
+    XMLParser p(_data, limits);
+    p.SetParseMode(pmStream);
+    p.SetSaxHandler(&saxHandler);
+    return (p.GetDocument() != nullptr);
+}
+
+bool XMLParser::Parse(IReader::Ref stream, ISaxEvents &saxHandler, const ParseLimits &limits) {
+    XMLParser p(stream, limits);
+    p.SetParseMode(pmStream);
+    p.SetSaxHandler(&saxHandler);
+    return (p.GetDocument() != nullptr);
+}
+
 void XMLParser::Initialize() {
     attrName = "";
     attrValue = "";
     token = "";
 
     // FIXME: Why do I need this???
-    root = Tag::Create("root");
-    pDocument = std::make_unique<Document>();
-    pDocument->SetRoot(root);
+    if (pDocument == nullptr) {
+        pDocument = std::make_unique<Document>();
+    } else {
+        pDocument->Clear();
+    }
+    root = pDocument->NewTag("root");
+    pDocument->root = root;
+    tagCurrent = nullptr;
+    tagStack.clear();
+    pendingChildren.clear();
+    pendingAttributes.clear();
+    idxSkipDepth = 0;
+    isDeclaration = false;
     idxCurrent = 0;
+    guard.Reset();
     state =  psConsume;
-    parseMode = pmDOMBuild;
 }
 
 static void TraverseFrom(Tag::Ref tag, size_t depth) {
     std::string indent(depth, ' ');
-    printf("%s%s\n", indent.c_str(), tag->GetName().c_str());
+    printf("%s%.*s\n", indent.c_str(), (int)tag->GetName().size(), tag->GetName().data());
     for(auto &attr : tag->GetAttributes()) {
-        printf("  %s%s=%s\n", indent.c_str(), attr->GetName().c_str(), attr->GetValue().c_str());
+        printf("  %s%.*s=%.*s\n", indent.c_str(), (int)attr.GetName().size(), attr.GetName().data(), (int)attr.GetValue().size(), attr.GetValue().data());
     }
     for(auto &child : tag->GetChildren()) {
         TraverseFrom(child, depth+2);
@@ -52,10 +134,40 @@ std::unique_ptr<Document> XMLParser::GetDocument() {
     return std::move(pDocument);
 }
 
+const Document *XMLParser::Reparse(std::string_view newData) {
+    data = newData;
+    inStream = nullptr;
+    Initialize();
+    if (!DoParseData()) {
+        return nullptr;
+    }
+    return pDocument.get();
+}
+
 bool XMLParser::DoParseData() {
+    if (!BeginParse()) {
+        return false;
+    }
+    if (!ParseInput()) {
+        return false;
+    }
+    return EndParse();
+}
+
+bool XMLParser::BeginParse() {
+    tagStack.push_back({root, 0});
+    // All data is known up front, streams are counted as they are read
+    if ((inStream == nullptr) && !guard.OnBytes(data.size())) {
+        return false;
+    }
+    return true;
+}
+
+// Runs the state machine until the input ends or 'Suspend' is called (see XMLReader), false if a limit was hit
+bool XMLParser::ParseInput() {
     int c;
-    tagStack.push(root);
-    while ((c = NextChar()) != EOF) {
+    isSuspended = false;
+    while (!isSuspended && ((c = NextChar()) != EOF)) {
         switch (state) {
             case psConsume:
                 stateConsume(c);
@@ -91,11 +203,26 @@ bool XMLParser::DoParseData() {
                 stateDTDDocTypeContent(c);
                 break;
         }
+        // names, attribute values and content all build up in 'token'
+        if (!guard.CheckStringLength(token.size()) || guard.IsExceeded()) {
+            return false;
+        }
+    }
+    return !guard.IsExceeded();
+}
+
+bool XMLParser::EndParse() {
+    if (guard.IsExceeded()) {
+        return false;
     }
     // The error can probably be deduced from the state - but would be better if more robust..
     if (state != psConsume) {
         return false;
     }
+    // Tags left open (and the root) get their children
+    while(!tagStack.empty()) {
+        PopTag();
+    }
     return true;
 }
 
@@ -120,13 +247,15 @@ void XMLParser::stateConsume(int c) {
         }
         token = "";
     } else {
-        token += c;
+        // text outside of a tag is dropped once we see the '<' - don't bother collecting it
+        idxCurrent += FindInWindow('<');
     }
 }
 
 void XMLParser::stateCommentStart(int c) {
     if ((c == '-') && (PeekNextChar() == '-')) {
         NextChar();
+        commentText.clear();
         ChangeState(psCommentConsume);
     } else {
 #ifdef _DEBUG
@@ -140,33 +269,35 @@ void XMLParser::stateCommentStart(int c) {
 }
 
 void XMLParser::stateTagStart(int c) {
-    if (isspace(c)) {
-        tagCurrent = CreateTag(StringUtilStatic::trim(token));
+    if (IsSpace(c)) {
+        tagCurrent = CreateTag(StringUtilStatic::trimView(token));
         token = "";
         ChangeState(psTagAttributeName);
     } else if (c == '/' && PeekNextChar() == '>') {   // catch tags like '<tag/>'
         NextChar(); // consume '>'
-        tagCurrent = CreateTag(StringUtilStatic::trim(token));
+        tagCurrent = CreateTag(StringUtilStatic::trimView(token));
         token = "";
         CommitTag(tagCurrent);
+        NotifyEndTag(PopTag());
         ChangeState(psConsume);
     } else if (c == '>') {
-        tagCurrent = CreateTag(StringUtilStatic::trim(token));
+        tagCurrent = CreateTag(StringUtilStatic::trimView(token));
         token = "";
         ChangeState(psTagContent);
     } else {
         token += c;
+        AppendRun(kTagNameEnd);
     }
 
 }
 
 void XMLParser::stateEndTagStart(int c) {
-    if (isspace(c)) {
+    if (IsSpace(c)) {
         // drop them
     } else if (c == '>') {
-        std::string tmptok(StringUtilStatic::trim(token));
+        // the name is not needed once it has been matched
+        EndTag(StringUtilStatic::trimView(token));
         token = "";
-        EndTag(tmptok);
         ChangeState(psConsume);
     } else {
         token += c;
@@ -174,9 +305,10 @@ void XMLParser::stateEndTagStart(int c) {
 }
 
 void XMLParser::stateTagHeader(int c) {
-    if (isspace(c)) {
+    if (IsSpace(c)) {
         // drop them
-        tagCurrent = CreateTag(StringUtilStatic::trim(token));
+        tagCurrent = CreateTag(StringUtilStatic::trimView(token));
+        isDeclaration = true;
         token = "";
         ChangeState(psTagAttributeName);
     } else {
@@ -188,7 +320,9 @@ void XMLParser::stateCommentConsume(int c) {
     if ((c == '-') && (PeekNextChar() == '>')) {
         if (token == "-") {
             NextChar();
+            OnComment();
             ChangeState(psConsume);
+            return;
         }
     } else if ((c == 'D') && (PeekNextChar() == 'O')) {
         ChangeState(psDocType);
@@ -199,10 +333,27 @@ void XMLParser::stateCommentConsume(int c) {
     // } else if (c=='-') {
     //   token="-";  // Store this in order to track -->
     // }
+
+    // only SAX reports comments
+    if (pSaxHandler != nullptr) {
+        commentText += c;
+        guard.CheckStringLength(commentText.size());
+    }
+}
+
+void XMLParser::OnComment() {
+    if ((pSaxHandler == nullptr) || (idxSkipDepth != 0)) {
+        return;
+    }
+    // the first '-' of '-->' is still there
+    if (!commentText.empty()) {
+        commentText.pop_back();
+    }
+    pSaxHandler->Comment(StringUtilStatic::trim(commentText));
 }
 
 void XMLParser::stateAttributeName(int c) {
-    if (isspace(c)) return;
+    if (IsSpace(c)) return;
     if ((c == '=') && (PeekNextChar() == '"') || (PeekNextChar() == '\'')) {
         valueQuoteTerminationCharacter = NextChar(); // consume ' or "
         attrName = token;
@@ -212,9 +363,9 @@ void XMLParser::stateAttributeName(int c) {
         NextChar(); // consume #
         attrName = token;
         attrValue = "#";
-        tagCurrent->AddAttribute(attrName, attrValue);
+        AddAttribute();
         token = "";
-    } else if ((c == '=') && isspace(PeekNextChar())) {
+    } else if ((c == '=') && IsSpace(PeekNextChar())) {
         attrName = token;
         token = "";
         ChangeState(psTagAttributeValueStart);
@@ -224,21 +375,22 @@ void XMLParser::stateAttributeName(int c) {
     } else if ((c == '/') && (PeekNextChar() == '>')) {
         NextChar();
         CommitTag(tagCurrent);
-        EndTag(StringUtilStatic::trim(token));
+        EndTag(StringUtilStatic::trimView(token));
         token = "";
         ChangeState(psConsume);
     } else if ((c == '?') && (PeekNextChar() == '>')) {
         NextChar();
         CommitTag(tagCurrent);
-        EndTag(StringUtilStatic::trim(token));
+        EndTag(StringUtilStatic::trimView(token));
         token = "";
         ChangeState(psConsume);
     } else {
         token += c;
+        AppendRun(kAttrNameEnd);
     }
 }
 void XMLParser::stateAttributeValueStart(int c) {
-    if (isspace(c)) return;
+    if (IsSpace(c)) return;
     if ((c == '\"') || (c == '\'')) {
         valueQuoteTerminationCharacter = c;
         token = "";
@@ -247,25 +399,27 @@ void XMLParser::stateAttributeValueStart(int c) {
 }
 
 void XMLParser::stateAttributeValue(int c) {
-    // FIXME: This requires more elaborate parsing to be compliant (like support for &quot and escapes and stuff...)
+    // References ('&quot;' and friends) are decoded when the attribute is added
     if (c == valueQuoteTerminationCharacter) {
         attrValue = token;
-        tagCurrent->AddAttribute(attrName, attrValue);
+        AddAttribute();
         ChangeState(psTagAttributeName);
         token = "";
     } else {
         token += c;
+        AppendRunUntil(valueQuoteTerminationCharacter);
     }
 }
 
 void XMLParser::stateTagContent(int c) {
     if (c == '<') {    // can't use 'peekNext' since we might have >< which is legal
-        tagCurrent->SetContent(StringUtilStatic::trim(token));
+        SetContent(StringUtilStatic::trimView(token));
         token = "";
         ChangeState(psConsume);
         Rewind();    // rewind so we will see tag start next time
     } else {
         token += c;
+        AppendRunUntil('<');
     }
 }
 
@@ -276,18 +430,79 @@ void XMLParser::stateDTDDocTypeContent(int c) {
     }
 }
 
+//
+// Run scanning - the hot states append everything up to their next stop character in one go instead of going through
+// 'DoParseData' per character. Scans stay within the current window, the rest is picked up after the next refill.
+//
+
+// Number of chars until 'stop' (or the end of the window)
+size_t XMLParser::FindInWindow(int stop) const {
+    auto start = data.data() + idxCurrent;
+    auto nAvail = data.size() - idxCurrent;
+    // memchr is vectorized by the C library
+    auto pos = static_cast<const char *>(memchr(start, stop, nAvail));
+    return (pos == nullptr) ? nAvail : static_cast<size_t>(pos - start);
+}
+
+void XMLParser::AppendRunUntil(int stop) {
+    auto n = FindInWindow(stop);
+    token.append(data.data() + idxCurrent, n);
+    idxCurrent += n;
+}
+
+// Appends chars until one of class 'stopClass'
+void XMLParser::AppendRun(uint8_t stopClass) {
+    auto start = idxCurrent;
+    while((idxCurrent < data.size()) && ((charClassTable.classes[static_cast<uint8_t>(data[idxCurrent])] & stopClass) == 0)) {
+        idxCurrent++;
+    }
+    token.append(data.data() + start, idxCurrent - start);
+}
+
 void XMLParser::Rewind() {
     idxCurrent--;
 }
 
 int XMLParser::NextChar() {
-    if (idxCurrent >= (int) data.length()) return EOF;
-    return data.at(idxCurrent++);
+    if ((idxCurrent >= data.length()) && !Refill()) return EOF;
+    return static_cast<unsigned char>(data[idxCurrent++]);
 }
 
 int XMLParser::PeekNextChar() {
-    if (idxCurrent >= (int) data.length()) return EOF;
-    return data.at(idxCurrent);
+    if ((idxCurrent >= data.length()) && !Refill()) return EOF;
+    return static_cast<unsigned char>(data[idxCurrent]);
+}
+
+//
+// Moves the window forward, the last few chars are kept so 'Rewind' works across the boundary
+//
+bool XMLParser::Refill() {
+    if (inStream == nullptr) {
+        return false;
+    }
+    char history[kRewindHistory];
+    auto nKeep = std::min(idxCurrent, kRewindHistory);
+    if (nKeep > 0) {
+        memcpy(history, data.data() + idxCurrent - nKeep, nKeep);
+    }
+    if (windowBuffer.size() != windowSize) {
+        windowBuffer.resize(windowSize);
+    }
+    if (nKeep > 0) {
+        memcpy(windowBuffer.data(), history, nKeep);
+    }
+    data = {windowBuffer.data(), nKeep};
+    idxCurrent = nKeep;
+
+    auto nRead = inStream->Read(windowBuffer.data() + nKeep, windowBuffer.size() - nKeep);
+    if (nRead <= 0) {
+        return false;
+    }
+    if (!guard.OnBytes(static_cast<size_t>(nRead))) {
+        return false;
+    }
+    data = {windowBuffer.data(), nKeep + nRead};
+    return true;
 }
 
 void XMLParser::ChangeState(kParseState newState) {
@@ -295,45 +510,165 @@ void XMLParser::ChangeState(kParseState newState) {
     EnterNewState();
 }
 
-Tag::Ref XMLParser::CreateTag(const std::string &name) {
-    return Tag::Create(name);
+Tag *XMLParser::CreateTag(std::string_view name) {
+    guard.OnStep();
+    pendingAttributes.clear();
+    isDeclaration = false;
+    if (parseMode == pmDOMBuild) {
+        return pDocument->NewTag(name);
+    }
+    // a new tag at this depth means the previous one has ended - reuse it
+    auto depth = tagStack.size();
+    while(streamSlots.size() <= depth) {
+        streamSlots.push_back(std::make_unique<StreamSlot>());
+    }
+    auto &slot = *streamSlots[depth];
+    slot.arena.Clear();
+    // names are not interned, the table would grow with every distinct name in the stream
+    slot.tag.nameId = NameTable::kNoName;
+    slot.tag.name = slot.arena.StoreString(name);
+    slot.tag.content = {};
+    slot.tag.attributes = {};
+    slot.tag.children = {};
+    slot.tag.parent = nullptr;
+    return &slot.tag;
+}
+
+// Strings of a tag at 'depth' (the root is 0) go here
+gnilk::Arena &XMLParser::ArenaAt(size_t depth) {
+    if (parseMode == pmDOMBuild) {
+        return pDocument->arena;
+    }
+    return streamSlots[depth]->arena;
+}
+
+// Most text has no references, it is returned as is - otherwise the decoded text is held by 'decodedText'
+std::string_view XMLParser::DecodeReferences(std::string_view text) {
+    if (!HasReferences(text)) {
+        return text;
+    }
+    decodedText.clear();
+    xml::DecodeReferences(text, decodedText);
+    return decodedText;
+}
+
+// The current tag is not yet committed
+void XMLParser::AddAttribute() {
+    // nobody sees the attributes of a skipped element
+    if ((parseMode == pmStream) && (idxSkipDepth != 0) && (pEventHandler == nullptr)) {
+        return;
+    }
+    auto &arena = ArenaAt(tagStack.size());
+    std::string_view name;
+    if (parseMode == pmDOMBuild) {
+        auto &names = pDocument->names;
+        name = names.GetName(names.Intern(attrName));
+    } else {
+        name = arena.StoreString(attrName);
+    }
+    pendingAttributes.emplace_back(name, arena.StoreString(DecodeReferences(attrValue)));
+    guard.CheckAttributes(pendingAttributes.size());
 }
 
-void XMLParser::EndTag(std::string tok) {
+// The current tag is committed, and on top of the stack
+void XMLParser::SetContent(std::string_view content) {
+    content = DecodeReferences(content);
+    tagCurrent->content = ArenaAt(tagStack.size() - 1).StoreString(content);
+    if (pEventHandler != nullptr) {
+        pEventHandler->ContentTag(tagCurrent, std::string(content));
+    }
+    if ((pSaxHandler != nullptr) && (idxSkipDepth == 0) && !content.empty()) {
+        pSaxHandler->Content(tagCurrent->name, tagCurrent->content);
+    }
+}
+
+void XMLParser::EndTag(std::string_view tok) {
     Tag::Ref popped = nullptr;
-    if (!StringUtilStatic::equalsIgnoreCase(tagStack.top()->GetName(), tok)) {
-        auto top = tagStack.top();
+    // the root is never closed by an end tag
+    if (tagStack.size() < 2) {
+        return;
+    }
+    if (!IsSameName(tok, tagStack.back().tag)) {
         // can be an empty tag, like <br />
-        if (top->HasContent() == false) {
-            popped = tagStack.top();
-            tagStack.pop();
+        if (tagStack.back().tag->HasContent() == false) {
+            popped = PopTag();
         } else {
 #ifdef _DEBUG
             printf("WARN: Illegal XML, end-tag has no corrsponding start tag!\n");
 #endif
         }
     } else {
-        if (!tagStack.empty()) {
-            popped = tagStack.top();
-            tagStack.pop();
-        }
+        popped = PopTag();
     }
 
-    if ((pEventHandler != nullptr) && (popped != nullptr)) {
-        pEventHandler->EndTag(popped);
+    if (popped != nullptr) {
+        NotifyEndTag(popped);
     }
 }
 
-void XMLParser::CommitTag(Tag::Ref pTag) {
+// ASCII only, like the name table
+static char FoldChar(char ch) {
+    return ((ch >= 'A') && (ch <= 'Z')) ? static_cast<char>(ch - 'A' + 'a') : ch;
+}
+
+// Case insensitive, the name table knows the lower case form of every name - stream mode tags have no id
+bool XMLParser::IsSameName(std::string_view endName, const Tag *pTag) const {
+    if (pTag->nameId != NameTable::kNoName) {
+        auto &names = pDocument->names;
+        return names.FindFolded(endName) == names.GetFolded(pTag->nameId);
+    }
+    return std::equal(endName.begin(), endName.end(), pTag->name.begin(), pTag->name.end(), [](char a, char b) {
+        return FoldChar(a) == FoldChar(b);
+    });
+}
+
+void XMLParser::CommitTag(Tag *pTag) {
+    pTag->attributes = ArenaAt(tagStack.size()).StoreRange(std::span<const Attribute>(pendingAttributes));
+    pendingAttributes.clear();
+    pTag->parent = tagStack.back().tag;
     if (pEventHandler != nullptr) {
         pEventHandler->StartTag(pTag);
     }
+    if ((pSaxHandler != nullptr) && (idxSkipDepth == 0) && !isDeclaration) {
+        if (!pSaxHandler->StartElement(pTag->name, pTag->attributes)) {
+            idxSkipDepth = tagStack.size();
+        }
+    }
     // Only store in hierarchy if we are building a 'DOM' tree
     if (parseMode == pmDOMBuild) {
-        pTag->SetParent(tagStack.top());
-        tagStack.top()->AddChild(pTag);
+        pendingChildren.push_back(pTag);
+        guard.CheckMembers(pendingChildren.size() - tagStack.back().idxFirstChild);
+    }
+    // the stack always holds the (implicit) root
+    guard.CheckDepth(tagStack.size());
+    tagStack.push_back({pTag, pendingChildren.size()});
+}
+
+// 'pTag' was just popped
+void XMLParser::NotifyEndTag(Tag::Ref pTag) {
+    if (pEventHandler != nullptr) {
+        pEventHandler->EndTag(pTag);
+    }
+    if (idxSkipDepth != 0) {
+        if (tagStack.size() == idxSkipDepth) {
+            idxSkipDepth = 0;
+        }
+        return;
+    }
+    if ((pSaxHandler != nullptr) && !isDeclaration) {
+        pSaxHandler->EndElement(pTag->name);
+    }
+}
+
+// The children collected while the tag was open are copied to the document as one array
+Tag *XMLParser::PopTag() {
+    auto open = tagStack.back();
+    tagStack.pop_back();
+    if (parseMode == pmDOMBuild) {
+        open.tag->children = pDocument->arena.StoreRange(std::span<const Tag::Ref>(pendingChildren).subspan(open.idxFirstChild));
+        pendingChildren.resize(open.idxFirstChild);
     }
-    tagStack.push(pTag);
+    return open.tag;
 }
 
 void XMLParser::EnterNewState() {
@@ -345,131 +680,245 @@ void XMLParser::EnterNewState() {
 
 //////////////////
 // Tag implementation
-Tag::Tag(const std::string &_name) : name(_name) {
-    content.clear();
-    parent = nullptr;
+bool Tag::HasContent() const {
+    return (!content.empty());
 }
 
-void Tag::AddAttribute(const std::string &_name, const std::string &_value) {
-    attributes.push_back(Attribute::Create(_name, _value));
+
+std::string Tag::ToString() const {
+    return std::string(name) + " (" + std::string(content) + ")";
 }
 
-void Tag::AddChild(Tag::Ref tag) {
-    assert((tag->GetParent() != nullptr));
-    children.push_back(tag);
+bool Tag::HasAttribute(std::string_view attrName) const {
+    for(auto &attribute : attributes) {
+        if (attribute.GetName() == attrName) return true;
+    }
+    return false;
 }
 
-void Tag::SetParent(Tag::Ref tag) {
-    parent = std::move(tag);
+std::string_view Tag::GetAttributeValue(std::string_view attrName, std::string_view defValue) const {
+    for(auto &attribute : attributes) {
+        if (attribute.GetName() == attrName) {
+            return attribute.GetValue();
+        }
+    }
+    return defValue;
 }
 
-Tag::Ref Tag::GetParent() {
-    return parent;
+Tag::Ref Tag::GetFirstChild(std::string_view childName) const {
+    for(auto &child : children) {
+        if (child->GetName() == childName) return child;
+    }
+    return nullptr;
 }
 
+Tag::Ref Tag::GetFirstChild(NameId childNameId) const {
+    for(auto &child : children) {
+        if (child->nameId == childNameId) return child;
+    }
+    return nullptr;
+}
 
-bool Tag::HasContent() {
-    return (!content.empty());
+// Get a child with a specific attribute and value
+Tag::Ref Tag::GetChildWithAttributeValue(std::string_view childName, std::string_view attribute, std::string_view value) const {
+    for(auto &child : children) {
+        if (child->GetName() != childName) continue;
+        for(auto &attr : child->attributes) {
+            if ((attr.GetName() == attribute) && (attr.GetValue() == value)) {
+                return child;
+            }
+        }
+    }
+    return nullptr;
 }
 
+// -- Indexes
+ChildIndex::ChildIndex(const NameTable &names, Tag::Ref tag) {
+    byName.reserve(tag->GetChildren().size());
+    for(auto &child : tag->GetChildren()) {
+        byName.push_back({child->GetNameId(), child});
+        for(auto &attr : child->GetAttributes()) {
+            byAttribute.push_back({names.Find(attr.GetName()), attr.GetValue(), child});
+        }
+    }
+    // stable - equal keys stay in document order
+    std::stable_sort(byName.begin(), byName.end(), [](const NameEntry &a, const NameEntry &b) {
+        return a.nameId < b.nameId;
+    });
+    std::stable_sort(byAttribute.begin(), byAttribute.end(), [](const AttributeEntry &a, const AttributeEntry &b) {
+        return (a.nameId != b.nameId) ? (a.nameId < b.nameId) : (a.value < b.value);
+    });
+}
+
+std::span<const ChildIndex::NameEntry> ChildIndex::FindByName(NameTable::NameId nameId) const {
+    auto range = std::equal_range(byName.begin(), byName.end(), NameEntry{nameId, nullptr}, [](const NameEntry &a, const NameEntry &b) {
+        return a.nameId < b.nameId;
+    });
+    return {range.first, range.second};
+}
+
+std::span<const ChildIndex::AttributeEntry> ChildIndex::FindByAttribute(NameTable::NameId attrNameId, std::string_view value) const {
+    auto range = std::equal_range(byAttribute.begin(), byAttribute.end(), AttributeEntry{attrNameId, value, nullptr}, [](const AttributeEntry &a, const AttributeEntry &b) {
+        return (a.nameId != b.nameId) ? (a.nameId < b.nameId) : (a.value < b.value);
+    });
+    return {range.first, range.second};
+}
+
+DocumentIndex::DocumentIndex(Tag::Ref root) {
+    // pre-order without recursion, the subtree of a tag ends when it is popped
+    struct Open {
+        Tag::Ref tag;
+        uint32_t position;
+        size_t idxNextChild;
+    };
+    std::vector<Open> stack;
+    auto visit = [&](Tag::Ref tag) {
+        auto position = static_cast<uint32_t>(tags.size());
+        tags.push_back(tag);
+        subtreeEnd.push_back(position + 1);
+        byName.push_back({tag->GetNameId(), position});
+        positions[tag] = position;
+        stack.push_back({tag, position, 0});
+    };
+    visit(root);
+    while(!stack.empty()) {
+        auto &open = stack.back();
+        auto children = open.tag->GetChildren();
+        if (open.idxNextChild < children.size()) {
+            visit(children[open.idxNextChild++]);
+            continue;
+        }
+        subtreeEnd[open.position] = static_cast<uint32_t>(tags.size());
+        stack.pop_back();
+    }
+    std::stable_sort(byName.begin(), byName.end(), [](const NameEntry &a, const NameEntry &b) {
+        return a.nameId < b.nameId;
+    });
+}
 
-std::string Tag::ToString() {
-    return std::string(name + " (" + content + ")");
+uint32_t DocumentIndex::GetPosition(Tag::Ref tag) const {
+    auto it = positions.find(tag);
+    return (it == positions.end()) ? kNoPosition : it->second;
 }
 
-bool Tag::HasAttribute(const std::string &attrName) {
-    auto it = attributes.begin();
-    while (it != attributes.end()) {
-        auto pAttribute = *it;
-        if (pAttribute->GetName() == attrName) return true;
-        ++it;
+std::span<const DocumentIndex::NameEntry> DocumentIndex::FindByName(NameTable::NameId nameId, uint32_t first, uint32_t end) const {
+    auto less = [](const NameEntry &a, const NameEntry &b) {
+        return (a.nameId != b.nameId) ? (a.nameId < b.nameId) : (a.position < b.position);
+    };
+    auto itFirst = std::lower_bound(byName.begin(), byName.end(), NameEntry{nameId, first}, less);
+    auto itEnd = std::lower_bound(itFirst, byName.end(), NameEntry{nameId, end}, less);
+    return {itFirst, itEnd};
+}
 
+const ChildIndex &Document::GetChildIndex(Tag::Ref tag) const {
+    auto index = tag->childIndex.load(std::memory_order_acquire);
+    if (index != nullptr) {
+        return *index;
     }
-    return false;
+    std::lock_guard<std::mutex> lock(indexLock);
+    index = tag->childIndex.load(std::memory_order_relaxed);
+    if (index == nullptr) {
+        index = &childIndexes.emplace_back(names, tag);
+        tag->childIndex.store(index, std::memory_order_release);
+    }
+    return *index;
 }
 
-const std::string &Tag::GetAttributeValue(const std::string &attrName, const std::string &defValue) {
-    auto it = attributes.begin();
-    while (it != attributes.end()) {
-        auto pAttribute = *it;
-        if (pAttribute->GetName() == attrName) {
-            return pAttribute->GetValue();
-        }
-        ++it;
+const DocumentIndex &Document::GetDocumentIndex() const {
+    auto index = documentIndexReady.load(std::memory_order_acquire);
+    if (index != nullptr) {
+        return *index;
     }
-    return defValue;
+    std::lock_guard<std::mutex> lock(indexLock);
+    if (documentIndex == nullptr) {
+        documentIndex = std::make_unique<DocumentIndex>(root);
+        documentIndexReady.store(documentIndex.get(), std::memory_order_release);
+    }
+    return *documentIndex;
 }
 
-Tag::Ref Tag::GetFirstChild(const std::string &childName) {
-    auto it = children.begin();
-    while (it != children.end()) {
-        auto child = *it;
-        if (child->GetName() == childName) return child;
-        ++it;
+// -- Name table
+static constexpr size_t kMaxStackFold = 128;
+
+static void FoldCase(std::string_view name, char *out) {
+    for(size_t i = 0; i < name.size(); i++) {
+        out[i] = FoldChar(name[i]);
     }
-    return nullptr;
 }
 
-// Get a child with a specific attribute and value
-Tag::Ref Tag::GetChildWithAttributeValue(const std::string &childName, const std::string &attribute, const std::string &value) {
-    auto it = children.begin();
-    while(it != children.end()) {
-        auto child = *it;
-        if (child->GetName() != name) continue;
-        if (!child->HasAttribute(attribute)) continue;
-
-        auto chval = child->GetAttributeValue(attribute, "");
-        if (chval == value) {
-            return child;
-        }
-        ++it;
+NameTable::NameId NameTable::Intern(std::string_view name) {
+    auto it = ids.find(name);
+    if (it != ids.end()) {
+        return it->second;
     }
-    return nullptr;
+    // the lower case form goes first, it is its own folded id
+    std::string folded(name);
+    FoldCase(name, folded.data());
+    NameId idFolded;
+    if (folded == name) {
+        idFolded = static_cast<NameId>(entries.size());
+    } else {
+        idFolded = Intern(folded);
+    }
+    auto id = static_cast<NameId>(entries.size());
+    auto stored = arena.StoreString(name);
+    entries.push_back({stored, idFolded});
+    ids.emplace(stored, id);
+    return id;
 }
 
-// -- Document container
-Document::Document() {
-    root = nullptr;
+NameTable::NameId NameTable::Find(std::string_view name) const {
+    auto it = ids.find(name);
+    return (it == ids.end()) ? kNoName : it->second;
+}
+
+NameTable::NameId NameTable::FindFolded(std::string_view name) const {
+    // same spelling as a known name is the common case
+    auto id = Find(name);
+    if (id != kNoName) {
+        return entries[id].folded;
+    }
+    if (name.size() <= kMaxStackFold) {
+        char buffer[kMaxStackFold];
+        FoldCase(name, buffer);
+        return Find({buffer, name.size()});
+    }
+    std::string folded(name);
+    FoldCase(name, folded.data());
+    return Find(folded);
 }
 
-void Document::Traverse(const OnTagDelegate& startHandler, const OnTagDelegate &endHandler) {
+// -- Document container
+void Document::Traverse(const OnTagDelegate& startHandler, const OnTagDelegate &endHandler) const {
     TraverseNodes(startHandler, endHandler, root->GetChildren());
 }
 
-void Document::TraverseFromNode(const Tag::Ref& node, const OnTagDelegate& startHandler, const OnTagDelegate &endHandler) {
+void Document::TraverseFromNode(Tag::Ref node, const OnTagDelegate& startHandler, const OnTagDelegate &endHandler) const {
     TraverseNodes(startHandler, endHandler, node->GetChildren());
 }
 
 
-void Document::TraverseNodes(const OnTagDelegate& startHandler, const OnTagDelegate& endHandler, const std::list<Tag::Ref> &tags) {
-    auto it = tags.begin();
-    while (it != tags.end()) {
-        auto tag = *it;
+void Document::TraverseNodes(const OnTagDelegate& startHandler, const OnTagDelegate& endHandler, std::span<const Tag::Ref> nodes) const {
+    for(auto tag : nodes) {
         startHandler(tag, tag->GetAttributes());
         TraverseNodes(startHandler, endHandler, tag->GetChildren());
         endHandler(tag, tag->GetAttributes());
-        ++it;
     }
 }
 
-std::string Document::IndentString(int depth) {
+std::string Document::IndentString(int depth) const {
     std::string s = "";
     for (int i = 0; i < depth; i++) s += " ";
     return s;
 }
 
 // DEBUG HELPER!
-void Document::DumpTagTree(const Tag::Ref& fromNode, int depth) {
+void Document::DumpTagTree(Tag::Ref fromNode, int depth) const {
     std::string indent = IndentString(depth);
     //System.out.println(indent+"T:"+root->getName());
-    printf("%sT:%s\n", indent.c_str(), fromNode->GetName().c_str());
-    auto &tags = fromNode->GetChildren();
-
-    auto it = tags.begin();
-    while (it != tags.end()) {
-        auto child = *it;
+    printf("%sT:%.*s\n", indent.c_str(), (int)fromNode->GetName().size(), fromNode->GetName().data());
+    for(auto child : fromNode->GetChildren()) {
         DumpTagTree(child, depth + 2);
-        ++it;
     }
 }
 
@@ -3,10 +3,21 @@
 
 // Implements a fairly speedy XML parser
 #include <string>
-#include <list>
-#include <stack>
 #include <functional>
 #include <memory>
+#include <string_view>
+#include <span>
+#include <deque>
+#include <vector>
+#include <limits>
+#include <unordered_map>
+#include <atomic>
+#include <mutex>
+#include <stdint.h>
+
+#include "Arena.h"
+#include "IReader.h"
+#include "ParseLimits.h"
 
 namespace gnilk {
     namespace xml {
@@ -15,101 +26,228 @@ namespace gnilk {
         // Classes in reverse order - due to internal type-declaration...  sometimes I do dislike the C++ type system
         //
 
-        // Defines an attribute within an XML tag; like '<tag attribute="value" />'
-        class Attribute {
+        class XMLParser;
+        class Document;
+        class ChildIndex;
+
+        //
+        // Tag and attribute names of a document, each spelling is stored once and gets an id.
+        // Every spelling also knows the id of its lower case form, so case insensitive matching is an integer compare.
+        //
+        class NameTable {
         public:
-            using Ref = std::shared_ptr<Attribute>;
+            using NameId = uint32_t;
+            static constexpr NameId kNoName = std::numeric_limits<NameId>::max();
         public:
-            Attribute() = delete;
-            explicit Attribute(const std::string &_name, const std::string &_value) : name(_name), value(_value) {}
-
-            virtual ~Attribute() = default;
-
-            static Attribute::Ref Create(const std::string &_name, const std::string &_value) {
-                return std::make_shared<Attribute>(_name, _value);
-            }
+            NameTable() = default;
+            virtual ~NameTable() = default;
+
+            NameId Intern(std::string_view name);
+            // Exact spelling, kNoName if not in the table
+            NameId Find(std::string_view name) const;
+            // Any spelling, returns the folded id
+            NameId FindFolded(std::string_view name) const;
+
+            NameId GetFolded(NameId id) const { return entries[id].folded; }
+            std::string_view GetName(NameId id) const { return entries[id].name; }
+            size_t Size() const { return entries.size(); }
+        protected:
+            struct Entry {
+                std::string_view name;
+                NameId folded;
+            };
+            std::vector<Entry> entries;
+            std::unordered_map<std::string_view, NameId> ids;
+            Arena arena;
+        };
 
-            const std::string &GetName() { return name; }
-            void SetName(std::string &_name) { name = _name; }
+        // Defines an attribute within an XML tag; like '<tag attribute="value" />'
+        // The name and value are owned by the document.
+        class Attribute {
+        public:
+            Attribute() = default;
+            Attribute(std::string_view _name, std::string_view _value) : name(_name), value(_value) {}
 
-            const std::string &GetValue() { return value; }
-            void SetValue(std::string &_value) { value = _value; }
+            std::string_view GetName() const { return name; }
+            std::string_view GetValue() const { return value; }
         private:
-            std::string name;
-            std::string value;
+            std::string_view name = {};
+            std::string_view value = {};
         };
 
-        // defines a tag w/wo content and attributes
+        //
+        // Defines a tag w/wo content and attributes.
+        // Tags, their strings and their child/attribute arrays are all allocated by the Document they belong to, a tag
+        // handle is valid as long as the document lives. The parent is a plain back pointer.
+        //
         class Tag  {
+            friend XMLParser;
+            friend Document;
         public:
-            using Ref = std::shared_ptr<Tag>;
+            using Ref = const Tag *;
+            using NameId = NameTable::NameId;
         public:
-
-            static Tag::Ref Create(const std::string&_name) {
-                return std::make_shared<Tag>(_name);
-            }
-
-
             Tag() = delete;
-            explicit Tag(const std::string &_name);
+            Tag(std::string_view _name, NameId _nameId) : name(_name), nameId(_nameId) {}
             virtual ~Tag() = default;
 
-            bool HasContent();
-            std::string ToString();
-
-            void AddAttribute(const std::string &_name, const std::string &_value);
-            void AddChild(Tag::Ref tag);
-            void SetParent(Tag::Ref tag);
-            Tag::Ref GetParent();
+            bool HasContent() const;
+            std::string ToString() const;
 
-            const std::string &GetName() { return name; }
+            Tag::Ref GetParent() const { return parent; }
 
-            const std::string &GetContent() { return content; }
-            void SetContent(std::string &_content) { content = _content; }
+            std::string_view GetName() const { return name; }
+            // Id in the document NameTable, see Document::FindName
+            NameId GetNameId() const { return nameId; }
+            std::string_view GetContent() const { return content; }
 
-            bool HasAttribute(const std::string &attrName);
-            const std::string &GetAttributeValue(const std::string &attrName, const std::string &defValue);
-            std::list<Attribute::Ref> &GetAttributes() { return attributes; }
+            bool HasAttribute(std::string_view attrName) const;
+            std::string_view GetAttributeValue(std::string_view attrName, std::string_view defValue) const;
+            std::span<const Attribute> GetAttributes() const { return attributes; }
 
-            const std::list<Tag::Ref> &GetChildren() { return children; }
-            Tag::Ref GetFirstChild(const std::string &childName);
-            Tag::Ref GetChildWithAttributeValue(const std::string &childName, const std::string &attribute, const std::string &value);
+            std::span<const Tag::Ref> GetChildren() const { return children; }
+            Tag::Ref GetFirstChild(std::string_view childName) const;
+            Tag::Ref GetFirstChild(NameId childNameId) const;
+            Tag::Ref GetChildWithAttributeValue(std::string_view childName, std::string_view attribute, std::string_view value) const;
 
         private:
-            std::string name;
-            std::string content;
+            // Built on first use by Document::GetChildIndex
+            mutable std::atomic<const ChildIndex *> childIndex = nullptr;
+            std::string_view name = {};
+            NameId nameId = NameTable::kNoName;
+            std::string_view content = {};
+
+            std::span<const Attribute> attributes = {};
+            std::span<const Tag::Ref> children = {};
+            Tag::Ref parent = nullptr;
+        };
+
+        typedef std::function<void(Tag::Ref tag, std::span<const Attribute> attributes)> OnTagDelegate;
+
+        //
+        // Lookup tables over the children of one tag, children are found by name or attribute value without a scan.
+        // Ranges are sorted by key and in document order within a key.
+        //
+        class ChildIndex {
+        public:
+            struct NameEntry {
+                NameTable::NameId nameId;
+                Tag::Ref child;
+            };
+            struct AttributeEntry {
+                NameTable::NameId nameId;
+                std::string_view value;
+                Tag::Ref child;
+            };
+        public:
+            ChildIndex(const NameTable &names, Tag::Ref tag);
+            virtual ~ChildIndex() = default;
 
-            std::list<Attribute::Ref> attributes;
-            std::list<Tag::Ref> children;
-            Tag::Ref parent;
+            std::span<const NameEntry> FindByName(NameTable::NameId nameId) const;
+            // Children with the attribute 'attrNameId' set to 'value'
+            std::span<const AttributeEntry> FindByAttribute(NameTable::NameId attrNameId, std::string_view value) const;
+        protected:
+            std::vector<NameEntry> byName;
+            std::vector<AttributeEntry> byAttribute;
         };
 
-        typedef std::function<void(Tag::Ref tag, std::list<Attribute::Ref> &attributes)> OnTagDelegate;
+        //
+        // Every tag of a document by position in document order, the descendants of the tag at 'position' are the
+        // positions after it up to 'GetSubtreeEnd(position)'.
+        //
+        class DocumentIndex {
+        public:
+            static constexpr uint32_t kNoPosition = std::numeric_limits<uint32_t>::max();
+            struct NameEntry {
+                NameTable::NameId nameId;
+                uint32_t position;
+            };
+        public:
+            explicit DocumentIndex(Tag::Ref root);
+            virtual ~DocumentIndex() = default;
 
+            Tag::Ref At(uint32_t position) const { return tags[position]; }
+            size_t Size() const { return tags.size(); }
+            // kNoPosition if the tag isn't part of the document
+            uint32_t GetPosition(Tag::Ref tag) const;
+            uint32_t GetSubtreeEnd(uint32_t position) const { return subtreeEnd[position]; }
 
-        // Document container
+            // Tags named 'nameId' within [first, end)
+            std::span<const NameEntry> FindByName(NameTable::NameId nameId, uint32_t first, uint32_t end) const;
+        protected:
+            std::vector<Tag::Ref> tags;
+            std::vector<uint32_t> subtreeEnd;
+            std::vector<NameEntry> byName;
+            std::unordered_map<Tag::Ref, uint32_t> positions;
+        };
+
+
+        // Document container, owns all tags and strings - they are released together with the document
         class Document {
+            friend XMLParser;
         public:
             using Ref = std::shared_ptr<Document>;
         public:
-            Document();
+            Document() = default;
             virtual ~Document() = default;
 
+            Document(const Document &) = delete;
+            Document &operator=(const Document &) = delete;
+
             static Document::Ref Create() {
                 return std::make_shared<Document>();
             }
 
-            Tag::Ref GetRoot() { return root; };
+            // Documents are not modified once parsed, share a const document between threads and read it through
+            // one XMLDecoder per thread
+            Tag::Ref GetRoot() const { return root; };
+
+            void Traverse(const OnTagDelegate &startHandler, const OnTagDelegate &endHandler) const;
+            void TraverseFromNode(Tag::Ref node, const OnTagDelegate &startHandler, const OnTagDelegate &endHandler) const;
+            void DumpTagTree(Tag::Ref root, int depth) const;
+
+            // Bytes held by the document arena (values, content and the child/attribute arrays)
+            size_t GetArenaSize() const {
+                return arena.Size();
+            }
+
+            // Id of a tag or attribute name (exact spelling), kNoName if no tag/attribute has it
+            NameTable::NameId FindName(std::string_view name) const {
+                return names.Find(name);
+            }
+            const NameTable &GetNames() const {
+                return names;
+            }
 
-            void Traverse(const OnTagDelegate &startHandler, const OnTagDelegate &endHandler);
-            void TraverseFromNode(const Tag::Ref &node, const OnTagDelegate &startHandler, const OnTagDelegate &endHandler);
-            void SetRoot(Tag::Ref pRoot) { root = pRoot; }
-            void DumpTagTree(const Tag::Ref &root, int depth);
+            // Indexes are built on first use and kept with the document, building them is thread safe
+            const ChildIndex &GetChildIndex(Tag::Ref tag) const;
+            const DocumentIndex &GetDocumentIndex() const;
         protected:
-            void TraverseNodes(const OnTagDelegate &startHandler, const OnTagDelegate &endHandler, const std::list<Tag::Ref> &tags);
-            std::string IndentString(int depth);
+            // Drops all tags and indexes, names and one arena block are kept for reuse (see XMLParser::Reparse)
+            void Clear() {
+                root = nullptr;
+                tags.clear();
+                arena.Clear();
+                childIndexes.clear();
+                documentIndex = nullptr;
+                documentIndexReady = nullptr;
+            }
+            Tag *NewTag(std::string_view name) {
+                auto id = names.Intern(name);
+                return &tags.emplace_back(names.GetName(id), id);
+            }
+            void TraverseNodes(const OnTagDelegate &startHandler, const OnTagDelegate &endHandler, std::span<const Tag::Ref> nodes) const;
+            std::string IndentString(int depth) const;
         protected:
-            Tag::Ref root;
+            Tag *root = nullptr;
+            std::deque<Tag> tags;
+            NameTable names;
+            Arena arena;
+
+            mutable std::mutex indexLock;
+            mutable std::deque<ChildIndex> childIndexes;
+            mutable std::unique_ptr<DocumentIndex> documentIndex;
+            mutable std::atomic<const DocumentIndex *> documentIndexReady = nullptr;
         };
 
         // If you want to use 'event based' parsing - you can supply this to either CTOR or Load in the parser.
@@ -122,11 +260,39 @@ namespace gnilk {
             virtual void ContentTag(Tag::Ref pTag, const std::string &content) = 0;
         };
 
+        //
+        // SAX callbacks, nothing is allocated per element. Names, attributes and content are borrowed and only valid
+        // during the call. The '<?xml ...?>' declaration is not reported.
+        //
+        class ISaxEvents {
+        public:
+            virtual ~ISaxEvents() = default;
+            // Return false to skip the element - no further events until it has ended (not even its EndElement)
+            virtual bool StartElement(std::string_view name, std::span<const Attribute> attributes) = 0;
+            virtual void EndElement(std::string_view name) {}
+            // Leading text of an element, trimmed
+            virtual void Content(std::string_view name, std::string_view content) {}
+            // Text of a '<!-- -->' comment, trimmed
+            virtual void Comment(std::string_view text) {}
+        };
+
         //
         // XMLParser, use CTOR or 'Load' function to parse a document
         // Either call the static function 'Load' or use CTOR+GetDocument to retrieve parse it...
         //
+        // Streams are read through a window which is refilled as the parser moves along, only the window (and the
+        // document being built) is held in memory. Use 'pmStream' with an event handler to not build a document at all.
+        //
+        class XMLReader;
+
         class XMLParser {
+            friend XMLReader;
+        public:
+            enum kParseMode {
+                pmStream,       // only events, no document is built
+                pmDOMBuild,
+            };
+            static constexpr size_t kDefaultWindowSize = 64 * 1024;
         protected:
             enum kParseState {
                 psConsume,
@@ -141,28 +307,66 @@ namespace gnilk {
                 psCommentConsume,
                 psDocType,
             };
-            // This is not used...
-            enum kParseMode {
-                pmStream,
-                pmDOMBuild,
-            };
             /////////
         public:
+            // No input, use with 'Reparse'
+            XMLParser() = default;
             XMLParser(const std::string &_data);
             XMLParser(const std::string &_data, IParseEvents *pEventHandler);
+            XMLParser(const std::string &_data, const ParseLimits &limits, IParseEvents *pEventHandler = nullptr);
             std::unique_ptr<Document> GetDocument();
+            // Parses 'newData' into the document held by this parser, the parser and the document (tags, names and
+            // arena) are reused between calls. The document is valid until the next call, null on error.
+            const Document *Reparse(std::string_view newData);
 
             static std::unique_ptr<Document> Load(const std::string &_data, IParseEvents *pEventHandler = nullptr);
+            static std::unique_ptr<Document> Load(const std::string &_data, const ParseLimits &limits, IParseEvents *pEventHandler = nullptr);
+
+            explicit XMLParser(IReader::Ref stream);
+            XMLParser(IReader::Ref stream, IParseEvents *pEventHandler);
+            XMLParser(IReader::Ref stream, const ParseLimits &limits, IParseEvents *pEventHandler = nullptr);
+            static std::unique_ptr<Document> Load(IReader::Ref stream, IParseEvents *pEventHandler = nullptr);
+            static std::unique_ptr<Document> Load(IReader::Ref stream, const ParseLimits &limits, IParseEvents *pEventHandler = nullptr);
+
+            // SAX parsing in pmStream mode, memory is the window plus one tag per level of nesting
+            static bool Parse(const std::string &_data, ISaxEvents &saxHandler, const ParseLimits &limits = {});
+            static bool Parse(IReader::Ref stream, ISaxEvents &saxHandler, const ParseLimits &limits = {});
+
+            // Call before 'GetDocument'
+            void SetParseMode(kParseMode newParseMode) { parseMode = newParseMode; }
+            void SetWindowSize(size_t newWindowSize) { windowSize = (newWindowSize < kMinWindowSize) ? kMinWindowSize : newWindowSize; }
+            void SetSaxHandler(ISaxEvents *newSaxHandler) { pSaxHandler = newSaxHandler; }
+
+            // The limit which made the last parse fail, kNone if none
+            ParseLimits::kLimit GetExceededLimit() const {
+                return guard.GetExceeded();
+            }
         protected:
             void Initialize();
             bool DoParseData();
+            bool BeginParse();
+            bool ParseInput();
+            bool EndParse();
+            void Suspend() { isSuspended = true; }
             void ChangeState(kParseState newState);
-            Tag::Ref CreateTag(const std::string &name);
-            void EndTag(std::string tok);
-            void CommitTag(Tag::Ref pTag);
+            Tag *CreateTag(std::string_view name);
+            Arena &ArenaAt(size_t depth);
+            void AddAttribute();
+            void SetContent(std::string_view content);
+            std::string_view DecodeReferences(std::string_view text);
+            void NotifyEndTag(Tag::Ref pTag);
+            void OnComment();
+            void EndTag(std::string_view tok);
+            bool IsSameName(std::string_view endName, const Tag *pTag) const;
+            void CommitTag(Tag *pTag);
+            Tag *PopTag();
             void Rewind();
             int NextChar();
             int PeekNextChar();
+            bool Refill();
+            size_t FindInWindow(int stop) const;
+            void AppendRunUntil(int stop);
+            void AppendRun(uint8_t stopClass);
             void EnterNewState();
         protected:
             __inline void stateConsume(int c);
@@ -178,23 +382,53 @@ namespace gnilk {
             __inline void stateDTDDocTypeContent(int c);
         protected:
             // Global parsing stuff
-            Tag::Ref tagCurrent = {};
+            Tag *tagCurrent = {};
             std::string attrName = {};
             std::string attrValue = {};
 
         protected:
             std::unique_ptr<Document> pDocument = {};
-            Tag::Ref root = {};
+            Tag *root = {};
             kParseState state = {};
             kParseState stateAfterWhiteSpace = {};
-            kParseMode parseMode = {};
-            std::stack<Tag::Ref> tagStack = {};
-            int idxCurrent = {};
-            const std::string &data;            // Set in CTOR
+            kParseMode parseMode = pmDOMBuild;
+            // Children of open tags are collected here and copied to the document when the tag ends
+            struct OpenTag {
+                Tag *tag;
+                size_t idxFirstChild;
+            };
+            std::vector<OpenTag> tagStack = {};
+            std::vector<Tag::Ref> pendingChildren = {};
+            // Attributes of the current tag, copied to the document when the tag is committed
+            std::vector<Attribute> pendingAttributes = {};
+            // pmStream has no document to hold the tags, there is one tag per depth and it is reused.
+            // The names live in the slot as well (the tags have no name id), memory doesn't grow with the stream.
+            struct StreamSlot {
+                Tag tag{std::string_view{}, NameTable::kNoName};
+                Arena arena;
+            };
+            std::vector<std::unique_ptr<StreamSlot>> streamSlots = {};
+            size_t idxCurrent = {};
+            // The input - either all of it (string) or the current window of the stream
+            std::string_view data = {};
+            IReader::Ref inStream = {};
+            std::string windowBuffer = {};
+            size_t windowSize = kDefaultWindowSize;
+            // Rewind goes at most this far back, it is kept when the window moves
+            static constexpr size_t kRewindHistory = 4;
+            static constexpr size_t kMinWindowSize = 2 * kRewindHistory;
             IParseEvents *pEventHandler = {};
+            ISaxEvents *pSaxHandler = {};
+            // stack index of the element being skipped, 0 (the root) when not skipping
+            size_t idxSkipDepth = 0;
+            bool isDeclaration = false;
+            bool isSuspended = false;
+            std::string commentText = {};
+            std::string decodedText = {};
             // parser variables
             std::string token = {};
             int valueQuoteTerminationCharacter = {};
+            ParseGuard guard = {};
         };
 
 
@@ -219,6 +453,16 @@ namespace gnilk {
                 return str;
             }
 
+            // No copies, the view is within 'str'
+            __inline static std::string_view trimView(std::string_view str, std::string_view trimChars = " \f\n\r\t\v") {
+                auto first = str.find_first_not_of(trimChars);
+                if (first == std::string_view::npos) {
+                    return {};
+                }
+                auto last = str.find_last_not_of(trimChars);
+                return str.substr(first, last - first + 1);
+            }
+
             __inline static std::string toLower(std::string s) {
                 std::string res = "";
                 for (size_t i = 0; i < s.length(); i++) {
@@ -227,10 +471,16 @@ namespace gnilk {
                 return res;
             }
 
-            __inline static bool equalsIgnoreCase(std::string a, std::string b) {
-                std::string sa = toLower(a);
-                std::string sb = toLower(b);
-                return (sa == sb);
+            __inline static bool equalsIgnoreCase(std::string_view a, std::string_view b) {
+                if (a.size() != b.size()) {
+                    return false;
+                }
+                for(size_t i = 0; i < a.size(); i++) {
+                    if (tolower(static_cast<unsigned char>(a[i])) != tolower(static_cast<unsigned char>(b[i]))) {
+                        return false;
+                    }
+                }
+                return true;
             }
 
         };
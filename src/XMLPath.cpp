@@ -0,0 +1,244 @@
+//
+// Created by gnilk on 19.10.2026.
+//
+
+#include <algorithm>
+#include "XMLPath.h"
+
+using namespace gnilk;
+using namespace gnilk::xml;
+
+static size_t SkipSpace(std::string_view expr, size_t pos) {
+    while((pos < expr.size()) && ((expr[pos] == ' ') || (expr[pos] == '\t'))) {
+        pos++;
+    }
+    return pos;
+}
+
+// '.' and '..' (and names starting with them) are not supported
+static bool IsValidName(std::string_view name) {
+    return !name.empty() && (name[0] != '.') && (name.find_first_of("]=@'\" \t") == std::string_view::npos);
+}
+
+// static
+XMLPath::Ref XMLPath::Compile(std::string_view expression) {
+    auto path = std::make_shared<XMLPath>();
+    path->expression = expression;
+    path->isAbsolute = (!expression.empty() && (expression[0] == '/'));
+
+    size_t pos = 0;
+    while(pos < expression.size() || path->steps.empty()) {
+        Step step;
+        if (expression.substr(pos, 2) == "//") {
+            step.isDescendant = true;
+            pos += 2;
+        } else if ((pos < expression.size()) && (expression[pos] == '/')) {
+            pos += 1;
+        } else if (pos != 0) {
+            return {};
+        }
+
+        auto nameEnd = std::min(expression.find_first_of("/[", pos), expression.size());
+        step.name = expression.substr(pos, nameEnd - pos);
+        step.isWildcard = (step.name == "*");
+        if (!step.isWildcard && !IsValidName(step.name)) {
+            return {};
+        }
+        pos = nameEnd;
+
+        // '[@attr]' or '[@attr = 'value']'
+        while((pos < expression.size()) && (expression[pos] == '[')) {
+            Predicate predicate;
+            pos = SkipSpace(expression, pos + 1);
+            if ((pos >= expression.size()) || (expression[pos] != '@')) {
+                return {};
+            }
+            pos++;
+            auto attrEnd = std::min(expression.find_first_of("=] \t", pos), expression.size());
+            predicate.attribute = expression.substr(pos, attrEnd - pos);
+            if (!IsValidName(predicate.attribute)) {
+                return {};
+            }
+            pos = SkipSpace(expression, attrEnd);
+            if ((pos < expression.size()) && (expression[pos] == '=')) {
+                pos = SkipSpace(expression, pos + 1);
+                if ((pos >= expression.size()) || ((expression[pos] != '\'') && (expression[pos] != '\"'))) {
+                    return {};
+                }
+                auto valueEnd = expression.find(expression[pos], pos + 1);
+                if (valueEnd == std::string_view::npos) {
+                    return {};
+                }
+                predicate.value = expression.substr(pos + 1, valueEnd - pos - 1);
+                predicate.hasValue = true;
+                pos = SkipSpace(expression, valueEnd + 1);
+            }
+            if ((pos >= expression.size()) || (expression[pos] != ']')) {
+                return {};
+            }
+            pos++;
+            step.predicates.push_back(std::move(predicate));
+        }
+        path->steps.push_back(std::move(step));
+    }
+    return path;
+}
+
+std::vector<Tag::Ref> XMLPath::Select(const Document &doc, Tag::Ref context) const {
+    auto root = doc.GetRoot();
+    if (root == nullptr) {
+        return {};
+    }
+    std::vector<Tag::Ref> current;
+    current.push_back((isAbsolute || (context == nullptr)) ? root : context);
+
+    // after '//' the selected tags can contain each other, children of them are no longer in document order
+    bool mayNest = false;
+    std::vector<Tag::Ref> next;
+    BoundStep bound;
+    for(auto &step : steps) {
+        // a name the document doesn't have can't match anything
+        if (!Bind(doc, step, bound)) {
+            return {};
+        }
+        next.clear();
+        if (step.isDescendant) {
+            SelectDescendants(doc, bound, current, next);
+            mayNest = true;
+        } else {
+            SelectChildren(doc, bound, current, next);
+            if (mayNest && (next.size() > 1)) {
+                SortByPosition(doc, next);
+            }
+        }
+        std::swap(current, next);
+        if (current.empty()) {
+            break;
+        }
+    }
+    return current;
+}
+
+Tag::Ref XMLPath::SelectFirst(const Document &doc, Tag::Ref context) const {
+    auto tags = Select(doc, context);
+    return tags.empty() ? nullptr : tags.front();
+}
+
+bool XMLPath::Bind(const Document &doc, const Step &step, BoundStep &out) const {
+    out.step = &step;
+    out.nameId = NameTable::kNoName;
+    out.predicates.clear();
+    if (!step.isWildcard) {
+        out.nameId = doc.FindName(step.name);
+        if (out.nameId == NameTable::kNoName) {
+            return false;
+        }
+    }
+    for(auto &predicate : step.predicates) {
+        auto attrNameId = doc.FindName(predicate.attribute);
+        if (attrNameId == NameTable::kNoName) {
+            return false;
+        }
+        out.predicates.push_back({attrNameId, predicate.attribute, predicate.value, predicate.hasValue});
+    }
+    return true;
+}
+
+void XMLPath::SelectChildren(const Document &doc, const BoundStep &step, const std::vector<Tag::Ref> &contexts, std::vector<Tag::Ref> &out) const {
+    // an attribute value narrows the most, otherwise the name
+    const BoundPredicate *pKey = nullptr;
+    for(auto &predicate : step.predicates) {
+        if (predicate.hasValue) {
+            pKey = &predicate;
+            break;
+        }
+    }
+    bool useIndex = (pKey != nullptr) || !step.step->isWildcard;
+
+    for(auto context : contexts) {
+        auto children = context->GetChildren();
+        if (!useIndex || (children.size() < kIndexMinChildren)) {
+            for(auto &child : children) {
+                if (Matches(child, step)) {
+                    out.push_back(child);
+                }
+            }
+            continue;
+        }
+        auto &index = doc.GetChildIndex(context);
+        if (pKey != nullptr) {
+            for(auto &entry : index.FindByAttribute(pKey->attrNameId, pKey->value)) {
+                if (Matches(entry.child, step)) {
+                    out.push_back(entry.child);
+                }
+            }
+        } else {
+            for(auto &entry : index.FindByName(step.nameId)) {
+                if (Matches(entry.child, step)) {
+                    out.push_back(entry.child);
+                }
+            }
+        }
+    }
+}
+
+// 'contexts' are in document order, a context within the previous one adds nothing - which keeps the result in
+// document order without duplicates
+void XMLPath::SelectDescendants(const Document &doc, const BoundStep &step, const std::vector<Tag::Ref> &contexts, std::vector<Tag::Ref> &out) const {
+    auto &index = doc.GetDocumentIndex();
+    uint32_t coveredEnd = 0;
+    for(auto context : contexts) {
+        auto position = index.GetPosition(context);
+        if ((position == DocumentIndex::kNoPosition) || (position < coveredEnd)) {
+            continue;
+        }
+        auto first = position + 1;
+        coveredEnd = index.GetSubtreeEnd(position);
+        if (step.step->isWildcard) {
+            for(auto idx = first; idx < coveredEnd; idx++) {
+                if (Matches(index.At(idx), step)) {
+                    out.push_back(index.At(idx));
+                }
+            }
+            continue;
+        }
+        for(auto &entry : index.FindByName(step.nameId, first, coveredEnd)) {
+            auto tag = index.At(entry.position);
+            if (Matches(tag, step)) {
+                out.push_back(tag);
+            }
+        }
+    }
+}
+
+bool XMLPath::Matches(Tag::Ref tag, const BoundStep &step) {
+    if (step.step->isWildcard) {
+        // the '<?xml ?>' declaration is kept as a top level 'xml' tag, it is not an element
+        auto parent = tag->GetParent();
+        if ((parent != nullptr) && (parent->GetParent() == nullptr) && (tag->GetName() == "xml")) {
+            return false;
+        }
+    } else if (tag->GetNameId() != step.nameId) {
+        return false;
+    }
+    for(auto &predicate : step.predicates) {
+        auto attributes = tag->GetAttributes();
+        auto it = std::find_if(attributes.begin(), attributes.end(), [&predicate](const Attribute &attr) {
+            return attr.GetName() == predicate.attribute;
+        });
+        if (it == attributes.end()) {
+            return false;
+        }
+        if (predicate.hasValue && (it->GetValue() != predicate.value)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void XMLPath::SortByPosition(const Document &doc, std::vector<Tag::Ref> &tags) {
+    auto &index = doc.GetDocumentIndex();
+    std::sort(tags.begin(), tags.end(), [&index](Tag::Ref a, Tag::Ref b) {
+        return index.GetPosition(a) < index.GetPosition(b);
+    });
+}
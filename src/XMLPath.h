@@ -0,0 +1,88 @@
+//
+// Created by gnilk on 19.10.2026.
+//
+// Compiled XPath subset for xml::Document.
+//
+//   auto path = xml::XMLPath::Compile("/catalog/book[@id='bk101']/title");
+//   for(auto tag : path->Select(*doc)) {
+//       auto title = tag->GetContent();
+//   }
+//
+// Supported: absolute ('/a/b') and relative ('a/b') paths, descendants ('//item', 'a//b'), the wildcard '*' and
+// attribute predicates '[@id]' and "[@id='x']" (single or double quotes). Names are matched with their exact spelling.
+// Results are in document order without duplicates.
+//
+// Expressions are compiled once and can be used on any number of documents. Large tags (and '//') are looked up
+// through the document indexes (see Document::GetChildIndex), they are built on first use and reused by later queries.
+//
+
+#ifndef GNILK_XMLPATH_H
+#define GNILK_XMLPATH_H
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "XMLParser.h"
+
+namespace gnilk {
+    namespace xml {
+        class XMLPath {
+        public:
+            using Ref = std::shared_ptr<XMLPath>;
+            // Tags with fewer children are scanned, an index doesn't pay off
+            static constexpr size_t kIndexMinChildren = 16;
+        public:
+            XMLPath() = default;
+            virtual ~XMLPath() = default;
+
+            // Returns null if the expression is not valid (or not in the supported subset)
+            static Ref Compile(std::string_view expression);
+
+            // Relative paths start at 'context', or at the document root if there is no context
+            std::vector<Tag::Ref> Select(const Document &doc, Tag::Ref context = nullptr) const;
+            Tag::Ref SelectFirst(const Document &doc, Tag::Ref context = nullptr) const;
+
+            const std::string &GetExpression() const {
+                return expression;
+            }
+        protected:
+            struct Predicate {
+                std::string attribute;
+                std::string value;
+                bool hasValue = false;
+            };
+            struct Step {
+                bool isDescendant = false;
+                bool isWildcard = false;
+                std::string name;
+                std::vector<Predicate> predicates;
+            };
+            // A step with its names looked up in the document being queried
+            struct BoundPredicate {
+                NameTable::NameId attrNameId;
+                std::string_view attribute;
+                std::string_view value;
+                bool hasValue;
+            };
+            struct BoundStep {
+                const Step *step;
+                NameTable::NameId nameId;
+                std::vector<BoundPredicate> predicates;
+            };
+        protected:
+            bool Bind(const Document &doc, const Step &step, BoundStep &out) const;
+            void SelectChildren(const Document &doc, const BoundStep &step, const std::vector<Tag::Ref> &contexts, std::vector<Tag::Ref> &out) const;
+            void SelectDescendants(const Document &doc, const BoundStep &step, const std::vector<Tag::Ref> &contexts, std::vector<Tag::Ref> &out) const;
+            static bool Matches(Tag::Ref tag, const BoundStep &step);
+            static void SortByPosition(const Document &doc, std::vector<Tag::Ref> &tags);
+        protected:
+            std::string expression;
+            bool isAbsolute = false;
+            std::vector<Step> steps;
+        };
+    }
+}
+
+#endif //GNILK_XMLPATH_H
@@ -0,0 +1,153 @@
+//
+// Created by gnilk on 19.10.2026.
+//
+
+#include "XMLReader.h"
+
+using namespace gnilk::xml;
+
+XMLReader::XMLReader(const std::string &data, const ParseLimits &limits) : parser(data, limits) {
+    Begin();
+}
+
+XMLReader::XMLReader(IReader::Ref stream, const ParseLimits &limits) : parser(stream, limits) {
+    Begin();
+}
+
+void XMLReader::Begin() {
+    parser.SetParseMode(XMLParser::pmStream);
+    parser.SetSaxHandler(this);
+    parser.Initialize();
+    if (!parser.BeginParse()) {
+        current.event = kEvent::kError;
+    }
+}
+
+XMLReader::kEvent XMLReader::Next() {
+    if ((current.event == kEvent::kEndOfDocument) || (current.event == kEvent::kError)) {
+        return current.event;
+    }
+    // the depth counts the start element until we move past it
+    if (current.event == kEvent::kEndElement) {
+        depth--;
+    }
+    if (idxPending == pending.size()) {
+        pending.clear();
+        idxPending = 0;
+        if (!parser.ParseInput()) {
+            current = {kEvent::kError};
+            return current.event;
+        }
+        if (pending.empty()) {
+            current = {parser.EndParse() ? kEvent::kEndOfDocument : kEvent::kError};
+            return current.event;
+        }
+    }
+    current = pending[idxPending++];
+    if (current.event == kEvent::kStartElement) {
+        depth++;
+    }
+    return current.event;
+}
+
+bool XMLReader::HasAttribute(std::string_view attrName) const {
+    for(auto &attr : current.attributes) {
+        if (attr.GetName() == attrName) {
+            return true;
+        }
+    }
+    return false;
+}
+
+std::string_view XMLReader::GetAttribute(std::string_view attrName, std::string_view defValue) const {
+    for(auto &attr : current.attributes) {
+        if (attr.GetName() == attrName) {
+            return attr.GetValue();
+        }
+    }
+    return defValue;
+}
+
+bool XMLReader::SkipElement() {
+    if (current.event != kEvent::kStartElement) {
+        return false;
+    }
+    // Still open in the parser, let it skip without producing events - it won't report the end either
+    if (idxPending == pending.size()) {
+        parser.idxSkipDepth = parser.tagStack.size() - 1;
+        current = {kEvent::kEndElement, current.name};
+        return true;
+    }
+    // Already ended ('<tag/>'), the end is pending
+    size_t level = 1;
+    while(level > 0) {
+        auto event = Next();
+        if (event == kEvent::kStartElement) {
+            level++;
+        } else if (event == kEvent::kEndElement) {
+            level--;
+        } else if ((event == kEvent::kEndOfDocument) || (event == kEvent::kError)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::string_view XMLReader::ReadElementText() {
+    if (current.event != kEvent::kStartElement) {
+        return {};
+    }
+    auto name = current.name;
+    auto event = Next();
+    if (event == kEvent::kEndElement) {
+        return {};
+    }
+    std::string_view text = {};
+    if (event == kEvent::kText) {
+        // the text is held by the element, it stays valid until the next element on this level
+        text = current.text;
+        event = Next();
+    }
+    // child elements and comments
+    size_t level = 1;
+    while(true) {
+        if (event == kEvent::kStartElement) {
+            if (!SkipElement()) {
+                return {};
+            }
+        } else if (event == kEvent::kEndElement) {
+            if (--level == 0) {
+                break;
+            }
+        } else if ((event == kEvent::kEndOfDocument) || (event == kEvent::kError)) {
+            return {};
+        }
+        event = Next();
+    }
+    current.name = name;
+    return text;
+}
+
+//
+// Parser callbacks - the parser is suspended after each step producing an event
+//
+bool XMLReader::StartElement(std::string_view name, std::span<const Attribute> attributes) {
+    pending.push_back({kEvent::kStartElement, name, {}, attributes});
+    parser.Suspend();
+    return true;
+}
+
+void XMLReader::EndElement(std::string_view name) {
+    pending.push_back({kEvent::kEndElement, name});
+    parser.Suspend();
+}
+
+void XMLReader::Content(std::string_view name, std::string_view content) {
+    pending.push_back({kEvent::kText, name, content});
+    parser.Suspend();
+}
+
+void XMLReader::Comment(std::string_view text) {
+    pending.push_back({kEvent::kComment, {}, text});
+    parser.Suspend();
+}
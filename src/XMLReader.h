@@ -0,0 +1,97 @@
+//
+// Created by gnilk on 19.10.2026.
+//
+// Pull parser (cursor) for XML, runs the XMLParser state machine one event at a time without building a document.
+//
+//   xml::XMLReader reader(data);
+//   while(reader.Next() == xml::XMLReader::kEvent::kStartElement) {
+//       if (reader.GetName() == "item") {
+//           auto id = reader.GetAttribute("id");
+//           auto text = reader.ReadElementText();
+//       } else {
+//           reader.SkipElement();
+//       }
+//   }
+//
+// Names, attributes and text are views into the parser and valid until the next call to the reader.
+//
+
+#ifndef GNILK_XMLREADER_H
+#define GNILK_XMLREADER_H
+
+#include <string>
+#include <string_view>
+#include <span>
+#include <vector>
+
+#include "XMLParser.h"
+
+namespace gnilk {
+    namespace xml {
+        class XMLReader : protected ISaxEvents {
+        public:
+            enum class kEvent {
+                kNone,
+                kStartElement,
+                kEndElement,
+                kText,
+                kComment,
+                kEndOfDocument,
+                kError,
+            };
+        public:
+            // 'data' is not copied, it must outlive the reader
+            explicit XMLReader(const std::string &data, const ParseLimits &limits = {});
+            explicit XMLReader(IReader::Ref stream, const ParseLimits &limits = {});
+            virtual ~XMLReader() = default;
+
+            // Moves to the next event, kEndOfDocument/kError are sticky
+            kEvent Next();
+            kEvent GetEvent() const { return current.event; }
+
+            // Element name for start/end elements, the owning element for text
+            std::string_view GetName() const { return current.name; }
+            // Text or comment
+            std::string_view GetText() const { return current.text; }
+
+            std::span<const Attribute> GetAttributes() const { return current.attributes; }
+            bool HasAttribute(std::string_view attrName) const;
+            std::string_view GetAttribute(std::string_view attrName, std::string_view defValue = {}) const;
+
+            // Number of open elements, the current start element included
+            size_t GetDepth() const { return depth; }
+
+            // On a start element; skips to its end - nothing inside it is parsed into events.
+            // The reader is left on the (end element) of the skipped element.
+            bool SkipElement();
+            // On a start element; returns its text and moves to its end, child elements are skipped
+            std::string_view ReadElementText();
+
+            ParseLimits::kLimit GetExceededLimit() const {
+                return parser.GetExceededLimit();
+            }
+        protected:
+            bool StartElement(std::string_view name, std::span<const Attribute> attributes) override;
+            void EndElement(std::string_view name) override;
+            void Content(std::string_view name, std::string_view content) override;
+            void Comment(std::string_view text) override;
+        private:
+            void Begin();
+        private:
+            struct Event {
+                kEvent event = kEvent::kNone;
+                std::string_view name = {};
+                std::string_view text = {};
+                std::span<const Attribute> attributes = {};
+            };
+            XMLParser parser;
+            Event current = {};
+            // One step of the parser can produce more than one event, like '<tag/>'
+            std::vector<Event> pending = {};
+            size_t idxPending = 0;
+            size_t depth = 0;
+        };
+    }
+}
+
+#endif //GNILK_XMLREADER_H
@@ -0,0 +1,24 @@
+//
+// Created by gnilk on 19.10.2026.
+//
+// Test helper, collects everything written - so we can verify the output
+//
+
+#ifndef GNILK_TESTS_CAPTUREWRITER_H
+#define GNILK_TESTS_CAPTUREWRITER_H
+
+#include <string>
+#include "IWriter.h"
+
+namespace gnilk {
+    class CaptureWriter : public BaseWriter {
+    public:
+        int32_t Write(const void *data, size_t nbytes) override {
+            text.append(static_cast<const char *>(data), nbytes);
+            return static_cast<int32_t>(nbytes);
+        }
+        std::string text;
+    };
+}
+
+#endif //GNILK_TESTS_CAPTUREWRITER_H
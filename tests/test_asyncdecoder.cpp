@@ -0,0 +1,263 @@
+//
+// Created by gnilk on 19.10.2026.
+//
+// Async decoding over pipes and sockets, all streams are driven by one epoll loop on the test thread.
+//
+#include <testinterface.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <vector>
+#include <memory>
+
+#include "../src/JSONDecoder.h"
+#include "../src/XMLDecoder.h"
+#include "../src/IniDecoder.h"
+#include "../src/StringReader.h"
+
+using namespace gnilk;
+
+namespace {
+    class EventLoop {
+    public:
+        EventLoop() : epollFd(epoll_create1(0)) {}
+        ~EventLoop() {
+            close(epollFd);
+        }
+
+        // Resume 'waiting' once 'fd' is readable
+        void WaitReadable(int fd, std::coroutine_handle<> waiting) {
+            epoll_event ev = {};
+            ev.events = EPOLLIN;
+            ev.data.ptr = waiting.address();
+            epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &ev);
+            waitingFds.push_back({waiting.address(), fd});
+        }
+
+        void Poll(int timeoutMs) {
+            epoll_event events[64];
+            auto nEvents = epoll_wait(epollFd, events, 64, timeoutMs);
+            for(int i=0;i<nEvents;i++) {
+                Unregister(events[i].data.ptr);
+                std::coroutine_handle<>::from_address(events[i].data.ptr).resume();
+            }
+        }
+    protected:
+        void Unregister(void *address) {
+            for(auto it = waitingFds.begin(); it != waitingFds.end(); ++it) {
+                if (it->first == address) {
+                    epoll_ctl(epollFd, EPOLL_CTL_DEL, it->second, nullptr);
+                    waitingFds.erase(it);
+                    return;
+                }
+            }
+        }
+    protected:
+        int epollFd;
+        std::vector<std::pair<void *, int>> waitingFds;
+    };
+
+    // Non blocking fd reader, suspends the reading coroutine on the event loop when there is nothing to read
+    class FdReader {
+    public:
+        struct ReadAwaiter {
+            FdReader &reader;
+            void *out;
+            size_t maxbytes;
+            int32_t nRead = 0;
+
+            bool await_ready() {
+                return TryRead();
+            }
+            void await_suspend(std::coroutine_handle<> waiting) {
+                reader.loop.WaitReadable(reader.fd, waiting);
+            }
+            int32_t await_resume() {
+                // resumed by the loop - we are readable now
+                if (nRead == kWouldBlock) {
+                    TryRead();
+                }
+                return nRead;
+            }
+
+            bool TryRead() {
+                auto res = read(reader.fd, out, maxbytes);
+                if ((res < 0) && ((errno == EAGAIN) || (errno == EWOULDBLOCK))) {
+                    nRead = kWouldBlock;
+                    return false;
+                }
+                nRead = static_cast<int32_t>(res);
+                return true;
+            }
+            static constexpr int32_t kWouldBlock = -2;
+        };
+    public:
+        FdReader(EventLoop &useLoop, int useFd) : loop(useLoop), fd(useFd) {
+            fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+        }
+        ReadAwaiter ReadAsync(void *out, size_t maxbytes) {
+            return {*this, out, maxbytes};
+        }
+    protected:
+        EventLoop &loop;
+        int fd;
+    };
+
+    class Message : public BaseUnmarshal {
+    public:
+        bool SetField(const std::string &fieldName, const std::string &fieldValue) override {
+            if (fieldName == "id") {
+                id = std::stoi(fieldValue);
+                return true;
+            }
+            return false;
+        }
+    public:
+        int id = -1;
+    };
+
+    struct Stream {
+        Stream(EventLoop &loop, int readFd, int useWriteFd, std::unique_ptr<BaseDecoder> useDecoder, std::string useData) :
+            reader(loop, readFd), writeFd(useWriteFd), decoder(std::move(useDecoder)), data(std::move(useData)) {
+            readEnd = readFd;
+        }
+        ~Stream() {
+            close(readEnd);
+            if (writeFd >= 0) close(writeFd);
+        }
+
+        // Slow upload, a few bytes at the time
+        void WriteSome() {
+            if (writeFd < 0) return;
+            auto nBytes = std::min<size_t>(7, data.size() - idxWrite);
+            if (nBytes > 0) {
+                idxWrite += write(writeFd, data.data() + idxWrite, nBytes);
+            }
+            if (idxWrite == data.size()) {
+                close(writeFd);
+                writeFd = -1;
+            }
+        }
+
+        FdReader reader;
+        int readEnd;
+        int writeFd;
+        std::unique_ptr<BaseDecoder> decoder;
+        std::string data;
+        size_t idxWrite = 0;
+        Message message;
+        Task<bool> task;
+    };
+}
+
+extern "C" int test_asyncdecoder_epoll(ITesting *t) {
+    EventLoop loop;
+    std::vector<std::unique_ptr<Stream>> streams;
+    for(int i=0;i<300;i++) {
+        int fds[2];
+        // every other stream is a socket
+        if (i & 1) {
+            TR_ASSERT(t, socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+        } else {
+            TR_ASSERT(t, pipe(fds) == 0);
+        }
+        auto id = std::to_string(i);
+        switch(i % 3) {
+            case 0 :
+                streams.push_back(std::make_unique<Stream>(loop, fds[0], fds[1], std::make_unique<JSONDecoder>(), "{ \"id\" : " + id + " }"));
+                break;
+            case 1 :
+                streams.push_back(std::make_unique<Stream>(loop, fds[0], fds[1], std::make_unique<XMLDecoder>(), "<message id=\"" + id + "\"/>"));
+                break;
+            default:
+                streams.push_back(std::make_unique<Stream>(loop, fds[0], fds[1], std::make_unique<IniDecoder>(), "id=" + id + "\n"));
+                break;
+        }
+    }
+
+    // Start all, they suspend waiting for data
+    for(auto &stream : streams) {
+        stream->task = stream->decoder->UnmarshalAsync(stream->reader, &stream->message);
+        stream->task.Start();
+        TR_ASSERT(t, !stream->task.IsDone());
+    }
+
+    bool allDone = false;
+    for(int iter=0;(iter < 10000) && !allDone;iter++) {
+        for(auto &stream : streams) {
+            stream->WriteSome();
+        }
+        loop.Poll(10);
+        allDone = true;
+        for(auto &stream : streams) {
+            allDone = allDone && stream->task.IsDone();
+        }
+    }
+    TR_ASSERT(t, allDone);
+    for(size_t i=0;i<streams.size();i++) {
+        TR_ASSERT(t, streams[i]->task.Result());
+        TR_ASSERT(t, streams[i]->message.id == static_cast<int>(i));
+    }
+    return kTR_Pass;
+}
+
+extern "C" int test_asyncdecoder_sync_reader(ITesting *t) {
+    std::string data = "{ \"id\" : 42 }";
+    SyncAsyncReader reader(StringReader::Create(data));
+    JSONDecoder decoder;
+    Message message;
+    auto task = decoder.UnmarshalAsync(reader, &message);
+    task.Start();
+    TR_ASSERT(t, task.IsDone());
+    TR_ASSERT(t, task.Result());
+    TR_ASSERT(t, message.id == 42);
+    return kTR_Pass;
+}
+
+namespace {
+    Task<int> Answer(bool fail) {
+        if (fail) {
+            throw std::runtime_error("failed");
+        }
+        co_return 42;
+    }
+
+    template<typename F>
+    bool Throws(F fn) {
+        try {
+            fn();
+        } catch(...) {
+            return true;
+        }
+        return false;
+    }
+}
+
+extern "C" int test_asyncdecoder_task_result(ITesting *t) {
+    auto task = Answer(false);
+    // not started
+    TR_ASSERT(t, Throws([&task]() { task.Result(); }));
+    task.Start();
+    TR_ASSERT(t, task.Result() == 42);
+    // already taken
+    TR_ASSERT(t, Throws([&task]() { task.Result(); }));
+
+    // moved from
+    auto other = std::move(task);
+    TR_ASSERT(t, Throws([&task]() { task.Result(); }));
+
+    // the exception of the task is rethrown
+    auto failing = Answer(true);
+    failing.Start();
+    TR_ASSERT(t, failing.IsDone());
+    bool isRuntimeError = false;
+    try {
+        failing.Result();
+    } catch(const std::runtime_error &) {
+        isRuntimeError = true;
+    }
+    TR_ASSERT(t, isRuntimeError);
+    return kTR_Pass;
+}
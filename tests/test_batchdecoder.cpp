@@ -0,0 +1,156 @@
+//
+// Created by gnilk on 19.10.2026.
+//
+#include <testinterface.h>
+#include "../src/BatchDecoder.h"
+#include "../src/JSONParser.h"
+#include "../src/XMLParser.h"
+#include "../src/StringReader.h"
+
+using namespace gnilk;
+
+namespace {
+    class Message : public BaseUnmarshal {
+    public:
+        bool SetField(const std::string &fieldName, const std::string &fieldValue) override {
+            if (fieldName == "id") {
+                id = std::stoi(fieldValue);
+                return true;
+            }
+            if (fieldName == "text") {
+                text = fieldValue;
+                return true;
+            }
+            return false;
+        }
+    public:
+        int id = -1;
+        std::string text;
+    };
+
+    std::unique_ptr<IUnmarshal> CreateMessage(size_t idx) {
+        return std::make_unique<Message>();
+    }
+}
+
+extern "C" int test_batchdecoder_json(ITesting *t) {
+    // mixed sizes, so the workers have to steal from each other
+    std::vector<std::string> data;
+    for(int i=0;i<1000;i++) {
+        auto text = std::string((i % 97 == 0) ? 10000 : 10, 'x');
+        data.push_back("{\"id\" : " + std::to_string(i) + ", \"text\" : \"" + text + "\"}");
+    }
+    data[500] = "{\"id\" : 500, ";
+    std::vector<std::string_view> documents(data.begin(), data.end());
+
+    BatchOptions options;
+    options.nThreads = 4;
+    auto result = DecodeBatch(documents, CreateMessage, kDocumentFormat::kJSON, options);
+    TR_ASSERT(t, result.status.size() == 1000);
+    TR_ASSERT(t, result.nFailed == 1);
+    TR_ASSERT(t, result.status[500] == kDecodeStatus::kParseError);
+    TR_ASSERT(t, result.objects[500] == nullptr);
+    for(int i=0;i<1000;i++) {
+        if (i == 500) continue;
+        TR_ASSERT(t, result.status[i] == kDecodeStatus::kOk);
+        auto msg = static_cast<Message *>(result.objects[i].get());
+        TR_ASSERT(t, msg->id == i);
+        TR_ASSERT(t, msg->text.size() == ((i % 97 == 0) ? 10000 : 10));
+    }
+    return kTR_Pass;
+}
+
+extern "C" int test_batchdecoder_xml_ini(ITesting *t) {
+    std::vector<std::string_view> xmlDocuments = {
+        R"(<msg id="1" text="a"/>)",
+        R"(<msg id="2" text="b"/>)",
+    };
+    auto xmlResult = DecodeBatch(xmlDocuments, CreateMessage, kDocumentFormat::kXML);
+    TR_ASSERT(t, xmlResult.nFailed == 0);
+    TR_ASSERT(t, static_cast<Message *>(xmlResult.objects[1].get())->id == 2);
+    TR_ASSERT(t, static_cast<Message *>(xmlResult.objects[1].get())->text == "b");
+
+    std::vector<std::string_view> iniDocuments = {
+        "id=1\ntext=a\n",
+        "id=2\ntext=b\n",
+    };
+    auto iniResult = DecodeBatch(iniDocuments, CreateMessage, kDocumentFormat::kIni);
+    TR_ASSERT(t, iniResult.nFailed == 0);
+    TR_ASSERT(t, static_cast<Message *>(iniResult.objects[0].get())->id == 1);
+    TR_ASSERT(t, static_cast<Message *>(iniResult.objects[1].get())->text == "b");
+
+    // null from the factory is reported per item
+    auto noneResult = DecodeBatch(iniDocuments, [](size_t idx) -> std::unique_ptr<IUnmarshal> {
+        return (idx == 0) ? nullptr : std::make_unique<Message>();
+    }, kDocumentFormat::kIni);
+    TR_ASSERT(t, noneResult.nFailed == 1);
+    TR_ASSERT(t, noneResult.status[0] == kDecodeStatus::kNoObject);
+
+    // malformed input is a parse error for INI as well
+    std::vector<std::string_view> badIni = {
+        "id=1\n",
+        "[section\nid=2\n",
+        "id=3\ntext\n",
+    };
+    auto badResult = DecodeBatch(badIni, CreateMessage, kDocumentFormat::kIni);
+    TR_ASSERT(t, badResult.nFailed == 2);
+    TR_ASSERT(t, badResult.status[0] == kDecodeStatus::kOk);
+    TR_ASSERT(t, badResult.status[1] == kDecodeStatus::kParseError);
+    TR_ASSERT(t, badResult.status[2] == kDecodeStatus::kParseError);
+    return kTR_Pass;
+}
+
+extern "C" int test_batchdecoder_exception(ITesting *t) {
+    // 'Message' uses std::stoi, a bad id throws from inside the unmarshal callback
+    std::vector<std::string> data;
+    for(int i=0;i<100;i++) {
+        data.push_back("{\"id\" : \"" + ((i == 42) ? std::string("bad") : std::to_string(i)) + "\"}");
+    }
+    std::vector<std::string_view> documents(data.begin(), data.end());
+    BatchOptions options;
+    options.nThreads = 4;
+    auto result = DecodeBatch(documents, CreateMessage, kDocumentFormat::kJSON, options);
+    TR_ASSERT(t, result.nFailed == 1);
+    TR_ASSERT(t, result.status[42] == kDecodeStatus::kException);
+    TR_ASSERT(t, result.objects[42] == nullptr);
+    TR_ASSERT(t, static_cast<Message *>(result.objects[43].get())->id == 43);
+
+    // a throwing factory
+    auto throwResult = DecodeBatch(documents, [](size_t idx) -> std::unique_ptr<IUnmarshal> {
+        if (idx == 7) throw std::bad_alloc();
+        return std::make_unique<Message>();
+    }, kDocumentFormat::kJSON, options);
+    TR_ASSERT(t, throwResult.nFailed == 2);
+    TR_ASSERT(t, throwResult.status[7] == kDecodeStatus::kException);
+    return kTR_Pass;
+}
+
+extern "C" int test_batchdecoder_reuse(ITesting *t) {
+    // the parsers recycle their document, a failed parse doesn't affect the next one
+    static std::string first = R"({"id" : 1, "text" : "a much longer text which is stored in the arena"})";
+    static std::string broken = R"({"id" : 2, )";
+    static std::string second = R"({"id" : 3})";
+    auto reader = std::make_shared<StringReader>(first);
+    JSONParser jsonParser(reader);
+    auto jsonDoc = jsonParser.Reparse(reader);
+    TR_ASSERT(t, jsonDoc != nullptr);
+    auto arenaSize = jsonDoc->GetArenaSize();
+    TR_ASSERT(t, jsonParser.Reparse(std::make_shared<StringReader>(broken)) == nullptr);
+    auto jsonDocAgain = jsonParser.Reparse(std::make_shared<StringReader>(second));
+    TR_ASSERT(t, jsonDocAgain == jsonDoc);
+    TR_ASSERT(t, jsonDocAgain->GetArenaSize() == arenaSize);
+    TR_ASSERT(t, std::get<JSONObject::Ref>(jsonDocAgain->GetRoot())->GetValues().size() == 1);
+
+    xml::XMLParser xmlParser;
+    auto xmlDoc = xmlParser.Reparse(R"(<msg id="1" text="a much longer text which is stored in the arena"/>)");
+    TR_ASSERT(t, xmlDoc != nullptr);
+    TR_ASSERT(t, xmlParser.Reparse("<msg id=\"2\"") == nullptr);
+    auto xmlDocAgain = xmlParser.Reparse(R"(<msg id="3"/>)");
+    TR_ASSERT(t, xmlDocAgain == xmlDoc);
+    auto msg = xmlDocAgain->GetRoot()->GetFirstChild("msg");
+    TR_ASSERT(t, msg != nullptr);
+    TR_ASSERT(t, msg->GetAttributeValue("id", "") == "3");
+    TR_ASSERT(t, msg->GetAttributes().size() == 1);
+    TR_ASSERT(t, xmlDocAgain->GetRoot()->GetChildren().size() == 1);
+    return kTR_Pass;
+}
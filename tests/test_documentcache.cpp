@@ -0,0 +1,175 @@
+//
+// Created by gnilk on 19.10.2026.
+//
+#include <testinterface.h>
+#include <thread>
+#include <atomic>
+#include "../src/DocumentCache.h"
+#include "../src/JSONDecoder.h"
+#include "../src/XMLDecoder.h"
+#include "../src/IniDecoder.h"
+
+using namespace gnilk;
+
+namespace {
+    class Config : public BaseUnmarshal {
+    public:
+        bool SetField(const std::string &fieldName, const std::string &fieldValue) override {
+            if (fieldName != "port") return false;
+            port = std::stoi(fieldValue);
+            return true;
+        }
+    public:
+        int port = -1;
+    };
+}
+
+extern "C" int test_documentcache_hit(ITesting *t) {
+    DocumentCache cache;
+    // different buffers, same content
+    std::string first = R"({ "port" : 8080 })";
+    std::string second = first;
+
+    auto doc = cache.GetJSON(first);
+    TR_ASSERT(t, doc != nullptr);
+    TR_ASSERT(t, cache.GetJSON(second) == doc);
+    TR_ASSERT(t, cache.GetJSON(R"({ "port" : 8081 })") != doc);
+    // Same bytes as another format is another document
+    auto xmlDoc = cache.GetXML(first);
+    TR_ASSERT(t, static_cast<const void *>(xmlDoc.get()) != static_cast<const void *>(doc.get()));
+
+    auto stats = cache.GetStats();
+    TR_ASSERT(t, stats.hits == 1);
+    TR_ASSERT(t, stats.misses == 3);
+    TR_ASSERT(t, stats.entries == 3);
+    TR_ASSERT(t, stats.bytes == first.size() * 3);
+
+    Config config;
+    JSONDecoder decoder(*doc);
+    TR_ASSERT(t, decoder.Unmarshal(&config));
+    TR_ASSERT(t, config.port == 8080);
+    return kTR_Pass;
+}
+
+extern "C" int test_documentcache_formats(ITesting *t) {
+    DocumentCache cache;
+    auto xmlDoc = cache.GetXML(R"(<config port="80"/>)");
+    TR_ASSERT(t, xmlDoc != nullptr);
+    TR_ASSERT(t, cache.GetXML(R"(<config port="80"/>)") == xmlDoc);
+    Config xmlConfig;
+    XMLDecoder xmlDecoder(*xmlDoc);
+    TR_ASSERT(t, xmlDecoder.Unmarshal(&xmlConfig));
+    TR_ASSERT(t, xmlConfig.port == 80);
+
+    auto ini = cache.GetIni("port=81\n");
+    TR_ASSERT(t, ini != nullptr);
+    TR_ASSERT(t, cache.GetIni("port=81\n") == ini);
+    Config iniConfig;
+    IniDecoder iniDecoder(*ini);
+    TR_ASSERT(t, iniDecoder.Unmarshal(&iniConfig));
+    TR_ASSERT(t, iniConfig.port == 81);
+    return kTR_Pass;
+}
+
+extern "C" int test_documentcache_evict(ITesting *t) {
+    DocumentCache::Options options;
+    options.maxBytes = DocumentCache::kNumShards * 100;
+    DocumentCache cache(options);
+
+    // ~20 bytes each, a shard holds 100 bytes - most of these must go
+    for(int i=0;i<1000;i++) {
+        TR_ASSERT(t, cache.GetJSON("{ \"port\" : " + std::to_string(i) + " }") != nullptr);
+    }
+    auto stats = cache.GetStats();
+    TR_ASSERT(t, stats.bytes <= options.maxBytes);
+    TR_ASSERT(t, stats.evictions > 0);
+    TR_ASSERT(t, stats.entries + stats.evictions == 1000);
+
+    // The most recent one is still there, and larger than a shard is never cached
+    TR_ASSERT(t, cache.GetJSON("{ \"port\" : 999 }") != nullptr);
+    TR_ASSERT(t, cache.GetStats().hits == 1);
+    std::string large = "{ \"port\" : \"" + std::string(200, 'x') + "\" }";
+    TR_ASSERT(t, cache.GetJSON(large) != nullptr);
+    TR_ASSERT(t, cache.GetJSON(large) != nullptr);
+    TR_ASSERT(t, cache.GetStats().hits == 1);
+    return kTR_Pass;
+}
+
+extern "C" int test_documentcache_threads(ITesting *t) {
+    DocumentCache cache;
+    std::atomic<int> nFailed = 0;
+    std::vector<std::thread> threads;
+    for(int i=0;i<8;i++) {
+        threads.emplace_back([&cache, &nFailed]() {
+            for(int n=0;n<2000;n++) {
+                auto port = n % 50;
+                auto doc = cache.GetJSON("{ \"port\" : " + std::to_string(port) + " }");
+                Config config;
+                JSONDecoder decoder(*doc);
+                if (!decoder.Unmarshal(&config) || (config.port != port)) {
+                    nFailed++;
+                }
+            }
+        });
+    }
+    for(auto &thread : threads) {
+        thread.join();
+    }
+    TR_ASSERT(t, nFailed == 0);
+    auto stats = cache.GetStats();
+    TR_ASSERT(t, stats.entries == 50);
+    TR_ASSERT(t, stats.hits + stats.misses == 8 * 2000);
+    return kTR_Pass;
+}
+
+extern "C" int test_documentcache_hash(ITesting *t) {
+    // every length path of the hash
+    std::string data(200, 'a');
+    for(size_t len=0;len<data.size();len++) {
+        auto hash = DocumentCache::Hash(std::string_view(data).substr(0, len));
+        TR_ASSERT(t, hash == DocumentCache::Hash(std::string(len, 'a')));
+        TR_ASSERT(t, hash != DocumentCache::Hash(std::string_view(data).substr(0, len + 1)));
+        if (len > 0) {
+            auto other = data.substr(0, len);
+            other[len / 2] = 'b';
+            TR_ASSERT(t, hash != DocumentCache::Hash(other));
+        }
+    }
+    TR_ASSERT(t, DocumentCache::Hash("abc", 1) != DocumentCache::Hash("abc", 2));
+    return kTR_Pass;
+}
+
+namespace {
+    // Every payload gets the same hash
+    class CollidingCache : public DocumentCache {
+    protected:
+        uint64_t HashData(std::string_view data) const override {
+            return 0x1234;
+        }
+    };
+}
+
+extern "C" int test_documentcache_collision(ITesting *t) {
+    CollidingCache cache;
+    // same length, same (forced) hash
+    auto docA = cache.GetJSON(R"({"id" : 1})");
+    auto docB = cache.GetJSON(R"({"id" : 2})");
+    TR_ASSERT(t, docA != nullptr);
+    TR_ASSERT(t, docB != nullptr);
+    TR_ASSERT(t, docA != docB);
+
+    JSONDecoder decoder(*docB);
+    TR_ASSERT(t, decoder.BeginObject(""));
+    TR_ASSERT(t, decoder.ReadIntField("id") == 2);
+    decoder.EndObject();
+
+    // the latest payload holds the slot, the other one is parsed again
+    TR_ASSERT(t, cache.GetJSON(R"({"id" : 2})") == docB);
+    TR_ASSERT(t, cache.GetJSON(R"({"id" : 1})") != docA);
+    TR_ASSERT(t, cache.GetStats().entries == 1);
+    TR_ASSERT(t, cache.GetStats().hits == 1);
+
+    // seeds differ per cache
+    TR_ASSERT(t, DocumentCache::RandomSeed() != DocumentCache::RandomSeed());
+    return kTR_Pass;
+}
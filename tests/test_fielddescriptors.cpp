@@ -0,0 +1,165 @@
+//
+// Created by gnilk on 19.10.2026.
+//
+#include <testinterface.h>
+#include <cmath>
+#include "../src/FieldDescriptors.h"
+#include "../src/JSONEncoder.h"
+#include "../src/JSONDecoder.h"
+#include "../src/XMLEncoder.h"
+#include "../src/XMLDecoder.h"
+#include "../src/IniEncoder.h"
+#include "../src/IniDecoder.h"
+#include "CaptureWriter.h"
+
+using namespace gnilk;
+
+namespace {
+    struct Point {
+        int x = 0;
+        int y = 0;
+    };
+
+    struct Shape {
+        std::string name;
+        bool visible = false;
+        double scale = 0;
+        int64_t id = 0;
+        Point origin;
+        std::vector<int64_t> tags;
+        std::vector<Point> points;
+    };
+}
+
+namespace {
+    struct Mixed {
+        std::string code;
+        std::vector<std::string> labels;
+        int8_t small = 0;
+        int32_t count = 0;
+        uint32_t big = 0;
+    };
+}
+
+GNILK_DESCRIBE(Point, GNILK_FIELD(x), GNILK_FIELD(y));
+GNILK_DESCRIBE(Mixed, GNILK_FIELD(code), GNILK_FIELD(labels), GNILK_FIELD(small), GNILK_FIELD(count), GNILK_FIELD(big));
+GNILK_DESCRIBE(Shape, GNILK_FIELD(name), GNILK_FIELD(visible), GNILK_FIELD(scale), GNILK_FIELD_NAMED("uid", id),
+                      GNILK_FIELD(origin), GNILK_FIELD(tags), GNILK_FIELD(points));
+
+static Shape MakeShape() {
+    Shape shape;
+    shape.name = "box";
+    shape.visible = true;
+    shape.scale = 1.5;
+    shape.id = 1234567890123;
+    shape.origin = {1, 2};
+    shape.tags = {3, 4};
+    shape.points = {{5, 6}, {7, 8}};
+    return shape;
+}
+
+static bool IsSame(const Shape &a, const Shape &b) {
+    if (a.name != b.name) return false;
+    if (a.visible != b.visible) return false;
+    if (fabs(a.scale - b.scale) > 0.0001) return false;
+    if (a.id != b.id) return false;
+    if ((a.origin.x != b.origin.x) || (a.origin.y != b.origin.y)) return false;
+    if (a.tags != b.tags) return false;
+    if (a.points.size() != b.points.size()) return false;
+    for(size_t i=0;i<a.points.size();i++) {
+        if ((a.points[i].x != b.points[i].x) || (a.points[i].y != b.points[i].y)) return false;
+    }
+    return true;
+}
+
+extern "C" int test_fielddescriptors_lookup(ITesting *t) {
+    using Type = detail::DescribedType<Shape>;
+    TR_ASSERT(t, Type::numFields == 7);
+    TR_ASSERT(t, Type::lookup.Find("name") == 0);
+    TR_ASSERT(t, Type::lookup.Find("uid") == 3);
+    TR_ASSERT(t, Type::lookup.Find("points") == 6);
+    TR_ASSERT(t, Type::lookup.Find("id") == -1);
+    TR_ASSERT(t, Type::lookup.Find("") == -1);
+    return kTR_Pass;
+}
+
+extern "C" int test_fielddescriptors_json(ITesting *t) {
+    auto cw = std::make_shared<CaptureWriter>();
+    JSONEncoder encoder(cw);
+    auto shape = MakeShape();
+    EncodeDescribed(encoder, "", shape);
+
+    Shape decoded;
+    DescribedUnmarshal<Shape> unmarshal(decoded);
+    JSONDecoder decoder(cw->text);
+    TR_ASSERT(t, decoder.Unmarshal(&unmarshal));
+    TR_ASSERT(t, IsSame(shape, decoded));
+    return kTR_Pass;
+}
+
+extern "C" int test_fielddescriptors_xml(ITesting *t) {
+    auto cw = std::make_shared<CaptureWriter>();
+    XMLEncoder encoder(cw);
+    auto shape = MakeShape();
+    EncodeDescribed(encoder, "Shape", shape);
+
+    Shape decoded;
+    DescribedUnmarshal<Shape> unmarshal(decoded);
+    XMLDecoder decoder(cw->text);
+    TR_ASSERT(t, decoder.Unmarshal(&unmarshal));
+    TR_ASSERT(t, IsSame(shape, decoded));
+    return kTR_Pass;
+}
+
+extern "C" int test_fielddescriptors_ini(ITesting *t) {
+    auto cw = std::make_shared<CaptureWriter>();
+    IniEncoder encoder(cw);
+    Point point = {10, 20};
+    EncodeDescribed(encoder, "", point);
+
+    Point decoded;
+    DescribedUnmarshal<Point> unmarshal(decoded);
+    IniDecoder decoder(cw->text);
+    TR_ASSERT(t, decoder.Unmarshal(&unmarshal));
+    TR_ASSERT(t, decoded.x == 10);
+    TR_ASSERT(t, decoded.y == 20);
+    return kTR_Pass;
+}
+
+extern "C" int test_fielddescriptors_conversions(ITesting *t) {
+    // numbers and bools into string members are kept as text
+    static std::string data = R"({"code" : 1234, "labels" : [1, true, 2.5, "x"], "small" : 12, "count" : 7})";
+    Mixed mixed;
+    DescribedUnmarshal<Mixed> unmarshal(mixed);
+    JSONDecoder decoder(data);
+    TR_ASSERT(t, decoder.Unmarshal(&unmarshal));
+    TR_ASSERT(t, mixed.code == "1234");
+    TR_ASSERT(t, mixed.labels.size() == 4);
+    TR_ASSERT(t, mixed.labels[0] == "1");
+    TR_ASSERT(t, mixed.labels[1] == "true");
+    TR_ASSERT(t, mixed.labels[2] == "2.5");
+    TR_ASSERT(t, mixed.labels[3] == "x");
+    TR_ASSERT(t, mixed.small == 12);
+    TR_ASSERT(t, mixed.count == 7);
+
+    // out of range for the member is rejected, not truncated
+    TR_ASSERT(t, !unmarshal.SetInt("small", 300));
+    TR_ASSERT(t, !unmarshal.SetInt("count", 5000000000));
+    TR_ASSERT(t, mixed.small == 12);
+    TR_ASSERT(t, mixed.count == 7);
+    TR_ASSERT(t, unmarshal.SetInt("small", -128));
+    TR_ASSERT(t, mixed.small == -128);
+
+    // unsigned 32 bit values above INT_MAX are encoded as they are, not as negative numbers
+    mixed.big = 4000000000u;
+    auto cw = std::make_shared<CaptureWriter>();
+    JSONEncoder encoder(cw);
+    EncodeDescribed(encoder, "", mixed);
+    TR_ASSERT(t, cw->text.find("4000000000") != std::string::npos);
+    Mixed decoded;
+    DescribedUnmarshal<Mixed> decodedUnmarshal(decoded);
+    JSONDecoder roundTrip(cw->text);
+    TR_ASSERT(t, roundTrip.Unmarshal(&decodedUnmarshal));
+    TR_ASSERT(t, decoded.big == 4000000000u);
+    return kTR_Pass;
+}
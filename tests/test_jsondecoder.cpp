@@ -3,7 +3,11 @@
 //
 
 #include <testinterface.h>
+#include <thread>
+#include <atomic>
+#include <string.h>
 #include "JSONDecoder.h"
+#include "StringReader.h"
 #include "IDeserializable.h"
 
 namespace {
@@ -167,4 +171,193 @@ extern "C" int test_jsondecoder_array_objects(ITesting *t) {
     TR_ASSERT(t, myObj.objects[1].num == 2);
     TR_ASSERT(t, myObj.objects[2].num == 3);
     return kTR_Pass;
-}
\ No newline at end of file
+}
+extern "C" int test_jsondecoder_shared_document(ITesting *t) {
+    static std::string data = "[{ \"num\" : 1}, {\"num\" : 2}, {\"num\" :3}] ";
+
+    // Parse once, read from many threads - each with its own decoder
+    std::shared_ptr<const JSONDoc> doc = JSONParser::Load(data);
+    TR_ASSERT(t, doc != nullptr);
+
+    std::atomic<int> nFailed = 0;
+    std::vector<std::thread> threads;
+    for(int i=0;i<8;i++) {
+        threads.emplace_back([doc, &nFailed]() {
+            for(int n=0;n<1000;n++) {
+                JSONDecoder decoder(*doc);
+                MyRootArrayObjects myObj;
+                myObj.DeserializeFrom(decoder);
+                if ((myObj.objects.size() != 3) || (myObj.objects[2].num != 3)) {
+                    nFailed++;
+                }
+            }
+        });
+    }
+    for(auto &thread : threads) {
+        thread.join();
+    }
+    TR_ASSERT(t, nFailed == 0);
+    return kTR_Pass;
+}
+
+extern "C" int test_jsondecoder_lazy_document(ITesting *t) {
+    static std::string data = "[{ \"num\" : 1, \"unused\" : [[[1]]]}, {\"num\" : 2}, {\"num\" :3}] ";
+
+    auto doc = JSONParser::LoadLazy(data);
+    TR_ASSERT(t, doc != nullptr);
+    JSONDecoder decoder(*doc);
+    MyRootArrayObjects myObj;
+    myObj.DeserializeFrom(decoder);
+    TR_ASSERT(t, myObj.objects.size() == 3);
+    TR_ASSERT(t, myObj.objects[0].num == 1);
+    TR_ASSERT(t, myObj.objects[2].num == 3);
+    return kTR_Pass;
+}
+
+namespace {
+    // Produces '[{"num":0,"pad":"..."},{"num":1,...}, ...]' on the fly, the full text never exists in memory
+    class GeneratedArrayReader : public IReader {
+    public:
+        explicit GeneratedArrayReader(size_t items) : nItems(items) {}
+
+        int32_t Read(void *out, size_t maxbytes) override {
+            size_t nWritten = 0;
+            while(nWritten < maxbytes) {
+                if (pos == chunk.size()) {
+                    if (!NextChunk()) {
+                        break;
+                    }
+                }
+                auto n = std::min(maxbytes - nWritten, chunk.size() - pos);
+                memcpy(static_cast<char *>(out) + nWritten, chunk.data() + pos, n);
+                pos += n;
+                nWritten += n;
+            }
+            return static_cast<int32_t>(nWritten);
+        }
+        bool Available() override {
+            return (pos < chunk.size()) || (idxItem <= nItems);
+        }
+    protected:
+        bool NextChunk() {
+            pos = 0;
+            if (idxItem > nItems) {
+                chunk.clear();
+                return false;
+            }
+            if (idxItem == nItems) {
+                chunk = "]";
+            } else {
+                chunk = (idxItem == 0) ? "[" : ",";
+                chunk += "{\"num\":" + std::to_string(idxItem) + ",\"pad\":\"" + std::string(64, 'x') + "\"}";
+            }
+            idxItem++;
+            return true;
+        }
+    protected:
+        size_t nItems;
+        size_t idxItem = 0;
+        std::string chunk = {};
+        size_t pos = 0;
+    };
+
+    class NumberCollector : public BaseUnmarshal {
+    public:
+        bool SetField(const std::string &fieldName, const std::string &fieldValue) override {
+            numbers.push_back(std::stoi(fieldValue));
+            return true;
+        }
+    public:
+        std::vector<int> numbers;
+    };
+}
+
+extern "C" int test_jsondecoder_stream_array(ITesting *t) {
+    static size_t nItems = 100000;
+    JSONDecoder decoder;
+    decoder.BeginStream(std::make_shared<GeneratedArrayReader>(nItems));
+
+    size_t nSeen = 0;
+    bool isInOrder = true;
+    auto it = decoder.BeginArray("");
+    TR_ASSERT(t, it != nullptr);
+    while(!it->End()) {
+        TR_ASSERT(t, it->IsObject());
+        TR_ASSERT(t, decoder.BeginObject("item"));
+        auto num = decoder.ReadIntField("num");
+        isInOrder = isInOrder && num.has_value() && (*num == static_cast<int>(nSeen));
+        decoder.EndObject();
+        nSeen++;
+        it->Next();
+    }
+    decoder.EndArray();
+    TR_ASSERT(t, nSeen == nItems);
+    TR_ASSERT(t, isInOrder);
+    return kTR_Pass;
+}
+
+extern "C" int test_jsondecoder_stream_member(ITesting *t) {
+    // the array is found as a member of the root object, everything before it is skipped
+    static std::string data = R"({ "skip" : { "a" : [1, "]", {"b" : "}"}] }, "n" : -1.5, "s" : "x\"y",
+                                   "items" : [ {"num" : 1, "other" : {"num" : 7}}, 2, [3], {"num" : 4} ], "after" : 1 })";
+    JSONDecoder decoder;
+    decoder.BeginStream(StringReader::Create(data));
+    // no document - objects can only be reached through the array
+    TR_ASSERT(t, !decoder.BeginObject("items"));
+
+    MyRootArrayObjects myObj;
+    auto it = decoder.BeginArray("items");
+    std::vector<bool> isObject;
+    while(!it->End()) {
+        isObject.push_back(it->IsObject());
+        if (it->IsObject()) {
+            MyRootObject other;
+            other.DeserializeFrom(decoder);
+            myObj.objects.push_back(other);
+        }
+        it->Next();
+    }
+    decoder.EndArray();
+    TR_ASSERT(t, isObject == std::vector<bool>({true, false, false, true}));
+    TR_ASSERT(t, myObj.objects.size() == 2);
+    TR_ASSERT(t, myObj.objects[0].num == 1);
+    TR_ASSERT(t, myObj.objects[1].num == 4);
+
+    JSONDecoder missing;
+    missing.BeginStream(StringReader::Create(data));
+    TR_ASSERT(t, missing.BeginArray("nope")->End());
+    missing.EndArray();
+    return kTR_Pass;
+}
+
+extern "C" int test_jsondecoder_stream_unmarshal(ITesting *t) {
+    // StringReader holds a reference
+    static std::string data = "[1, 2, 3, 4]";
+    static std::string dataTruncated = "[1, 2, {\"num\" : ";
+    static std::string dataUnterminated = "[1, 2";
+
+    NumberCollector collector;
+    JSONDecoder decoder;
+    decoder.BeginStream(StringReader::Create(data));
+    TR_ASSERT(t, decoder.Unmarshal(&collector));
+    TR_ASSERT(t, collector.numbers == std::vector<int>({1, 2, 3, 4}));
+
+    // truncated streams end the iteration with an error
+    JSONDecoder truncated;
+    truncated.BeginStream(StringReader::Create(dataTruncated));
+    auto it = std::dynamic_pointer_cast<JSONDecoder::JSONStreamArrayIterator>(truncated.BeginArray(""));
+    TR_ASSERT(t, it != nullptr);
+    size_t nItems = 0;
+    for(;!it->End();it->Next()) {
+        nItems++;
+    }
+    truncated.EndArray();
+    TR_ASSERT(t, nItems == 2);
+    TR_ASSERT(t, it->Failed());
+
+    NumberCollector partial;
+    JSONDecoder truncatedUnmarshal;
+    truncatedUnmarshal.BeginStream(StringReader::Create(dataUnterminated));
+    TR_ASSERT(t, !truncatedUnmarshal.Unmarshal(&partial));
+    return kTR_Pass;
+}
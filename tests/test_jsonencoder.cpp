@@ -4,8 +4,10 @@
 
 #include <testinterface.h>
 
+#include <vector>
 #include "FileWriter.h"
 #include "JSONEncoder.h"
+#include "CaptureWriter.h"
 
 using namespace gnilk;
 
@@ -22,4 +24,38 @@ extern "C" int test_jsonencoder_simple(ITesting *t) {
     printf("\n");
 
     return kTR_Pass;
-}
\ No newline at end of file
+}
+extern "C" int test_jsonencoder_array(ITesting *t) {
+    auto cw = std::make_shared<CaptureWriter>();
+    JSONEncoder encoder(cw);
+
+    encoder.BeginObject("");
+    encoder.BeginArray("values");
+    encoder.WriteIntField("", 1);
+    encoder.WriteIntField("ignored", 2);
+    encoder.BeginObject("");
+    encoder.WriteIntField("num", 3);
+    encoder.EndObject();
+    encoder.EndArray();
+    encoder.WriteTextField("after", "x");
+    encoder.EndObject();
+
+    TR_ASSERT(t, cw->text == "{\"values\":[1,2,{\"num\":3}],\"after\":\"x\"}");
+    return kTR_Pass;
+}
+
+extern "C" int test_jsonencoder_array_bulk(ITesting *t) {
+    auto cw = std::make_shared<CaptureWriter>();
+    JSONEncoder encoder(cw);
+
+    std::vector<int64_t> ints = {1, -2, 3};
+    std::vector<double> doubles = {0.5, 2};
+    encoder.BeginObject("");
+    encoder.WriteIntArray("ints", ints);
+    encoder.WriteDoubleArray("doubles", doubles);
+    encoder.WriteIntArray("empty", {});
+    encoder.EndObject();
+
+    TR_ASSERT(t, cw->text == "{\"ints\":[1,-2,3],\"doubles\":[0.500000,2.000000],\"empty\":[]}");
+    return kTR_Pass;
+}
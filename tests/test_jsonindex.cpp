@@ -0,0 +1,204 @@
+//
+// Created by gnilk on 19.10.2026.
+//
+#include <testinterface.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include "JSONIndex.h"
+#include "JSONDecoder.h"
+#include "JSONParser.h"
+#include "MMapReader.h"
+
+using namespace gnilk;
+
+static std::string MakeArray(size_t nItems) {
+    std::string data = "[\n";
+    for(size_t i=0;i<nItems;i++) {
+        // brackets, separators and escaped quotes within strings must not confuse the index
+        data += "  {\"num\" : " + std::to_string(i) + ", \"text\" : \"a, [b]} \\\"" + std::to_string(i) + "\"}";
+        data += (i + 1 < nItems) ? ",\n" : "\n";
+    }
+    data += "]";
+    return data;
+}
+
+static bool WriteFile(const std::string &filename, const std::string &data) {
+    auto f = fopen(filename.c_str(), "wb");
+    if (f == nullptr) {
+        return false;
+    }
+    auto ok = (fwrite(data.data(), 1, data.size(), f) == data.size());
+    fclose(f);
+    return ok;
+}
+
+static bool ReadFile(const std::string &filename, std::string &outData) {
+    auto f = fopen(filename.c_str(), "rb");
+    if (f == nullptr) {
+        return false;
+    }
+    char buffer[4096];
+    size_t nRead;
+    while((nRead = fread(buffer, 1, sizeof(buffer), f)) > 0) {
+        outData.append(buffer, nRead);
+    }
+    fclose(f);
+    return true;
+}
+
+extern "C" int test_jsonindex_array(ITesting *t) {
+    auto data = MakeArray(100);
+    auto index = JSONIndex::Build(data, 8);
+    TR_ASSERT(t, index != nullptr);
+    TR_ASSERT(t, index->GetLayout() == JSONIndex::kLayout::kArray);
+    TR_ASSERT(t, index->Size() == 100);
+    for(size_t i=0;i<100;i++) {
+        auto expected = "{\"num\" : " + std::to_string(i) + ", \"text\" : \"a, [b]} \\\"" + std::to_string(i) + "\"}";
+        TR_ASSERT(t, index->Element(data, i) == expected);
+    }
+    TR_ASSERT(t, index->Element(data, 100).empty());
+
+    // scalars and empty arrays
+    std::string scalars = "[1, \"two\" ,true,[ ], {}]";
+    index = JSONIndex::Build(scalars, 2);
+    TR_ASSERT(t, index->Size() == 5);
+    TR_ASSERT(t, index->Element(scalars, 1) == "\"two\"");
+    TR_ASSERT(t, index->Element(scalars, 3) == "[ ]");
+    TR_ASSERT(t, index->Element(scalars, 4) == "{}");
+    std::string empty = " [ ] ";
+    TR_ASSERT(t, JSONIndex::Build(empty)->Size() == 0);
+
+    // incomplete arrays are not indexed
+    std::string broken = "[{\"a\" : 1}, {\"b\" : \"]";
+    TR_ASSERT(t, JSONIndex::Build(broken) == nullptr);
+    return kTR_Pass;
+}
+
+extern "C" int test_jsonindex_lines(ITesting *t) {
+    std::string data = "{\"num\" : 0}\n\n  {\"num\" : 1}\r\n{\"num\" : 2}\n[3]\n{\"num\" : 4}";
+    auto index = JSONIndex::Build(data, 2);
+    TR_ASSERT(t, index != nullptr);
+    TR_ASSERT(t, index->GetLayout() == JSONIndex::kLayout::kLines);
+    TR_ASSERT(t, index->Size() == 5);
+    TR_ASSERT(t, index->Element(data, 1) == "{\"num\" : 1}");
+    TR_ASSERT(t, index->Element(data, 3) == "[3]");
+    TR_ASSERT(t, index->Element(data, 4) == "{\"num\" : 4}");
+    // an index is bound to the data it was built from
+    TR_ASSERT(t, index->Element(data + "\n", 1).empty());
+    TR_ASSERT(t, index->IsValidFor(data));
+    auto sameSize = data;
+    sameSize[sameSize.find('0')] = '9';
+    TR_ASSERT(t, !index->IsValidFor(sameSize));
+    TR_ASSERT(t, !index->IsValidFor(data + "\n"));
+
+    // records that are arrays need the layout, auto detection sees a root array
+    std::string arrays = "[1,2]\n[3,4]\n";
+    TR_ASSERT(t, JSONIndex::Build(arrays) == nullptr);
+    index = JSONIndex::Build(arrays, 1, JSONIndex::kLayout::kLines);
+    TR_ASSERT(t, index != nullptr);
+    TR_ASSERT(t, index->GetLayout() == JSONIndex::kLayout::kLines);
+    TR_ASSERT(t, index->Size() == 2);
+    TR_ASSERT(t, index->Element(arrays, 1) == "[3,4]");
+    TR_ASSERT(t, JSONIndex::Build(data, 1, JSONIndex::kLayout::kArray) == nullptr);
+    return kTR_Pass;
+}
+
+extern "C" int test_jsonindex_file(ITesting *t) {
+    std::string filename = "/tmp/encdec_test_jsonindex.json";
+    auto data = MakeArray(5000);
+    TR_ASSERT(t, WriteFile(filename, data));
+
+    auto reader = MMapReader::Create(filename);
+    TR_ASSERT(t, reader != nullptr);
+    TR_ASSERT(t, reader->GetData() == data);
+
+    auto built = JSONIndex::Build(reader->GetData(), 64);
+    TR_ASSERT(t, built != nullptr);
+    auto indexName = JSONIndex::SidecarName(filename);
+    TR_ASSERT(t, built->Save(indexName));
+
+    auto index = JSONIndex::Load(indexName);
+    TR_ASSERT(t, index != nullptr);
+    TR_ASSERT(t, index->Size() == 5000);
+    TR_ASSERT(t, index->GetStride() == 64);
+    TR_ASSERT(t, index->IsValidFor(reader->GetData()));
+    TR_ASSERT(t, index->Verify(reader->GetData()));
+
+    // the cheap check only samples the data, an edit between the samples needs Verify
+    auto edited = data;
+    auto editPos = edited.find('7', JSONIndex::kSampleSize + 16);
+    TR_ASSERT(t, editPos < (edited.size() - JSONIndex::kSampleSize) / 2);
+    edited[editPos] = '8';
+    TR_ASSERT(t, index->IsValidFor(edited));
+    TR_ASSERT(t, !index->Verify(edited));
+    edited = data;
+    edited[edited.size() / 2] = '#';
+    TR_ASSERT(t, !index->IsValidFor(edited));
+
+    // seek and decode single elements straight from the mapped file
+    for(size_t idx : {4999, 0, 1234, 64, 63}) {
+        TR_ASSERT(t, index->Seek(*reader, idx));
+        JSONDecoder decoder;
+        decoder.BeginValue(reader);
+        TR_ASSERT(t, decoder.BeginObject(""));
+        auto num = decoder.ReadIntField("num");
+        TR_ASSERT(t, num.has_value());
+        TR_ASSERT(t, *num == static_cast<int>(idx));
+        decoder.EndObject();
+    }
+    TR_ASSERT(t, !index->Seek(*reader, 5000));
+
+    // scalar elements are values of their own, not skipped to the next object
+    TR_ASSERT(t, WriteFile(filename, "[1, {\"n\":7}, 3, \"text\", true]"));
+    reader = MMapReader::Create(filename);
+    TR_ASSERT(t, reader != nullptr);
+    auto mixed = JSONIndex::Build(reader->GetData(), 1);
+    TR_ASSERT(t, mixed != nullptr);
+    const char *expected[] = { "1", nullptr, "3", "text", "true" };
+    for(size_t idx : {0, 1, 2, 3, 4}) {
+        TR_ASSERT(t, mixed->Seek(*reader, idx));
+        auto doc = JSONParser::LoadValue(reader);
+        TR_ASSERT(t, doc != nullptr);
+        TR_ASSERT(t, doc->GetRootValue() != nullptr);
+        TR_ASSERT(t, doc->GetRootValue()->IsObject() == (expected[idx] == nullptr));
+        if (expected[idx] != nullptr) {
+            TR_ASSERT(t, doc->GetRootValue()->GetAsString() == expected[idx]);
+        }
+
+        TR_ASSERT(t, mixed->Seek(*reader, idx));
+        JSONDecoder decoder;
+        decoder.BeginValue(reader);
+        TR_ASSERT(t, decoder.BeginObject("") == (expected[idx] == nullptr));
+        if (expected[idx] == nullptr) {
+            TR_ASSERT(t, decoder.ReadIntField("n") == 7);
+            decoder.EndObject();
+        }
+    }
+    // only the closing bracket is left
+    JSONDecoder empty;
+    empty.BeginValue(reader);
+    TR_ASSERT(t, !empty.BeginObject(""));
+
+    TR_ASSERT(t, JSONIndex::Load(filename) == nullptr);
+
+    // damaged offsets are rejected, they would point outside of the data (or backwards)
+    TR_ASSERT(t, built->Save(indexName));
+    std::string indexData;
+    TR_ASSERT(t, ReadFile(indexName, indexData));
+    // magic, version, layout, stride, elements, data size, checksum, sampled checksum, number of offsets
+    static constexpr size_t kOffsetsStart = 8 + 4 + 4 + 8 * 6;
+    for(uint64_t badOffset : {static_cast<uint64_t>(data.size()), uint64_t(0)}) {
+        auto damaged = indexData;
+        // the second offset, the first is always the start of the first element
+        memcpy(damaged.data() + kOffsetsStart + sizeof(uint64_t), &badOffset, sizeof(badOffset));
+        TR_ASSERT(t, WriteFile(indexName, damaged));
+        TR_ASSERT(t, JSONIndex::Load(indexName) == nullptr);
+    }
+    TR_ASSERT(t, WriteFile(indexName, indexData.substr(0, indexData.size() - 1)));
+    TR_ASSERT(t, JSONIndex::Load(indexName) == nullptr);
+    TR_ASSERT(t, MMapReader::Create("/tmp/encdec_test_jsonindex.missing") == nullptr);
+    remove(filename.c_str());
+    remove(indexName.c_str());
+    return kTR_Pass;
+}
@@ -8,6 +8,8 @@
 //
 
 #include <testinterface.h>
+#include <thread>
+#include <atomic>
 #include "../src/JSONParser.h"
 using namespace gnilk;
 
@@ -203,4 +205,161 @@ extern "C" int test_jsonparser_array_wobjects(ITesting *t) {
         TR_ASSERT(t, object->IsEmpty());
     }
     return kTR_Pass;
-}
\ No newline at end of file
+}
+extern "C" int test_jsonparser_compact_values(ITesting *t) {
+    TR_ASSERT(t, sizeof(JSONValue) == 16);
+
+    // 14 chars fit inline, 15 goes to the document arena
+    static std::string data = R"({ "short" : "abcdefghijklmn", "long" : "abcdefghijklmno", "nested" : [[1,2],[3,[4,5]],6] })";
+    auto doc = JSONParser::Load(data);
+    TR_ASSERT(t, doc.get() != nullptr);
+
+    auto rootObject = *std::get_if<JSONObject::Ref>(&doc->GetRoot());
+    TR_ASSERT(t, rootObject->GetValue("short")->GetAsString() == "abcdefghijklmn");
+    TR_ASSERT(t, rootObject->GetValue("long")->GetAsString() == "abcdefghijklmno");
+    TR_ASSERT(t, rootObject->GetValue("long")->GetScalarType() == JSONValue::kScalar::kText);
+
+    // Items of an array are contiguous, also when nested arrays were parsed in between
+    auto nested = rootObject->GetValue("nested")->GetAsArray();
+    TR_ASSERT(t, nested->Size() == 3);
+    TR_ASSERT(t, nested->At(1).get() == nested->At(0).get() + 1);
+    TR_ASSERT(t, nested->At(2)->GetAsString() == "6");
+    TR_ASSERT(t, nested->At(2)->GetScalarType() == JSONValue::kScalar::kNumber);
+
+    auto inner = nested->At(1)->GetAsArray();
+    TR_ASSERT(t, inner->Size() == 2);
+    TR_ASSERT(t, inner->At(0)->GetAsString() == "3");
+    auto innermost = inner->At(1)->GetAsArray();
+    TR_ASSERT(t, innermost->Size() == 2);
+    TR_ASSERT(t, innermost->At(1)->GetAsString() == "5");
+    TR_ASSERT(t, nested->At(0)->GetAsArray()->At(1)->GetAsString() == "2");
+    return kTR_Pass;
+}
+
+extern "C" int test_jsonparser_object_order(ITesting *t) {
+    static std::string data = R"({ "z" : 1, "a" : 2, "m" : { "y" : 3, "b" : 4 }, "a" : 5 })";
+    auto doc = JSONParser::Load(data);
+    TR_ASSERT(t, doc.get() != nullptr);
+
+    auto rootObject = *std::get_if<JSONObject::Ref>(&doc->GetRoot());
+    // members are kept in document order, duplicates included - lookup gives the last one
+    std::vector<std::string_view> names;
+    for(auto &[name, value] : rootObject->GetValues()) {
+        names.push_back(name);
+    }
+    TR_ASSERT(t, names == std::vector<std::string_view>({"z", "a", "m", "a"}));
+    TR_ASSERT(t, rootObject->GetValue("a")->GetAsString() == "5");
+
+    auto subObject = rootObject->GetValue("m")->GetAsObject();
+    TR_ASSERT(t, subObject->GetValues()[0].name == "y");
+    TR_ASSERT(t, subObject->GetValues()[1].name == "b");
+    return kTR_Pass;
+}
+
+extern "C" int test_jsonparser_object_large(ITesting *t) {
+    // above the index threshold lookups go through the hash index
+    std::string data = "{";
+    for(int i=0;i<100;i++) {
+        data += (i ? ",\"key" : "\"key") + std::to_string(i) + "\":" + std::to_string(i * 2);
+    }
+    data += ",\"key7\":-1}";
+    auto doc = JSONParser::Load(data);
+    TR_ASSERT(t, doc.get() != nullptr);
+
+    auto rootObject = *std::get_if<JSONObject::Ref>(&doc->GetRoot());
+    TR_ASSERT(t, rootObject->Size() == 101);
+    TR_ASSERT(t, rootObject->GetValues()[42].name == "key42");
+    for(int i=0;i<100;i++) {
+        auto value = rootObject->GetValue("key" + std::to_string(i));
+        TR_ASSERT(t, value != nullptr);
+        TR_ASSERT(t, value->GetAsString() == ((i == 7) ? "-1" : std::to_string(i * 2)));
+    }
+    TR_ASSERT(t, rootObject->GetValue("key100") == nullptr);
+    TR_ASSERT(t, !rootObject->HasValue("nope"));
+    return kTR_Pass;
+}
+
+extern "C" int test_jsonparser_lazy(ITesting *t) {
+    static std::string data = R"({ "name" : "a string longer than fourteen", "skip" : { "deep" : [1, {"x" : "}"}, [2]] },
+                                   "list" : [ true, null, -1.5e3, { "k" : "v\"q" }, [] ], "n" : 42 })";
+    auto doc = JSONParser::LoadLazy(data);
+    TR_ASSERT(t, doc.get() != nullptr);
+
+    auto rootObject = *std::get_if<JSONObject::Ref>(&doc->GetRoot());
+    TR_ASSERT(t, rootObject->Size() == 4);
+    TR_ASSERT(t, rootObject->GetValue("name")->GetAsString() == "a string longer than fourteen");
+    TR_ASSERT(t, rootObject->GetValue("n")->GetAsString() == "42");
+    TR_ASSERT(t, rootObject->GetValue("n")->GetScalarType() == JSONValue::kScalar::kNumber);
+
+    auto list = rootObject->GetValue("list")->GetAsArray();
+    TR_ASSERT(t, list->Size() == 5);
+    TR_ASSERT(t, list->At(0)->GetScalarType() == JSONValue::kScalar::kBool);
+    TR_ASSERT(t, list->At(1)->GetScalarType() == JSONValue::kScalar::kNull);
+    TR_ASSERT(t, list->At(2)->GetAsString() == "-1.5e3");
+    TR_ASSERT(t, list->At(3)->GetAsObject()->GetValue("k")->GetAsString() == "v\\\"q");
+    TR_ASSERT(t, list->At(4)->GetAsArray()->IsEmpty());
+
+    // brackets within strings are not structure
+    auto deep = rootObject->GetValue("skip")->GetAsObject()->GetValue("deep")->GetAsArray();
+    TR_ASSERT(t, deep->Size() == 3);
+    TR_ASSERT(t, deep->At(1)->GetAsObject()->GetValue("x")->GetAsString() == "}");
+    TR_ASSERT(t, deep->At(2)->GetAsArray()->At(0)->GetAsString() == "2");
+    TR_ASSERT(t, !doc->HasErrors());
+
+    TR_ASSERT(t, JSONParser::LoadLazy(R"({ "a" : [1, 2 })") == nullptr);
+    TR_ASSERT(t, JSONParser::LoadLazy(R"({ "a" : "open })") == nullptr);
+
+    // errors within containers are found when they are expanded, the values before the error are kept
+    auto brokenDoc = JSONParser::LoadLazy(R"({ "ok" : 1, "a" : { "x" : 1 "y" : 2 } })");
+    TR_ASSERT(t, brokenDoc != nullptr);
+    auto brokenRoot = *std::get_if<JSONObject::Ref>(&brokenDoc->GetRoot());
+    TR_ASSERT(t, brokenRoot->GetValue("ok")->GetAsString() == "1");
+    TR_ASSERT(t, !brokenDoc->HasErrors());
+    auto a = brokenRoot->GetValue("a")->GetAsObject();
+    TR_ASSERT(t, a->GetValue("x")->GetAsString() == "1");
+    TR_ASSERT(t, a->GetValue("y") == nullptr);
+    TR_ASSERT(t, brokenDoc->HasErrors());
+
+    for(auto text : { R"([1, 2,])", R"({ "k" : nope })", R"({ "k" 1 })", R"({ "k" : 1, })", R"([1 2])" }) {
+        auto itemDoc = JSONParser::LoadLazy(text);
+        TR_ASSERT(t, itemDoc != nullptr);
+        if (auto object = std::get_if<JSONObject::Ref>(&itemDoc->GetRoot())) {
+            (*object)->Size();
+        } else {
+            (*std::get_if<JSONArray::Ref>(&itemDoc->GetRoot()))->Size();
+        }
+        TR_ASSERT(t, itemDoc->HasErrors());
+    }
+    return kTR_Pass;
+}
+
+extern "C" int test_jsonparser_lazy_threads(ITesting *t) {
+    std::string data = "[";
+    for(int i=0;i<200;i++) {
+        data += (i ? ",{\"id\":" : "{\"id\":") + std::to_string(i) + ",\"sub\":[" + std::to_string(i * 2) + "]}";
+    }
+    data += "]";
+    std::shared_ptr<const JSONDoc> doc = JSONParser::LoadLazy(data);
+    TR_ASSERT(t, doc != nullptr);
+
+    // all threads race to expand the same nodes
+    std::atomic<int> nFailed = 0;
+    std::vector<std::thread> threads;
+    for(int i=0;i<8;i++) {
+        threads.emplace_back([doc, &nFailed]() {
+            auto array = *std::get_if<JSONArray::Ref>(&doc->GetRoot());
+            for(int n=0;n<200;n++) {
+                auto item = array->At(n)->GetAsObject();
+                if ((item->GetValue("id")->GetAsString() != std::to_string(n)) ||
+                    (item->GetValue("sub")->GetAsArray()->At(0)->GetAsString() != std::to_string(n * 2))) {
+                    nFailed++;
+                }
+            }
+        });
+    }
+    for(auto &thread : threads) {
+        thread.join();
+    }
+    TR_ASSERT(t, nFailed == 0);
+    return kTR_Pass;
+}
@@ -218,3 +218,74 @@ extern "C" int test_jsonunmarshal_object_nested(ITesting *t) {
     return kTR_Pass;
 }
 
+
+namespace {
+    class TypedObject : public BaseUnmarshalTyped {
+    public:
+        bool SetInt(std::string_view fieldName, int64_t value) override {
+            if (fieldName != "int") return false;
+            intValue = value;
+            return true;
+        }
+        bool SetDouble(std::string_view fieldName, double value) override {
+            // other doubles fall back to SetField
+            if (fieldName != "double") return BaseUnmarshalTyped::SetDouble(fieldName, value);
+            doubleValue = value;
+            return true;
+        }
+        bool SetBool(std::string_view fieldName, bool value) override {
+            if (fieldName != "bool") return false;
+            boolValue = value;
+            return true;
+        }
+        bool SetNull(std::string_view fieldName) override {
+            if (fieldName != "null") return false;
+            hasNull = true;
+            return true;
+        }
+        bool SetString(std::string_view fieldName, std::string_view value) override {
+            if (fieldName == "array") {
+                // falls back to SetField
+                return BaseUnmarshalTyped::SetString(fieldName, value);
+            }
+            if (fieldName != "string") return false;
+            stringValue = value;
+            return true;
+        }
+        bool SetField(const std::string &fieldName, const std::string &fieldValue) override {
+            legacy.push_back(fieldValue);
+            return true;
+        }
+    public:
+        int64_t intValue = 0;
+        double doubleValue = 0;
+        bool boolValue = false;
+        bool hasNull = false;
+        std::string stringValue;
+        std::vector<std::string> legacy;
+    };
+}
+
+extern "C" int test_jsonunmarshal_typed(ITesting *t) {
+    std::string data = "{ \"int\" : 9007199254740993, \"double\" : 1.25, \"bool\" : true, \"null\" : null, \"string\" : \"123\", \"array\" : [\"a\", \"b\"] }";
+
+    JSONDecoder decoder(data);
+    TypedObject object;
+    TR_ASSERT(t, decoder.Unmarshal(&object));
+    TR_ASSERT(t, object.intValue == 9007199254740993);
+    TR_ASSERT(t, fabs(object.doubleValue - 1.25) < 0.0001);
+    TR_ASSERT(t, object.boolValue);
+    TR_ASSERT(t, object.hasNull);
+    TR_ASSERT(t, object.stringValue == "123");
+    TR_ASSERT(t, object.legacy.size() == 2);
+
+    // doubles falling back to SetField keep their precision, std::to_string gave "0.000000"
+    std::string small = "{ \"other\" : 0.0000001, \"third\" : 0.1 }";
+    JSONDecoder smallDecoder(small);
+    TypedObject fallback;
+    TR_ASSERT(t, smallDecoder.Unmarshal(&fallback));
+    TR_ASSERT(t, fallback.legacy.size() == 2);
+    TR_ASSERT(t, fallback.legacy[0] == "1e-07");
+    TR_ASSERT(t, fallback.legacy[1] == "0.1");
+    return kTR_Pass;
+}
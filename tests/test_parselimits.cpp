@@ -0,0 +1,166 @@
+//
+// Created by gnilk on 19.10.2026.
+//
+#include <testinterface.h>
+#include <string>
+#include "ParseLimits.h"
+#include "JSONParser.h"
+#include "JSONDecoder.h"
+#include "XMLParser.h"
+#include "XMLDecoder.h"
+#include "IniParser.h"
+
+using namespace gnilk;
+using kLimit = ParseLimits::kLimit;
+
+static kLimit ParseJSON(const std::string &data, const ParseLimits &limits) {
+    JSONParser parser(data);
+    parser.SetLimits(limits);
+    auto doc = parser.GetDocument();
+    if ((doc == nullptr) && (parser.GetExceededLimit() == kLimit::kNone)) {
+        // not because of a limit
+        return kLimit::kSteps;
+    }
+    return parser.GetExceededLimit();
+}
+
+extern "C" int test_parselimits_json(ITesting *t) {
+    static std::string data = R"({ "name" : "some text", "list" : [1, 2, 3, 4], "sub" : { "a" : { "b" : [ {} ] } } })";
+    ParseLimits limits;
+    TR_ASSERT(t, ParseJSON(data, limits) == kLimit::kNone);
+
+    limits = {};
+    limits.maxBytes = 20;
+    TR_ASSERT(t, ParseJSON(data, limits) == kLimit::kBytes);
+    TR_ASSERT(t, JSONParser::Load(data, limits) == nullptr);
+
+    limits = {};
+    limits.maxStringLength = 8;
+    TR_ASSERT(t, ParseJSON(data, limits) == kLimit::kStringLength);
+
+    limits = {};
+    limits.maxMembers = 2;
+    TR_ASSERT(t, ParseJSON(data, limits) == kLimit::kMembers);
+
+    limits = {};
+    limits.maxArrayLength = 3;
+    TR_ASSERT(t, ParseJSON(data, limits) == kLimit::kArrayLength);
+
+    limits = {};
+    limits.maxSteps = 5;
+    TR_ASSERT(t, ParseJSON(data, limits) == kLimit::kSteps);
+
+    // depth keeps its own error code
+    limits = {};
+    limits.maxDepth = 3;
+    JSONParser parser(data);
+    parser.SetLimits(limits);
+    TR_ASSERT(t, parser.GetDocument() == nullptr);
+    TR_ASSERT(t, parser.GetExceededLimit() == kLimit::kDepth);
+    return kTR_Pass;
+}
+
+extern "C" int test_parselimits_deadline(ITesting *t) {
+    std::string data = "[";
+    for(size_t i=0;i<4 * ParseLimits::kDeadlineInterval;i++) {
+        data += (i ? ",1" : "1");
+    }
+    data += "]";
+
+    ParseLimits limits;
+    limits.deadline = std::chrono::steady_clock::now() + std::chrono::hours(1);
+    TR_ASSERT(t, ParseJSON(data, limits) == kLimit::kNone);
+    limits.deadline = std::chrono::steady_clock::now() - std::chrono::seconds(1);
+    TR_ASSERT(t, ParseJSON(data, limits) == kLimit::kDeadline);
+    return kTR_Pass;
+}
+
+extern "C" int test_parselimits_xml(ITesting *t) {
+    static std::string data = R"(<root><a x="1" y="2" z="3"><b><c>some content</c></b></a><d></d><e></e></root>)";
+    ParseLimits limits;
+    xml::XMLParser ok(data, limits);
+    TR_ASSERT(t, ok.GetDocument() != nullptr);
+
+    auto expect = [&](const ParseLimits &useLimits, kLimit expected) {
+        xml::XMLParser parser(data, useLimits);
+        return (parser.GetDocument() == nullptr) && (parser.GetExceededLimit() == expected);
+    };
+    limits = {};
+    limits.maxDepth = 3;
+    TR_ASSERT(t, expect(limits, kLimit::kDepth));
+    limits = {};
+    limits.maxAttributes = 2;
+    TR_ASSERT(t, expect(limits, kLimit::kAttributes));
+    limits = {};
+    limits.maxStringLength = 10;
+    TR_ASSERT(t, expect(limits, kLimit::kStringLength));
+    limits = {};
+    limits.maxMembers = 2;
+    TR_ASSERT(t, expect(limits, kLimit::kMembers));
+    limits = {};
+    limits.maxBytes = 10;
+    TR_ASSERT(t, expect(limits, kLimit::kBytes));
+    limits = {};
+    limits.maxSteps = 3;
+    TR_ASSERT(t, expect(limits, kLimit::kSteps));
+
+    // XML has a default depth limit now
+    std::string deep;
+    for(int i=0;i<1000;i++) deep += "<a>";
+    for(int i=0;i<1000;i++) deep += "</a>";
+    TR_ASSERT(t, xml::XMLParser::Load(deep) == nullptr);
+    return kTR_Pass;
+}
+
+extern "C" int test_parselimits_ini(ITesting *t) {
+    static std::string data = "[section]\nkey1 = value1\nkey2 = a longer value\nkey3 = value3\n";
+    auto parser = IniParser::Create(data);
+    TR_ASSERT(t, parser->ProcessData());
+    TR_ASSERT(t, parser->GetSection("section") != nullptr);
+
+    ParseLimits limits;
+    limits.maxMembers = 2;
+    parser = IniParser::Create(data);
+    parser->SetLimits(limits);
+    TR_ASSERT(t, !parser->ProcessData());
+    TR_ASSERT(t, parser->GetExceededLimit() == kLimit::kMembers);
+    // nothing half parsed is left behind
+    TR_ASSERT(t, parser->GetSection("section") == nullptr);
+
+    limits = {};
+    limits.maxStringLength = 10;
+    parser = IniParser::Create(data);
+    parser->SetLimits(limits);
+    TR_ASSERT(t, !parser->ProcessData());
+    TR_ASSERT(t, parser->GetExceededLimit() == kLimit::kStringLength);
+
+    limits = {};
+    limits.maxBytes = 16;
+    parser = IniParser::Create(data);
+    parser->SetLimits(limits);
+    TR_ASSERT(t, !parser->ProcessData());
+    TR_ASSERT(t, parser->GetExceededLimit() == kLimit::kBytes);
+    return kTR_Pass;
+}
+
+extern "C" int test_parselimits_decoder(ITesting *t) {
+    static std::string jsonData = R"({ "list" : [1, 2, 3, 4, 5, 6, 7, 8] })";
+    static std::string xmlData = R"(<root><a x="1" y="2"/></root>)";
+    ParseLimits limits;
+    limits.maxArrayLength = 4;
+    limits.maxAttributes = 1;
+
+    JSONDecoder jsonDecoder;
+    jsonDecoder.SetParseLimits(limits);
+    jsonDecoder.Begin(jsonData);
+    TR_ASSERT(t, !jsonDecoder.IsValid());
+    jsonDecoder.SetParseLimits({});
+    jsonDecoder.Begin(jsonData);
+    TR_ASSERT(t, jsonDecoder.IsValid());
+
+    XMLDecoder xmlDecoder;
+    xmlDecoder.SetParseLimits(limits);
+    xmlDecoder.Begin(xmlData);
+    TR_ASSERT(t, !xmlDecoder.BeginObject("a"));
+    return kTR_Pass;
+}
@@ -0,0 +1,101 @@
+//
+// Created by gnilk on 19.10.2026.
+//
+#include <testinterface.h>
+#include <string>
+#include "../src/PerfectHash.h"
+#include "../src/IUnmarshal.h"
+#include "../src/DecoderHelpers.h"
+#include "../src/JSONDecoder.h"
+
+using namespace gnilk;
+
+extern "C" int test_perfecthash_table(ITesting *t) {
+    static constexpr PerfectHash<4> table({"id", "name", "ts", "value"});
+    static_assert(table.Find("ts") == 2);
+
+    TR_ASSERT(t, table.Find("id") == 0);
+    TR_ASSERT(t, table.Find("name") == 1);
+    TR_ASSERT(t, table.Find("value") == 3);
+    TR_ASSERT(t, table.Find("Value") == -1);
+    TR_ASSERT(t, table.Find("") == -1);
+    TR_ASSERT(t, table.Find("identifier") == -1);
+    return kTR_Pass;
+}
+
+extern "C" int test_perfecthash_wide(ITesting *t) {
+    using Fields = FieldSwitch<
+                                "id", "name", "ts", "f3", "f4", "f5", "f6", "f7", "f8", "f9", "f10", "f11",
+                                "f12", "f13", "f14", "f15", "f16", "f17", "f18", "f19", "f20", "f21", "f22",
+                                "f23", "f24", "f25", "f26", "f27", "f28", "f29", "f30", "f31", "f32", "f33",
+                                "f34", "f35", "f36", "f37", "f38", "f39", "f40", "f41", "f42", "f43", "f44",
+                                "f45", "f46", "f47", "f48", "f49", "f50", "f51", "f52", "f53", "f54", "f55",
+                                "f56", "f57", "f58", "f59", "f60", "f61", "f62", "f63", "f64", "f65", "f66",
+                                "f67", "f68", "f69", "f70", "f71", "f72", "f73", "f74", "f75", "f76", "f77",
+                                "f78", "f79", "f80", "f81", "f82", "f83", "f84", "f85", "f86", "f87", "f88",
+                                "f89", "f90", "f91", "f92", "f93", "f94", "f95", "f96", "f97", "f98", "f99",
+                                "f100", "f101", "f102", "f103", "f104", "f105", "f106", "f107", "f108",
+                                "f109", "f110", "f111", "f112", "f113", "f114", "f115", "f116", "f117",
+                                "f118", "f119", "f120", "f121", "f122", "f123", "f124", "f125", "f126",
+                                "f127", "f128", "f129", "f130", "f131", "f132", "f133", "f134", "f135",
+                                "f136", "f137", "f138", "f139">;
+
+    TR_ASSERT(t, Fields::Size() == 140);
+    for(size_t i=0;i<Fields::Size();i++) {
+        TR_ASSERT(t, Fields::Index(Fields::Name(i)) == (int)i);
+    }
+    TR_ASSERT(t, Fields::Index("f140") == -1);
+    TR_ASSERT(t, Fields::IndexOf("f139") == 139);
+    return kTR_Pass;
+}
+
+namespace {
+    enum class kColor {
+        Red,
+        Green,
+        Blue,
+    };
+    using ColorNames = EnumSwitch<kColor, "red", "green", "blue">;
+
+    class Message : public BaseUnmarshal {
+    public:
+        bool SetField(const std::string &fieldName, const std::string &fieldValue) override {
+            using Fields = FieldSwitch<"id", "name", "color">;
+            switch(Fields::Index(fieldName)) {
+                case Fields::IndexOf("id") :
+                    id = *convert_to<int>(fieldValue);
+                    return true;
+                case Fields::IndexOf("name") :
+                    name = fieldValue;
+                    return true;
+                case Fields::IndexOf("color") :
+                    color = ColorNames::FromString(fieldValue).value_or(kColor::Red);
+                    return true;
+                default:
+                    return false;
+            }
+        }
+    public:
+        int id = 0;
+        std::string name;
+        kColor color = kColor::Red;
+    };
+}
+
+extern "C" int test_perfecthash_enum(ITesting *t) {
+    TR_ASSERT(t, ColorNames::FromString("green") == kColor::Green);
+    TR_ASSERT(t, !ColorNames::FromString("yellow").has_value());
+    TR_ASSERT(t, ColorNames::ToString(kColor::Blue) == "blue");
+    return kTR_Pass;
+}
+
+extern "C" int test_perfecthash_unmarshal(ITesting *t) {
+    std::string data = "{ \"id\" : 12, \"name\" : \"msg\", \"color\" : \"blue\", \"other\" : 1 }";
+    JSONDecoder decoder(data);
+    Message msg;
+    TR_ASSERT(t, decoder.Unmarshal(&msg));
+    TR_ASSERT(t, msg.id == 12);
+    TR_ASSERT(t, msg.name == "msg");
+    TR_ASSERT(t, msg.color == kColor::Blue);
+    return kTR_Pass;
+}
@@ -0,0 +1,130 @@
+//
+// Created by gnilk on 19.10.2026.
+//
+#include <testinterface.h>
+#include "../src/FieldDescriptors.h"
+#include "../src/JSONDecoder.h"
+#include "../src/XMLDecoder.h"
+
+using namespace gnilk;
+
+namespace {
+    struct Item {
+        int64_t id = 0;
+        std::string name;
+        double price = 0;
+    };
+    struct Catalog {
+        std::vector<Item> items;
+    };
+}
+
+GNILK_DESCRIBE(Item, GNILK_FIELD(id), GNILK_FIELD(name), GNILK_FIELD(price));
+GNILK_DESCRIBE(Catalog, GNILK_FIELD(items));
+
+extern "C" int test_shapecache_json(ITesting *t) {
+    std::string data = R"({"items":[
+        {"id":1,"name":"a","price":1.5},
+        {"id":2,"name":"b","price":2.5},
+        {"id":3,"name":"c","price":3.5},
+        {"id":4,"name":"d","price":4.5}
+    ]})";
+
+    Catalog catalog;
+    DescribedUnmarshal<Catalog> unmarshal(catalog);
+    JSONDecoder decoder(data);
+    TR_ASSERT(t, decoder.Unmarshal(&unmarshal));
+    TR_ASSERT(t, catalog.items.size() == 4);
+    TR_ASSERT(t, catalog.items[3].id == 4);
+    TR_ASSERT(t, catalog.items[3].name == "d");
+    TR_ASSERT(t, catalog.items[3].price == 4.5);
+
+    // first item learns the shape, the rest hit
+    auto stats = decoder.GetShapeCache()->GetStats();
+    TR_ASSERT(t, stats.misses == 3 + 1);     // Item keys + 'items' of Catalog
+    TR_ASSERT(t, stats.hits == 3 * 3);
+    TR_ASSERT(t, stats.shapes == 2);
+    return kTR_Pass;
+}
+
+extern "C" int test_shapecache_relearn(ITesting *t) {
+    auto cache = ShapeCache::Create();
+    std::string first = R"({"items":[{"id":1,"name":"a"}]})";
+    std::string second = R"({"items":[{"id":2,"name":"b","price":2.5}]})";
+
+    Catalog catalog;
+    DescribedUnmarshal<Catalog> unmarshal(catalog);
+    JSONDecoder decoder(first);
+    decoder.SetShapeCache(cache);
+    TR_ASSERT(t, decoder.Unmarshal(&unmarshal));
+
+    // The shape grows with the new key, values must still land in the right members
+    Catalog other;
+    DescribedUnmarshal<Catalog> otherUnmarshal(other);
+    JSONDecoder otherDecoder(second);
+    otherDecoder.SetShapeCache(cache);
+    TR_ASSERT(t, otherDecoder.Unmarshal(&otherUnmarshal));
+    TR_ASSERT(t, other.items.size() == 1);
+    TR_ASSERT(t, other.items[0].id == 2);
+    TR_ASSERT(t, other.items[0].name == "b");
+    TR_ASSERT(t, other.items[0].price == 2.5);
+    return kTR_Pass;
+}
+
+extern "C" int test_shapecache_xml(ITesting *t) {
+    std::string data = R"(<Catalog><items id="1" name="a" price="1.5"/><items id="2" name="b" price="2.5"/></Catalog>)";
+
+    Catalog catalog;
+    DescribedUnmarshal<Catalog> unmarshal(catalog);
+    XMLDecoder decoder(data);
+    TR_ASSERT(t, decoder.Unmarshal(&unmarshal));
+    TR_ASSERT(t, catalog.items.size() == 2);
+    TR_ASSERT(t, catalog.items[1].id == 2);
+    TR_ASSERT(t, catalog.items[1].name == "b");
+    TR_ASSERT(t, catalog.items[1].price == 2.5);
+    auto stats = decoder.GetShapeCache()->GetStats();
+    TR_ASSERT(t, stats.hits == 3);
+    return kTR_Pass;
+}
+
+namespace {
+    // Slots are the index in 'fields'
+    class SlotObject : public IUnmarshalSlots {
+    public:
+        int ResolveSlot(std::string_view fieldName) override {
+            nResolved++;
+            for(size_t i=0;i<fields.size();i++) {
+                if (fields[i] == fieldName) return static_cast<int>(i);
+            }
+            return -1;
+        }
+        bool SetSlot(int slot, const UnmarshalValue &value) override {
+            return true;
+        }
+    public:
+        std::vector<std::string> fields = {"a", "b", "c", "d"};
+        size_t nResolved = 0;
+    };
+}
+
+extern "C" int test_shapecache_nested(ITesting *t) {
+    ShapeCache cache;
+    SlotObject object;
+    auto outer = cache.Begin(&object);
+    TR_ASSERT(t, cache.Resolve(outer, "a") == 0);
+    TR_ASSERT(t, cache.Resolve(outer, "b") == 1);
+    TR_ASSERT(t, cache.Resolve(outer, "c") == 2);
+    // a nested object of the same class relearns the shared shape with a single key
+    auto inner = cache.Begin(&object);
+    TR_ASSERT(t, cache.Resolve(inner, "b") == 1);
+    // the outer object continues past the end of the shorter shape
+    TR_ASSERT(t, cache.Resolve(outer, "d") == 3);
+
+    // the gap is padding, an empty key there is resolved by the object - not taken from the padding
+    auto next = cache.Begin(&object);
+    TR_ASSERT(t, cache.Resolve(next, "b") == 1);
+    auto nResolved = object.nResolved;
+    TR_ASSERT(t, cache.Resolve(next, "") == -1);
+    TR_ASSERT(t, object.nResolved == nResolved + 1);
+    return kTR_Pass;
+}
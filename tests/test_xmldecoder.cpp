@@ -3,6 +3,9 @@
 //
 
 #include <testinterface.h>
+#include <thread>
+#include <atomic>
+#include <vector>
 #include "XMLDecoder.h"
 
 using namespace gnilk;
@@ -13,3 +16,92 @@ extern "C" int test_xmldecoder_simple(ITesting *t) {
 
     return kTR_Pass;
 }
+
+namespace {
+    class Route : public BaseUnmarshal {
+    public:
+        bool SetField(const std::string &fieldName, const std::string &fieldValue) override {
+            if (fieldName == "path") path = fieldValue;
+            else if (fieldName == "target") target = fieldValue;
+            else return false;
+            return true;
+        }
+    public:
+        std::string path;
+        std::string target;
+    };
+}
+
+extern "C" int test_xmldecoder_shared_document(ITesting *t) {
+    static std::string data = R"(<route path="/a" target="svc-a"/>)";
+
+    std::shared_ptr<const xml::Document> doc = xml::XMLParser::Load(data);
+    TR_ASSERT(t, doc != nullptr);
+
+    std::atomic<int> nFailed = 0;
+    std::vector<std::thread> threads;
+    for(int i=0;i<8;i++) {
+        threads.emplace_back([doc, &nFailed]() {
+            for(int n=0;n<1000;n++) {
+                XMLDecoder decoder(*doc);
+                Route route;
+                if (!decoder.Unmarshal(&route) || (route.path != "/a") || (route.target != "svc-a")) {
+                    nFailed++;
+                }
+                // API based reads go through the same document
+                if (!decoder.BeginObject("route") || (decoder.ReadTextField("target") != "svc-a")) {
+                    nFailed++;
+                }
+                decoder.EndObject();
+            }
+        });
+    }
+    for(auto &thread : threads) {
+        thread.join();
+    }
+    TR_ASSERT(t, nFailed == 0);
+    return kTR_Pass;
+}
+
+extern "C" int test_xmldecoder_array(ITesting *t) {
+    static std::string data = "<order><line qty=\"2\">apple</line><note>x</note><line qty=\"5\">pear</line><total>7</total></order>";
+    XMLDecoder decoder;
+    decoder.Begin(data);
+    TR_ASSERT(t, decoder.BeginObject("order"));
+
+    // all children named 'line' - the same count ReserveArray gets when unmarshalling
+    auto it = decoder.BeginArray("line");
+    TR_ASSERT(t, it->Size() == 2);
+    std::vector<std::string> names;
+    std::vector<int> quantities;
+    for(;!it->End();it->Next()) {
+        TR_ASSERT(t, it->IsObject());
+        names.push_back(it->ReadText());
+        TR_ASSERT(t, decoder.BeginObject("line"));
+        quantities.push_back(*decoder.ReadIntField("qty"));
+        decoder.EndObject();
+    }
+    decoder.EndArray();
+    TR_ASSERT(t, names.size() == 2);
+    TR_ASSERT(t, names[0] == "apple");
+    TR_ASSERT(t, names[1] == "pear");
+    TR_ASSERT(t, quantities[0] == 2);
+    TR_ASSERT(t, quantities[1] == 5);
+
+    // leaf items are read from their content
+    auto itTotal = decoder.BeginArray("total");
+    TR_ASSERT(t, !itTotal->End());
+    TR_ASSERT(t, !itTotal->IsObject());
+    TR_ASSERT(t, itTotal->ReadInt() == 7);
+    itTotal->Next();
+    TR_ASSERT(t, itTotal->End());
+    decoder.EndArray();
+
+    // unknown names give an empty array
+    auto itNone = decoder.BeginArray("missing");
+    TR_ASSERT(t, itNone->End());
+    TR_ASSERT(t, itNone->Size() == 0);
+    decoder.EndArray();
+    decoder.EndObject();
+    return kTR_Pass;
+}
@@ -4,8 +4,11 @@
 
 #include <testinterface.h>
 
+#include <vector>
 #include "FileWriter.h"
 #include "XMLEncoder.h"
+#include "XMLParser.h"
+#include "CaptureWriter.h"
 
 using namespace gnilk;
 
@@ -82,3 +85,44 @@ extern "C" int test_xmlencoder_feature(ITesting *t) {
 
     return kTR_Pass;
 }
+
+extern "C" int test_xmlencoder_array(ITesting *t) {
+    auto cw = std::make_shared<CaptureWriter>();
+    XMLEncoder encoder(cw);
+
+    std::vector<int64_t> ints = {1, 2};
+    encoder.BeginObject("Root");
+    encoder.BeginArray("item");
+    encoder.WriteIntField("", 7);
+    encoder.BeginObject("", {{"id", 1}});
+    encoder.EndObject();
+    encoder.EndArray();
+    encoder.WriteIntArray("num", ints);
+    encoder.EndObject();
+
+    TR_ASSERT(t, cw->text == "<Root><item>7</item><item id=\"1\"></item><num>1</num><num>2</num></Root>");
+    return kTR_Pass;
+}
+
+extern "C" int test_xmlencoder_escape(ITesting *t) {
+    auto cw = std::make_shared<CaptureWriter>();
+    XMLEncoder encoder(cw);
+
+    encoder.BeginObject("Root", {{"title", std::string("say \"a < b\" & 'c'")}});
+    encoder.WriteTextField("text", "fish & chips <tag>");
+    encoder.WriteTextField("clean", "nothing to escape");
+    encoder.EndObject();
+
+    TR_ASSERT(t, cw->text.find("title=\"say &quot;a &lt; b&quot; &amp; &apos;c&apos;\"") != std::string::npos);
+    TR_ASSERT(t, cw->text.find("<text>fish &amp; chips &lt;tag&gt;</text>") != std::string::npos);
+    TR_ASSERT(t, cw->text.find("<clean>nothing to escape</clean>") != std::string::npos);
+
+    // and back again
+    auto doc = xml::XMLParser::Load(cw->text);
+    TR_ASSERT(t, doc != nullptr);
+    auto root = doc->GetRoot()->GetFirstChild("Root");
+    TR_ASSERT(t, root != nullptr);
+    TR_ASSERT(t, root->GetAttributeValue("title", "") == "say \"a < b\" & 'c'");
+    TR_ASSERT(t, root->GetFirstChild("text")->GetContent() == "fish & chips <tag>");
+    return kTR_Pass;
+}
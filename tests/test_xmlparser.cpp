@@ -2,8 +2,12 @@
 // Created by gnilk on 19.12.2025.
 //
 #include <string>
+#include <vector>
+#include <algorithm>
+#include <string.h>
 #include <testinterface.h>
 #include "../src/XMLParser.h"
+#include "../src/XMLEntities.h"
 
 using namespace gnilk;
 
@@ -100,3 +104,322 @@ extern "C" int test_xmlparser_nested_one(ITesting *t) {
     return kTR_Pass;
 }
 
+
+namespace {
+    // Hands out the data a few bytes at a time
+    class TrickleReader : public IReader {
+    public:
+        explicit TrickleReader(const std::string &useData) : data(useData) {}
+        int32_t Read(void *out, size_t maxbytes) override {
+            auto n = std::min(std::min(maxbytes, data.size() - idx), (idx % 3) + 1);
+            memcpy(out, data.data() + idx, n);
+            idx += n;
+            return static_cast<int32_t>(n);
+        }
+        bool Available() override {
+            return idx < data.size();
+        }
+    protected:
+        std::string data;
+        size_t idx = 0;
+    };
+
+    // Produces '<feed><item id="0">text</item>...</feed>' without ever holding it
+    class FeedReader : public IReader {
+    public:
+        explicit FeedReader(size_t items) : nItems(items) {}
+        int32_t Read(void *out, size_t maxbytes) override {
+            if (pos == chunk.size()) {
+                pos = 0;
+                if (idxItem > nItems) {
+                    return 0;
+                }
+                chunk = (idxItem == nItems) ? "</feed>" : "<item id=\"" + std::to_string(idxItem) + "\">text</item>";
+                if (idxItem == 0) {
+                    chunk = "<feed>" + chunk;
+                }
+                idxItem++;
+            }
+            auto n = std::min(maxbytes, chunk.size() - pos);
+            memcpy(out, chunk.data() + pos, n);
+            pos += n;
+            return static_cast<int32_t>(n);
+        }
+        bool Available() override {
+            return idxItem <= nItems;
+        }
+    protected:
+        size_t nItems;
+        size_t idxItem = 0;
+        std::string chunk;
+        size_t pos = 0;
+    };
+
+    class CountEvents : public xml::IParseEvents {
+    public:
+        void StartTag(xml::Tag::Ref pTag) override {
+            if (pTag->GetName() == "item") {
+                nItems++;
+            }
+        }
+        void EndTag(xml::Tag::Ref pTag) override {
+            if (pTag->GetName() == "item") {
+                isContentOk = isContentOk && (pTag->GetContent() == "text");
+            }
+        }
+        void ContentTag(xml::Tag::Ref pTag, const std::string &content) override {}
+    public:
+        size_t nItems = 0;
+        bool isContentOk = true;
+    };
+}
+
+extern "C" int test_xmlparser_stream(ITesting *t) {
+    // comments rewind on '<!-', make sure that works over the window boundary as well
+    static std::string data = "<?xml version=\"1.0\"?>\n<!-- comment --><root><node field=\"value\" other='x'>content</node>"
+                              "<!-- another --><list><item id=\"1\" /><item id=\"2\" /></list></root>";
+    auto expected = xml::XMLParser::Load(data);
+    TR_ASSERT(t, expected != nullptr);
+
+    xml::XMLParser parser(std::make_shared<TrickleReader>(data));
+    parser.SetWindowSize(1);
+    auto doc = parser.GetDocument();
+    TR_ASSERT(t, doc != nullptr);
+
+    auto root = doc->GetRoot()->GetFirstChild("root");
+    TR_ASSERT(t, root != nullptr);
+    TR_ASSERT(t, root->GetChildren().size() == expected->GetRoot()->GetFirstChild("root")->GetChildren().size());
+    auto node = root->GetFirstChild("node");
+    TR_ASSERT(t, node->GetAttributeValue("field", "") == "value");
+    TR_ASSERT(t, node->GetAttributeValue("other", "") == "x");
+    TR_ASSERT(t, node->GetContent() == "content");
+    auto list = root->GetFirstChild("list");
+    TR_ASSERT(t, list != nullptr);
+    TR_ASSERT(t, list->GetChildren().size() == 2);
+    TR_ASSERT(t, list->GetChildren().back()->GetAttributeValue("id", "") == "2");
+    return kTR_Pass;
+}
+
+extern "C" int test_xmlparser_stream_events(ITesting *t) {
+    // Only events, no document - memory stays at the window size however long the feed is
+    CountEvents events;
+    xml::XMLParser parser(std::make_shared<FeedReader>(100000), &events);
+    parser.SetParseMode(xml::XMLParser::pmStream);
+    parser.SetWindowSize(4096);
+    auto doc = parser.GetDocument();
+    TR_ASSERT(t, doc != nullptr);
+    TR_ASSERT(t, doc->GetRoot()->GetChildren().empty());
+    TR_ASSERT(t, events.nItems == 100000);
+    TR_ASSERT(t, events.isContentOk);
+    return kTR_Pass;
+}
+
+extern "C" int test_xmlparser_runs(ITesting *t) {
+    // content and values are scanned in runs, make sure the stop chars are the only ones stopping them
+    std::string longContent(100000, 'x');
+    static std::string data;
+    data = "<root><a q=\"it's > 1\" s='say \"hi\"'>" + longContent + " > " + longContent + "</a>"
+           "<b\tattr=\"1\"\n/><c>tail</c></root>";
+    auto doc = xml::XMLParser::Load(data);
+    TR_ASSERT(t, doc != nullptr);
+    auto root = doc->GetRoot()->GetFirstChild("root");
+    TR_ASSERT(t, root != nullptr);
+    auto a = root->GetFirstChild("a");
+    TR_ASSERT(t, a != nullptr);
+    TR_ASSERT(t, a->GetAttributeValue("q", "") == "it's > 1");
+    TR_ASSERT(t, a->GetAttributeValue("s", "") == "say \"hi\"");
+    TR_ASSERT(t, a->GetContent() == longContent + " > " + longContent);
+    auto b = root->GetFirstChild("b");
+    TR_ASSERT(t, b != nullptr);
+    TR_ASSERT(t, b->GetAttributeValue("attr", "") == "1");
+    TR_ASSERT(t, root->GetFirstChild("c")->GetContent() == "tail");
+
+    // same thing through a small window
+    xml::XMLParser parser(std::make_shared<TrickleReader>(data));
+    parser.SetWindowSize(64);
+    auto docStream = parser.GetDocument();
+    TR_ASSERT(t, docStream != nullptr);
+    TR_ASSERT(t, docStream->GetRoot()->GetFirstChild("root")->GetFirstChild("a")->GetContent() == a->GetContent());
+    return kTR_Pass;
+}
+
+extern "C" int test_xmlparser_dom(ITesting *t) {
+    static std::string data = "<root><a x=\"1\" y=\"2\"><b>one</b><b>two</b><c/></a><d></d></root>";
+    auto doc = xml::XMLParser::Load(data);
+    TR_ASSERT(t, doc != nullptr);
+    TR_ASSERT(t, doc->GetArenaSize() > 0);
+
+    auto root = doc->GetRoot()->GetFirstChild("root");
+    TR_ASSERT(t, root != nullptr);
+    TR_ASSERT(t, root->GetParent() == doc->GetRoot());
+    TR_ASSERT(t, root->GetChildren().size() == 2);
+
+    auto a = root->GetChildren()[0];
+    TR_ASSERT(t, a->GetName() == "a");
+    TR_ASSERT(t, a->GetParent() == root);
+    TR_ASSERT(t, a->GetAttributes().size() == 2);
+    TR_ASSERT(t, a->GetAttributes()[1].GetName() == "y");
+    TR_ASSERT(t, a->GetAttributes()[1].GetValue() == "2");
+
+    auto children = a->GetChildren();
+    TR_ASSERT(t, children.size() == 3);
+    TR_ASSERT(t, children[0]->GetContent() == "one");
+    TR_ASSERT(t, children[1]->GetContent() == "two");
+    TR_ASSERT(t, children[1]->GetParent() == a);
+    TR_ASSERT(t, children[2]->GetName() == "c");
+    return kTR_Pass;
+}
+
+namespace {
+    // Keeps the 'id' of every item except the ones inside <skip>
+    class ItemFilter : public xml::ISaxEvents {
+    public:
+        bool StartElement(std::string_view name, std::span<const xml::Attribute> attributes) override {
+            if (name == "skip") {
+                return false;
+            }
+            if (name == "item") {
+                for(auto &attr : attributes) {
+                    if (attr.GetName() == "id") {
+                        ids.emplace_back(attr.GetValue());
+                    }
+                }
+            }
+            depth++;
+            maxDepth = std::max(depth, maxDepth);
+            return true;
+        }
+        void EndElement(std::string_view name) override {
+            depth--;
+        }
+        void Content(std::string_view name, std::string_view content) override {
+            contents.emplace_back(std::string(name) + "=" + std::string(content));
+        }
+    public:
+        std::vector<std::string> ids;
+        std::vector<std::string> contents;
+        int depth = 0;
+        int maxDepth = 0;
+    };
+}
+
+extern "C" int test_xmlparser_sax(ITesting *t) {
+    static std::string data = "<?xml version=\"1.0\"?><feed><item id=\"1\">first</item>"
+                              "<skip><item id=\"2\">hidden</item><item id=\"3\"/></skip>"
+                              "<item id=\"4\"><name>last</name></item></feed>";
+    ItemFilter filter;
+    TR_ASSERT(t, xml::XMLParser::Parse(data, filter));
+    TR_ASSERT(t, filter.ids.size() == 2);
+    TR_ASSERT(t, filter.ids[0] == "1");
+    TR_ASSERT(t, filter.ids[1] == "4");
+    TR_ASSERT(t, filter.contents.size() == 2);
+    TR_ASSERT(t, filter.contents[0] == "item=first");
+    TR_ASSERT(t, filter.contents[1] == "name=last");
+    // balanced, the skipped element and the declaration have no end event
+    TR_ASSERT(t, filter.depth == 0);
+    TR_ASSERT(t, filter.maxDepth == 3);
+
+    // same from a stream
+    ItemFilter streamFilter;
+    TR_ASSERT(t, xml::XMLParser::Parse(std::make_shared<TrickleReader>(data), streamFilter));
+    TR_ASSERT(t, streamFilter.ids == filter.ids);
+    TR_ASSERT(t, streamFilter.contents == filter.contents);
+    return kTR_Pass;
+}
+
+extern "C" int test_xmlparser_sax_names(ITesting *t) {
+    // every name is different, none of them end up in a name table
+    static std::string data;
+    data = "<feed>";
+    for(int i=0;i<1000;i++) {
+        auto name = "tag" + std::to_string(i);
+        data += "<" + name + " attr" + std::to_string(i) + "=\"x\">" + std::to_string(i) + "</" + name + ">";
+    }
+    data += "</feed>";
+    ItemFilter filter;
+    xml::XMLParser parser(data);
+    parser.SetParseMode(xml::XMLParser::pmStream);
+    parser.SetSaxHandler(&filter);
+    auto doc = parser.GetDocument();
+    TR_ASSERT(t, doc != nullptr);
+    TR_ASSERT(t, filter.contents.size() == 1000);
+    TR_ASSERT(t, filter.contents[999] == "tag999=999");
+    TR_ASSERT(t, doc->FindName("tag999") == xml::NameTable::kNoName);
+    TR_ASSERT(t, doc->FindName("attr999") == xml::NameTable::kNoName);
+    TR_ASSERT(t, doc->GetNames().Size() < 4);
+
+    // end tags still match regardless of case
+    static std::string mixed = "<Feed><Item id=\"1\">a</ITEM><item id=\"2\"><Name>b</NAME></Item></FEED>";
+    ItemFilter mixedFilter;
+    TR_ASSERT(t, xml::XMLParser::Parse(mixed, mixedFilter));
+    TR_ASSERT(t, mixedFilter.ids.size() == 1);
+    TR_ASSERT(t, mixedFilter.ids[0] == "2");
+    TR_ASSERT(t, mixedFilter.contents.size() == 2);
+    TR_ASSERT(t, mixedFilter.contents[1] == "Name=b");
+    TR_ASSERT(t, mixedFilter.depth == 0);
+    TR_ASSERT(t, mixedFilter.maxDepth == 3);
+
+    // attributes of skipped elements are not stored, so they don't count against the limits
+    static std::string skipped = "<feed><skip a=\"1\" b=\"2\"><x c=\"3\" d=\"4\" e=\"5\"/></skip><item id=\"1\"/></feed>";
+    ParseLimits limits;
+    limits.maxAttributes = 2;
+    ItemFilter skipFilter;
+    TR_ASSERT(t, xml::XMLParser::Parse(skipped, skipFilter, limits));
+    TR_ASSERT(t, skipFilter.ids.size() == 1);
+    static std::string notSkipped = "<feed><item c=\"3\" d=\"4\" e=\"5\"/></feed>";
+    TR_ASSERT(t, !xml::XMLParser::Parse(notSkipped, skipFilter, limits));
+    return kTR_Pass;
+}
+
+extern "C" int test_xmlparser_names(ITesting *t) {
+    // end tags match regardless of case
+    static std::string data = "<Root><Item id=\"1\">a</ITEM><item id=\"2\">b</Item><other id=\"3\"/></root>";
+    auto doc = xml::XMLParser::Load(data);
+    TR_ASSERT(t, doc != nullptr);
+    auto root = doc->GetRoot()->GetFirstChild("Root");
+    TR_ASSERT(t, root != nullptr);
+    TR_ASSERT(t, root->GetChildren().size() == 3);
+
+    auto &names = doc->GetNames();
+    auto idItem = doc->FindName("Item");
+    TR_ASSERT(t, idItem != xml::NameTable::kNoName);
+    TR_ASSERT(t, doc->FindName("missing") == xml::NameTable::kNoName);
+    // spellings have their own id, and share the folded one
+    TR_ASSERT(t, doc->FindName("item") != idItem);
+    TR_ASSERT(t, names.GetFolded(idItem) == doc->FindName("item"));
+    TR_ASSERT(t, names.FindFolded("ITEM") == doc->FindName("item"));
+    // stored once
+    auto children = root->GetChildren();
+    TR_ASSERT(t, children[0]->GetNameId() == idItem);
+    TR_ASSERT(t, children[0]->GetAttributes()[0].GetName().data() == children[2]->GetAttributes()[0].GetName().data());
+
+    TR_ASSERT(t, root->GetFirstChild(idItem) == children[0]);
+    TR_ASSERT(t, root->GetFirstChild(doc->FindName("item")) == children[1]);
+
+    // matches the child name (not the parent's) and moves past children that don't match
+    TR_ASSERT(t, root->GetChildWithAttributeValue("item", "id", "2") == children[1]);
+    TR_ASSERT(t, root->GetChildWithAttributeValue("other", "id", "3") == children[2]);
+    TR_ASSERT(t, root->GetChildWithAttributeValue("other", "id", "1") == nullptr);
+    TR_ASSERT(t, root->GetChildWithAttributeValue("item", "missing", "1") == nullptr);
+    return kTR_Pass;
+}
+
+extern "C" int test_xmlparser_references(ITesting *t) {
+    static std::string data = "<root a=\"&quot;q&quot; &amp; &#65;&#x42;\">1 &lt; 2 &gt; 0 &#xE9;&#8364; &unknown; & &#xZZ; &amp</root>";
+    auto doc = xml::XMLParser::Load(data);
+    TR_ASSERT(t, doc != nullptr);
+    auto root = doc->GetRoot()->GetFirstChild("root");
+    TR_ASSERT(t, root->GetAttributeValue("a", "") == "\"q\" & AB");
+    TR_ASSERT(t, root->GetContent() == "1 < 2 > 0 \xc3\xa9\xe2\x82\xac &unknown; & &#xZZ; &amp");
+
+    // empty views have no data to search
+    TR_ASSERT(t, !xml::HasReferences({}));
+    TR_ASSERT(t, xml::HasReferences("a&b"));
+    static std::string empty = "<root a=\"\"></root>";
+    doc = xml::XMLParser::Load(empty);
+    TR_ASSERT(t, doc != nullptr);
+    root = doc->GetRoot()->GetFirstChild("root");
+    TR_ASSERT(t, root->GetAttributeValue("a", "x") == "");
+    TR_ASSERT(t, root->GetContent().empty());
+    return kTR_Pass;
+}
@@ -0,0 +1,135 @@
+//
+// Created by gnilk on 19.10.2026.
+//
+#include <testinterface.h>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include "XMLPath.h"
+
+using namespace gnilk;
+
+extern "C" int test_xmlpath_compile(ITesting *t) {
+    TR_ASSERT(t, xml::XMLPath::Compile("/catalog/book") != nullptr);
+    TR_ASSERT(t, xml::XMLPath::Compile("//item") != nullptr);
+    TR_ASSERT(t, xml::XMLPath::Compile("book/*/title") != nullptr);
+    TR_ASSERT(t, xml::XMLPath::Compile("/a/b[@id][ @kind = \"x\" ]//c") != nullptr);
+    TR_ASSERT(t, xml::XMLPath::Compile("/a")->GetExpression() == "/a");
+
+    TR_ASSERT(t, xml::XMLPath::Compile("") == nullptr);
+    TR_ASSERT(t, xml::XMLPath::Compile("/") == nullptr);
+    TR_ASSERT(t, xml::XMLPath::Compile("/a/") == nullptr);
+    TR_ASSERT(t, xml::XMLPath::Compile("/a[@id='x]") == nullptr);
+    TR_ASSERT(t, xml::XMLPath::Compile("/a[1]") == nullptr);
+    TR_ASSERT(t, xml::XMLPath::Compile("/a[@id]b") == nullptr);
+    TR_ASSERT(t, xml::XMLPath::Compile("/a b") == nullptr);
+    return kTR_Pass;
+}
+
+extern "C" int test_xmlpath_select(ITesting *t) {
+    static std::string data = "<?xml version=\"1.0\"?>"
+                              "<catalog>"
+                              "<book id=\"bk101\" kind=\"novel\"><title>First</title><author>Ann</author></book>"
+                              "<book id=\"bk102\"><title>Second</title><part><title>Inner</title></part></book>"
+                              "<magazine id=\"mg1\"><title>Weekly</title></magazine>"
+                              "</catalog>";
+    auto doc = xml::XMLParser::Load(data);
+    TR_ASSERT(t, doc != nullptr);
+
+    auto tag = xml::XMLPath::Compile("/catalog/book[@id='bk102']/title")->SelectFirst(*doc);
+    TR_ASSERT(t, tag != nullptr);
+    TR_ASSERT(t, tag->GetContent() == "Second");
+
+    auto titles = xml::XMLPath::Compile("//title")->Select(*doc);
+    TR_ASSERT(t, titles.size() == 4);
+    TR_ASSERT(t, titles[0]->GetContent() == "First");
+    TR_ASSERT(t, titles[2]->GetContent() == "Inner");
+    TR_ASSERT(t, titles[3]->GetContent() == "Weekly");
+
+    // '//' below '//' - nested contexts don't give duplicates
+    auto nested = xml::XMLPath::Compile("//*//title")->Select(*doc);
+    TR_ASSERT(t, nested.size() == 4);
+
+    TR_ASSERT(t, xml::XMLPath::Compile("/catalog/*")->Select(*doc).size() == 3);
+    TR_ASSERT(t, xml::XMLPath::Compile("/*")->Select(*doc).size() == 1);
+    TR_ASSERT(t, xml::XMLPath::Compile("/catalog/*[@kind]")->Select(*doc).size() == 1);
+    TR_ASSERT(t, xml::XMLPath::Compile("/catalog/book[@id][@kind='novel']/author")->SelectFirst(*doc)->GetContent() == "Ann");
+
+    // relative to a context
+    auto book = xml::XMLPath::Compile("/catalog/book[@id=\"bk102\"]")->SelectFirst(*doc);
+    TR_ASSERT(t, book != nullptr);
+    auto inner = xml::XMLPath::Compile("part/title")->Select(*doc, book);
+    TR_ASSERT(t, inner.size() == 1);
+    TR_ASSERT(t, inner[0]->GetContent() == "Inner");
+    TR_ASSERT(t, xml::XMLPath::Compile(".//title") == nullptr);
+    TR_ASSERT(t, xml::XMLPath::Compile("title")->Select(*doc, book).size() == 1);
+
+    // nothing matches
+    TR_ASSERT(t, xml::XMLPath::Compile("/catalog/missing")->Select(*doc).empty());
+    TR_ASSERT(t, xml::XMLPath::Compile("/catalog/book[@id='none']")->Select(*doc).empty());
+    TR_ASSERT(t, xml::XMLPath::Compile("/catalog/book[@missing]")->Select(*doc).empty());
+    TR_ASSERT(t, xml::XMLPath::Compile("/book")->Select(*doc).empty());
+    return kTR_Pass;
+}
+
+extern "C" int test_xmlpath_index(ITesting *t) {
+    // enough children for the indexes to be used
+    static std::string data;
+    data = "<root>";
+    for(int i=0;i<200;i++) {
+        auto id = std::to_string(i);
+        data += "<item id=\"" + id + "\" group=\"" + std::to_string(i % 4) + "\"><value>" + id + "</value></item>";
+        data += "<other id=\"" + id + "\"/>";
+    }
+    data += "</root>";
+    auto doc = xml::XMLParser::Load(data);
+    TR_ASSERT(t, doc != nullptr);
+
+    auto byId = xml::XMLPath::Compile("/root/item[@id='123']/value");
+    // twice, the second query goes through the index built by the first
+    for(int n=0;n<2;n++) {
+        auto tags = byId->Select(*doc);
+        TR_ASSERT(t, tags.size() == 1);
+        TR_ASSERT(t, tags[0]->GetContent() == "123");
+    }
+
+    auto group = xml::XMLPath::Compile("/root/item[@group='2']")->Select(*doc);
+    TR_ASSERT(t, group.size() == 50);
+    // document order
+    TR_ASSERT(t, group[0]->GetAttributeValue("id", "") == "2");
+    TR_ASSERT(t, group[49]->GetAttributeValue("id", "") == "198");
+
+    TR_ASSERT(t, xml::XMLPath::Compile("/root/item")->Select(*doc).size() == 200);
+    TR_ASSERT(t, xml::XMLPath::Compile("/root/*")->Select(*doc).size() == 400);
+    TR_ASSERT(t, xml::XMLPath::Compile("/root/*[@id='7']")->Select(*doc).size() == 2);
+    TR_ASSERT(t, xml::XMLPath::Compile("//value")->Select(*doc).size() == 200);
+    TR_ASSERT(t, xml::XMLPath::Compile("//other[@id='199']")->Select(*doc).size() == 1);
+
+    // the same results as a scan
+    auto root = doc->GetRoot()->GetFirstChild("root");
+    TR_ASSERT(t, root->GetChildWithAttributeValue("item", "id", "123") == byId->SelectFirst(*doc)->GetParent());
+
+    // the indexes of a shared document are built once, whichever thread gets there first
+    std::shared_ptr<const xml::Document> shared = xml::XMLParser::Load(data);
+    std::atomic<int> nFailed = 0;
+    std::vector<std::thread> threads;
+    for(int i=0;i<8;i++) {
+        threads.emplace_back([shared, byId, &nFailed]() {
+            for(int n=0;n<100;n++) {
+                auto tag = byId->SelectFirst(*shared);
+                if ((tag == nullptr) || (tag->GetContent() != "123")) {
+                    nFailed++;
+                }
+                if (xml::XMLPath::Compile("//other[@id='5']")->Select(*shared).size() != 1) {
+                    nFailed++;
+                }
+            }
+        });
+    }
+    for(auto &thread : threads) {
+        thread.join();
+    }
+    TR_ASSERT(t, nFailed == 0);
+    return kTR_Pass;
+}
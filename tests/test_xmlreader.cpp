@@ -0,0 +1,103 @@
+//
+// Created by gnilk on 19.10.2026.
+//
+#include <testinterface.h>
+#include <string>
+#include <vector>
+#include "XMLReader.h"
+#include "StringReader.h"
+
+using namespace gnilk;
+using kEvent = xml::XMLReader::kEvent;
+
+extern "C" int test_xmlreader_events(ITesting *t) {
+    static std::string data = "<?xml version=\"1.0\"?><root a=\"1\"><!-- note --><item id=\"x\">text</item><empty/></root>";
+    xml::XMLReader reader(data);
+
+    TR_ASSERT(t, reader.Next() == kEvent::kStartElement);
+    TR_ASSERT(t, reader.GetName() == "root");
+    TR_ASSERT(t, reader.GetAttribute("a") == "1");
+    TR_ASSERT(t, reader.GetDepth() == 1);
+
+    TR_ASSERT(t, reader.Next() == kEvent::kComment);
+    TR_ASSERT(t, reader.GetText() == "note");
+
+    TR_ASSERT(t, reader.Next() == kEvent::kStartElement);
+    TR_ASSERT(t, reader.GetName() == "item");
+    TR_ASSERT(t, reader.HasAttribute("id"));
+    TR_ASSERT(t, reader.GetAttribute("id") == "x");
+    TR_ASSERT(t, reader.GetDepth() == 2);
+
+    TR_ASSERT(t, reader.Next() == kEvent::kText);
+    TR_ASSERT(t, reader.GetName() == "item");
+    TR_ASSERT(t, reader.GetText() == "text");
+
+    TR_ASSERT(t, reader.Next() == kEvent::kEndElement);
+    TR_ASSERT(t, reader.GetName() == "item");
+
+    TR_ASSERT(t, reader.Next() == kEvent::kStartElement);
+    TR_ASSERT(t, reader.GetName() == "empty");
+    TR_ASSERT(t, reader.Next() == kEvent::kEndElement);
+    TR_ASSERT(t, reader.GetName() == "empty");
+
+    TR_ASSERT(t, reader.Next() == kEvent::kEndElement);
+    TR_ASSERT(t, reader.GetName() == "root");
+    TR_ASSERT(t, reader.Next() == kEvent::kEndOfDocument);
+    TR_ASSERT(t, reader.Next() == kEvent::kEndOfDocument);
+    TR_ASSERT(t, reader.GetDepth() == 0);
+    return kTR_Pass;
+}
+
+extern "C" int test_xmlreader_skip(ITesting *t) {
+    static std::string data = "<root><big><a><b>deep</b></a><c/></big><small/><last>end</last></root>";
+    auto stream = StringReader::Create(data);
+    xml::XMLReader reader(stream);
+
+    std::vector<std::string> names;
+    while(reader.Next() != kEvent::kEndOfDocument) {
+        TR_ASSERT(t, reader.GetEvent() != kEvent::kError);
+        if (reader.GetEvent() != kEvent::kStartElement) {
+            continue;
+        }
+        names.emplace_back(reader.GetName());
+        if ((reader.GetName() == "big") || (reader.GetName() == "small")) {
+            TR_ASSERT(t, reader.SkipElement());
+            TR_ASSERT(t, reader.GetEvent() == kEvent::kEndElement);
+            TR_ASSERT(t, reader.GetDepth() == 2);
+        }
+    }
+    TR_ASSERT(t, names.size() == 4);
+    TR_ASSERT(t, names[0] == "root");
+    TR_ASSERT(t, names[1] == "big");
+    TR_ASSERT(t, names[2] == "small");
+    TR_ASSERT(t, names[3] == "last");
+    return kTR_Pass;
+}
+
+extern "C" int test_xmlreader_text(ITesting *t) {
+    static std::string data = "<list><item>one</item><item>two<sub>ignored</sub></item><item/><item>three</item></list>";
+    xml::XMLReader reader(data);
+    TR_ASSERT(t, reader.Next() == kEvent::kStartElement);
+
+    std::vector<std::string> texts;
+    while(reader.Next() == kEvent::kStartElement) {
+        texts.emplace_back(reader.ReadElementText());
+        TR_ASSERT(t, reader.GetEvent() == kEvent::kEndElement);
+        TR_ASSERT(t, reader.GetName() == "item");
+    }
+    TR_ASSERT(t, reader.GetEvent() == kEvent::kEndElement);
+    TR_ASSERT(t, reader.GetName() == "list");
+    TR_ASSERT(t, texts.size() == 4);
+    TR_ASSERT(t, texts[0] == "one");
+    TR_ASSERT(t, texts[1] == "two");
+    TR_ASSERT(t, texts[2].empty());
+    TR_ASSERT(t, texts[3] == "three");
+
+    // errors are sticky
+    static std::string broken = "<a><b";
+    xml::XMLReader brokenReader(broken);
+    while((brokenReader.Next() != kEvent::kError) && (brokenReader.GetEvent() != kEvent::kEndOfDocument)) {
+    }
+    TR_ASSERT(t, brokenReader.GetEvent() == kEvent::kError);
+    return kTR_Pass;
+}
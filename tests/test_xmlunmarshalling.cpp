@@ -6,7 +6,10 @@
 #include "../src/XMLDecoder.h"
 #include "../src/IUnmarshal.h"
 #include "../src/DecoderHelpers.h"
+#include "../src/StringReader.h"
 #include <cmath>
+#include <memory>
+#include <vector>
 
 using namespace gnilk;
 
@@ -49,6 +52,182 @@ namespace {
     };
 }
 
+namespace {
+    // Records every field as 'prefix.name=value', only 'address' is an object
+    class RecordingObject : public IUnmarshal {
+    public:
+        explicit RecordingObject(std::string usePrefix, std::vector<std::string> &useFields) : prefix(std::move(usePrefix)), fields(useFields) {}
+        bool SetField(const std::string &name, const std::string &value) override {
+            fields.push_back(prefix + "." + name + "=" + value);
+            return true;
+        }
+        IUnmarshal *GetUnmarshalForField(const std::string &name) override {
+            if (name != "address") {
+                return nullptr;
+            }
+            children.push_back(std::make_unique<RecordingObject>(prefix + "." + name, fields));
+            return children.back().get();
+        }
+        bool PushToArray(const std::string &name, IUnmarshal *pData) override {
+            return false;
+        }
+    protected:
+        std::string prefix;
+        std::vector<std::string> &fields;
+        std::vector<std::unique_ptr<RecordingObject>> children;
+    };
+}
+
+extern "C" int test_xmlunmarshal_stream(ITesting *t) {
+    static std::string xml = "<?xml version=\"1.0\"?><person id=\"7\"><name>Ann</name><empty></empty>"
+                             "<address city=\"Lund\"><street>Main 1</street><zip>222 22</zip></address>"
+                             "<notes><note>ignored</note></notes><tagged kind=\"x\">ignored</tagged><age>42</age></person>";
+    std::vector<std::string> expected;
+    RecordingObject fromDoc("", expected);
+    XMLDecoder decoder(xml);
+    TR_ASSERT(t, decoder.Unmarshal(&fromDoc));
+
+    std::vector<std::string> streamed;
+    RecordingObject fromStream("", streamed);
+    XMLDecoder streamDecoder;
+    streamDecoder.BeginStream(StringReader::Create(xml));
+    TR_ASSERT(t, streamDecoder.Unmarshal(&fromStream));
+
+    // the document also reports the xml declaration attributes
+    std::erase(expected, std::string(".version=1.0"));
+    TR_ASSERT(t, streamed == expected);
+    TR_ASSERT(t, streamed.size() == 7);
+    TR_ASSERT(t, streamed[0] == ".id=7");
+    TR_ASSERT(t, streamed[1] == ".name=Ann");
+    TR_ASSERT(t, streamed[2] == ".empty=");
+    TR_ASSERT(t, streamed[3] == ".address.city=Lund");
+    TR_ASSERT(t, streamed[4] == ".address.street=Main 1");
+    TR_ASSERT(t, streamed[6] == ".age=42");
+
+    // broken input fails
+    static std::string broken = "<person><name>Ann</name";
+    XMLDecoder brokenDecoder;
+    brokenDecoder.BeginStream(StringReader::Create(broken));
+    std::vector<std::string> ignored;
+    RecordingObject brokenObject("", ignored);
+    TR_ASSERT(t, !brokenDecoder.Unmarshal(&brokenObject));
+    return kTR_Pass;
+}
+
+namespace {
+    class Item : public BaseUnmarshal {
+    public:
+        bool SetField(const std::string &name, const std::string &value) override {
+            if (name == "id") id = *convert_to<int>(value);
+            else if (name == "label") label = value;
+            else return false;
+            return true;
+        }
+    public:
+        int id = -1;
+        std::string label;
+    };
+
+    // '<items>' with repeated '<item>' objects and '<tag>' leafs
+    class ItemList : public BaseUnmarshal {
+    public:
+        bool SetField(const std::string &name, const std::string &value) override {
+            if (name != "tag") return false;
+            tags.push_back(value);
+            return true;
+        }
+        IUnmarshal *GetUnmarshalForField(const std::string &name) override {
+            if (name != "item") return nullptr;
+            pending = std::make_unique<Item>();
+            return pending.get();
+        }
+        bool PushToArray(const std::string &name, IUnmarshal *pData) override {
+            nPushed++;
+            if ((name != "item") || (pData != pending.get())) return false;
+            items.push_back(std::move(*pending));
+            return true;
+        }
+        bool ReserveArray(const std::string &name, size_t count) override {
+            nReserveCalls++;
+            if ((name != "item") || !wantsList) {
+                return false;
+            }
+            items.reserve(count);
+            nReserved = count;
+            return true;
+        }
+    public:
+        bool wantsList = true;
+        std::unique_ptr<Item> pending;
+        std::vector<Item> items;
+        std::vector<std::string> tags;
+        size_t nReserved = 0;
+        size_t nReserveCalls = 0;
+        size_t nPushed = 0;
+    };
+}
+
+extern "C" int test_xmlunmarshal_list(ITesting *t) {
+    // the items don't have to be next to each other, all children with the name count
+    static std::string xml = "<items><item id=\"1\"><label>one</label></item><item id=\"2\"/><tag>a</tag>"
+                             "<item id=\"3\"><label>three</label></item><tag>b</tag></items>";
+    ItemList fromDoc;
+    XMLDecoder decoder(xml);
+    TR_ASSERT(t, decoder.Unmarshal(&fromDoc));
+    // once per name - 'item' and 'tag'
+    TR_ASSERT(t, fromDoc.nReserveCalls == 2);
+    TR_ASSERT(t, fromDoc.nReserved == 3);
+    TR_ASSERT(t, fromDoc.items.size() == 3);
+    TR_ASSERT(t, fromDoc.items[0].id == 1);
+    TR_ASSERT(t, fromDoc.items[0].label == "one");
+    TR_ASSERT(t, fromDoc.items[1].id == 2);
+    TR_ASSERT(t, fromDoc.items[1].label.empty());
+    TR_ASSERT(t, fromDoc.items[2].label == "three");
+    TR_ASSERT(t, fromDoc.tags.size() == 2);
+    TR_ASSERT(t, fromDoc.tags[1] == "b");
+
+    // streaming can't count the items up front but gives the same list
+    ItemList fromStream;
+    XMLDecoder streamDecoder;
+    streamDecoder.BeginStream(StringReader::Create(xml));
+    TR_ASSERT(t, streamDecoder.Unmarshal(&fromStream));
+    TR_ASSERT(t, fromStream.nReserveCalls == 2);
+    TR_ASSERT(t, fromStream.nReserved == 0);
+    TR_ASSERT(t, fromStream.items.size() == 3);
+    TR_ASSERT(t, fromStream.items[2].id == 3);
+    TR_ASSERT(t, fromStream.items[2].label == "three");
+    TR_ASSERT(t, fromStream.tags == fromDoc.tags);
+
+    // a single item is a list too, if the consumer says so
+    static std::string single = "<items><item id=\"7\"/></items>";
+    ItemList fromSingle;
+    XMLDecoder singleDecoder(single);
+    TR_ASSERT(t, singleDecoder.Unmarshal(&fromSingle));
+    TR_ASSERT(t, fromSingle.nReserved == 1);
+    TR_ASSERT(t, fromSingle.items.size() == 1);
+    TR_ASSERT(t, fromSingle.items[0].id == 7);
+
+    // consumers not asking for a list never see 'PushToArray'
+    for(bool stream : {false, true}) {
+        ItemList noList;
+        noList.wantsList = false;
+        XMLDecoder noListDecoder;
+        if (stream) {
+            noListDecoder.BeginStream(StringReader::Create(xml));
+        } else {
+            noListDecoder.Begin(xml);
+        }
+        TR_ASSERT(t, noListDecoder.Unmarshal(&noList));
+        TR_ASSERT(t, noList.nPushed == 0);
+        TR_ASSERT(t, noList.items.empty());
+        // the last one decoded is still there
+        TR_ASSERT(t, noList.pending != nullptr);
+        TR_ASSERT(t, noList.pending->id == 3);
+        TR_ASSERT(t, noList.tags.size() == 2);
+    }
+    return kTR_Pass;
+}
+
 extern "C" int test_xmlunmarshal_simple(ITesting *t) {
     return kTR_Pass;
 }
@@ -0,0 +1,126 @@
+//
+// Created by gnilk on 19.10.2026.
+//
+// Builds and uses sidecar indexes for large JSON arrays and JSON Lines files
+//
+//   jsonindex build [--layout auto|array|lines] <file> [stride]  - writes <file>.idx
+//   jsonindex get [--verify] [--layout auto|array|lines] <file> <first> [count]
+//                                                               - prints elements, the index is built when missing or stale
+//
+// Staleness is checked on the size and a few sampled blocks of the file, --verify hashes all of it.
+// The layout is detected unless given, JSON Lines files with array records need '--layout lines'.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+#include "JSONIndex.h"
+#include "MMapReader.h"
+
+using namespace gnilk;
+
+static int Usage() {
+    fprintf(stderr, "usage:\n");
+    fprintf(stderr, "  jsonindex build [--layout auto|array|lines] <file> [stride]\n");
+    fprintf(stderr, "  jsonindex get [--verify] [--layout auto|array|lines] <file> <first> [count]\n");
+    return 1;
+}
+
+static bool ParseLayout(const std::string &name, JSONIndex::kLayout &outLayout) {
+    if (name == "auto") {
+        outLayout = JSONIndex::kLayout::kAuto;
+    } else if (name == "array") {
+        outLayout = JSONIndex::kLayout::kArray;
+    } else if (name == "lines") {
+        outLayout = JSONIndex::kLayout::kLines;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+static int Build(const std::string &filename, size_t stride, JSONIndex::kLayout layout) {
+    auto reader = MMapReader::Create(filename);
+    if (reader == nullptr) {
+        fprintf(stderr, "ERR: unable to open '%s'\n", filename.c_str());
+        return 1;
+    }
+    auto index = JSONIndex::Build(reader->GetData(), stride, layout);
+    if (index == nullptr) {
+        fprintf(stderr, "ERR: '%s' is not a complete JSON array\n", filename.c_str());
+        return 1;
+    }
+    auto indexName = JSONIndex::SidecarName(filename);
+    if (!index->Save(indexName)) {
+        fprintf(stderr, "ERR: unable to write '%s'\n", indexName.c_str());
+        return 1;
+    }
+    printf("%s: %zu elements (%s), stride %zu\n", indexName.c_str(), index->Size(),
+           (index->GetLayout() == JSONIndex::kLayout::kArray) ? "array" : "lines", index->GetStride());
+    return 0;
+}
+
+static int Get(const std::string &filename, size_t first, size_t count, JSONIndex::kLayout layout, bool verify) {
+    auto reader = MMapReader::Create(filename);
+    if (reader == nullptr) {
+        fprintf(stderr, "ERR: unable to open '%s'\n", filename.c_str());
+        return 1;
+    }
+    auto indexName = JSONIndex::SidecarName(filename);
+    auto index = JSONIndex::Load(indexName);
+    if ((index != nullptr) && (layout != JSONIndex::kLayout::kAuto) && (index->GetLayout() != layout)) {
+        index = nullptr;
+    }
+    bool valid = (index != nullptr) && (verify ? index->Verify(reader->GetData()) : index->IsValidFor(reader->GetData()));
+    if (!valid) {
+        // a stale index is rebuilt with its stride and layout
+        size_t stride = JSONIndex::kDefaultStride;
+        if (index != nullptr) {
+            stride = index->GetStride();
+            layout = index->GetLayout();
+        }
+        index = JSONIndex::Build(reader->GetData(), stride, layout);
+        if ((index == nullptr) || !index->Save(indexName)) {
+            fprintf(stderr, "ERR: unable to index '%s'\n", filename.c_str());
+            return 1;
+        }
+    }
+    for(size_t i=first;(i < first + count) && (i < index->Size());i++) {
+        auto element = index->Element(reader->GetData(), i);
+        printf("%.*s\n", static_cast<int>(element.size()), element.data());
+    }
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        return Usage();
+    }
+    std::string cmd = argv[1];
+    auto layout = JSONIndex::kLayout::kAuto;
+    bool verify = false;
+    std::vector<std::string> args;
+    for(int i=2;i<argc;i++) {
+        std::string arg = argv[i];
+        if (arg == "--verify") {
+            verify = true;
+        } else if (arg == "--layout") {
+            if ((++i >= argc) || !ParseLayout(argv[i], layout)) {
+                return Usage();
+            }
+        } else {
+            args.push_back(arg);
+        }
+    }
+    if ((cmd == "build") && !args.empty()) {
+        auto stride = (args.size() > 1) ? strtoull(args[1].c_str(), nullptr, 10) : JSONIndex::kDefaultStride;
+        return Build(args[0], stride, layout);
+    }
+    if ((cmd == "get") && (args.size() > 1)) {
+        auto first = strtoull(args[1].c_str(), nullptr, 10);
+        auto count = (args.size() > 2) ? strtoull(args[2].c_str(), nullptr, 10) : 1;
+        return Get(args[0], first, count, layout, verify);
+    }
+    return Usage();
+}